@@ -38,17 +38,59 @@ namespace kson
 
 	using AudioEffectDefKVP = DefKeyValuePair<AudioEffectDef>;
 
+	// Hash map from the name to the position in a definition list without copying the definitions
+	// Note: The list must outlive this. Call sync() after appending definitions to the list, and rebuild() after renaming or removing them.
+	//       If the same name is defined more than once, the first one is found as in defByName.
+	class AudioEffectDefIndex
+	{
+	private:
+		struct NameHash
+		{
+			using is_transparent = void;
+
+			std::size_t operator()(std::string_view name) const
+			{
+				return std::hash<std::string_view>{}(name);
+			}
+		};
+
+		const std::vector<AudioEffectDefKVP>* m_pDef;
+		std::unordered_map<std::string, std::size_t, NameHash, std::equal_to<>> m_indices;
+		std::size_t m_numIndexed = 0;
+
+	public:
+		static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+		explicit AudioEffectDefIndex(const std::vector<AudioEffectDefKVP>& def);
+
+		// Indexes the definitions appended to the list since the last call (or all of them if the list has shrunk)
+		void sync();
+
+		void rebuild();
+
+		// Returns npos if not found
+		[[nodiscard]]
+		std::size_t indexOf(std::string_view name) const;
+
+		[[nodiscard]]
+		bool contains(std::string_view name) const;
+
+		// Returns nullptr if not found
+		[[nodiscard]]
+		const AudioEffectDef* find(std::string_view name) const;
+	};
+
 	struct AudioEffectFXInfo
 	{
 		std::vector<AudioEffectDefKVP> def;
 		Dict<Dict<ByPulse<std::string>>> paramChange;
 		Dict<FXLane<AudioEffectParams>> longEvent;
 
-		// Note: This is inefficient, so be careful when using it
+		// Note: This is inefficient, so use AudioEffectDefIndex if this is called frequently
 		[[nodiscard]]
 		bool defContains(std::string_view name) const;
 
-		// Note: This is inefficient, so be careful when using it
+		// Note: This is inefficient, so use AudioEffectDefIndex if this is called frequently
 		[[nodiscard]]
 		const AudioEffectDef& defByName(std::string_view name) const;
 
@@ -65,16 +107,16 @@ namespace kson
 	{
 		std::vector<AudioEffectDefKVP> def;
 		Dict<Dict<ByPulse<std::string>>> paramChange;
-		Dict<std::set<Pulse>> pulseEvent;
+		Dict<PulseSet> pulseEvent;
 		std::int32_t peakingFilterDelay = 0; // 0ms - 160ms
 		AudioEffectLaserLegacyInfo legacy;
 
-		// Note: If you call this function frequently, it's recommended to first call defAsDict to get the dictionary and use it,
+		// Note: If you call this function frequently, it's recommended to use AudioEffectDefIndex,
 		//       as this function uses linear search.
 		[[nodiscard]]
 		bool defContains(std::string_view name) const;
 
-		// Note: If you call this function frequently, it's recommended to first call defAsDict to get the dictionary and use it,
+		// Note: If you call this function frequently, it's recommended to use AudioEffectDefIndex,
 		//       as this function uses linear search.
 		[[nodiscard]]
 		const AudioEffectDef& defByName(std::string_view name) const;
@@ -0,0 +1,134 @@
+#pragma once
+#include "kson/Common/Common.hpp"
+#include "kson/Common/FlatMap.hpp"
+#include "kson/Audio/InternedAudioEffect.hpp"
+
+namespace kson
+{
+	// Audio effect parameter keys ("attack_time", "bandwidth", ...)
+	enum class AudioEffectParamID : std::uint8_t
+	{
+		AttackTime,
+		Bandwidth,
+		ChunkSize,
+		Delay,
+		Depth,
+		Feedback,
+		FeedbackLevel,
+		Filename,
+		Freq,
+		Freq1,
+		Freq2,
+		FreqMax,
+		Gain,
+		HiCutGain,
+		HoldTime,
+		Mix,
+		Overlap,
+		Period,
+		Pitch,
+		Q,
+		Rate,
+		Ratio,
+		Reduction,
+		ReleaseTime,
+		Speed,
+		Stage,
+		StereoWidth,
+		Trigger,
+		UpdatePeriod,
+		UpdateTrigger,
+		V,
+		Vol,
+		WaveLength,
+
+		Unspecified, // Must be the last
+	};
+
+	constexpr std::size_t kNumAudioEffectParamIDs = static_cast<std::size_t>(AudioEffectParamID::Unspecified);
+
+	[[nodiscard]]
+	AudioEffectParamID StrToAudioEffectParamID(std::string_view str);
+
+	[[nodiscard]]
+	std::string_view AudioEffectParamIDToStr(AudioEffectParamID id);
+
+	// Evaluated parameter values indexed by AudioEffectParamID (the unit is kInvalid if not specified)
+	using AudioEffectParamScalars = std::array<AudioEffectParamScalar, kNumAudioEffectParamIDs>;
+
+	// Parameter values indexed by AudioEffectParamID
+	struct CompiledAudioEffectParams
+	{
+		std::array<AudioEffectParamValue, kNumAudioEffectParamIDs> v;
+		std::array<AudioEffectSymbol, kNumAudioEffectParamIDs> raw; // Original value strings (kInvalidAudioEffectSymbol if not specified)
+
+		CompiledAudioEffectParams()
+		{
+			raw.fill(kInvalidAudioEffectSymbol);
+		}
+
+		[[nodiscard]]
+		bool contains(AudioEffectParamID id) const
+		{
+			return raw[static_cast<std::size_t>(id)] != kInvalidAudioEffectSymbol;
+		}
+	};
+
+	// Note: Parameters with unknown keys are ignored
+	[[nodiscard]]
+	CompiledAudioEffectParams CompileAudioEffectParams(const InternedAudioEffectParams& params, const AudioEffectSymbolTable& symbols);
+
+	struct CompiledAudioEffect
+	{
+		AudioEffectSymbol name = kInvalidAudioEffectSymbol;
+		AudioEffectType type = AudioEffectType::Unspecified;
+		CompiledAudioEffectParams params;
+		std::array<FlatByPulse<AudioEffectParamValue>, kNumAudioEffectParamIDs> paramChange;
+
+		// Returns the parameter value at the pulse with param_change applied
+		// Note: The overrides (e.g., the parameters of an FX long note) take priority over param_change
+		[[nodiscard]]
+		AudioEffectParamValue valueAt(AudioEffectParamID id, Pulse pulse, const CompiledAudioEffectParams* pOverrides = nullptr) const;
+
+		// Evaluates all parameters at the pulse without memory allocation
+		// Note: laserValue (0.0-1.0) selects the value between onMin and onMax. The off values are used if isOn is false.
+		[[nodiscard]]
+		AudioEffectParamScalars evaluate(Pulse pulse, double laserValue, bool isOn = true, const CompiledAudioEffectParams* pOverrides = nullptr) const;
+	};
+
+	struct CompiledAudioEffectInvocation
+	{
+		AudioEffectSymbol name = kInvalidAudioEffectSymbol;
+		CompiledAudioEffectParams v;
+	};
+
+	struct CompiledAudioEffectFXInfo
+	{
+		std::vector<CompiledAudioEffect> effects; // Sorted by name, including preset effects used without definition
+		FXLane<std::vector<CompiledAudioEffectInvocation>> longEvent; // Same order as InternedAudioEffectFXInfo::longEvent
+
+		// Returns nullptr if not found
+		[[nodiscard]]
+		const CompiledAudioEffect* find(AudioEffectSymbol name) const;
+	};
+
+	struct CompiledAudioEffectLaserInfo
+	{
+		std::vector<CompiledAudioEffect> effects; // Sorted by name, including preset effects used without definition
+
+		// Returns nullptr if not found
+		[[nodiscard]]
+		const CompiledAudioEffect* find(AudioEffectSymbol name) const;
+	};
+
+	// Audio effects with the parameters parsed into fixed arrays, so that they can be evaluated on the audio thread
+	// Note: The symbols are the ones of the InternedAudioEffectInfo used to create this.
+	struct CompiledAudioEffectInfo
+	{
+		CompiledAudioEffectFXInfo fx;
+		CompiledAudioEffectLaserInfo laser;
+	};
+
+	[[nodiscard]]
+	CompiledAudioEffectInfo CompileAudioEffectInfo(const InternedAudioEffectInfo& interned);
+}
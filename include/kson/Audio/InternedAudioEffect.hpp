@@ -0,0 +1,143 @@
+#pragma once
+#include <limits>
+#include "kson/Common/Common.hpp"
+#include "kson/Audio/AudioEffect.hpp"
+
+namespace kson
+{
+	// ID of an interned audio effect name, parameter key, or parameter value string
+	using AudioEffectSymbol = std::uint32_t;
+
+	constexpr AudioEffectSymbol kInvalidAudioEffectSymbol = std::numeric_limits<AudioEffectSymbol>::max();
+
+	// Assigns a sequential ID to each distinct string
+	class AudioEffectSymbolTable
+	{
+	private:
+		std::map<std::string, AudioEffectSymbol, std::less<>> m_symbols;
+		std::vector<std::string> m_strings;
+
+	public:
+		AudioEffectSymbol intern(std::string_view str);
+
+		// Returns kInvalidAudioEffectSymbol if the string has not been interned
+		[[nodiscard]]
+		AudioEffectSymbol find(std::string_view str) const;
+
+		[[nodiscard]]
+		const std::string& str(AudioEffectSymbol symbol) const;
+
+		[[nodiscard]]
+		std::size_t size() const;
+	};
+
+	enum class AudioEffectParamUnit : std::uint8_t
+	{
+		kInvalid, // Not a numeric value (e.g., a file name)
+		kNumber, // "0.5", "-12"
+		kFraction, // "1/8" (0.125, tempo-synced length relative to a whole note)
+		kRate, // "50%" (0.5)
+		kSec, // "100ms" (0.1), "2s" (2.0)
+		kSamples, // "500samples" (500.0)
+		kHz, // "200Hz" (200.0), "10kHz" (10000.0)
+		kDecibel, // "6dB" (6.0)
+		kSwitch, // "on" (1.0), "off" (0.0)
+	};
+
+	struct AudioEffectParamScalar
+	{
+		AudioEffectParamUnit unit = AudioEffectParamUnit::kInvalid;
+		double v = 0.0;
+	};
+
+	// Parameter value string parsed in the form of "off>onMin-onMax"
+	// Note: "a" is parsed as off = onMin = onMax = a, "a>b" as off = a and onMin = onMax = b, and "a-b" as off = onMin = a and onMax = b.
+	//       onMin and onMax are the values at the laser value 0.0 and 1.0 while the effect is on.
+	struct AudioEffectParamValue
+	{
+		AudioEffectParamScalar off;
+		AudioEffectParamScalar onMin;
+		AudioEffectParamScalar onMax;
+
+		[[nodiscard]]
+		bool isValid() const;
+
+		// Returns the value at the laser value (0.0-1.0), or the off value if isOn is false
+		// Note: Values are interpolated linearly only if onMin and onMax have the same unit
+		[[nodiscard]]
+		AudioEffectParamScalar evaluate(double laserValue, bool isOn = true) const;
+	};
+
+	[[nodiscard]]
+	AudioEffectParamValue ParseAudioEffectParamValue(std::string_view str);
+
+	struct InternedAudioEffectParam
+	{
+		AudioEffectSymbol key = kInvalidAudioEffectSymbol;
+		AudioEffectSymbol raw = kInvalidAudioEffectSymbol; // Original value string (e.g., the file name of "switch_audio")
+		AudioEffectParamValue value;
+	};
+
+	// Sorted by key
+	using InternedAudioEffectParams = std::vector<InternedAudioEffectParam>;
+
+	// Returns nullptr if not found
+	[[nodiscard]]
+	const InternedAudioEffectParam* FindInternedAudioEffectParam(const InternedAudioEffectParams& params, AudioEffectSymbol key);
+
+	struct InternedAudioEffectDef
+	{
+		AudioEffectSymbol name = kInvalidAudioEffectSymbol;
+		AudioEffectType type = AudioEffectType::Unspecified;
+		InternedAudioEffectParams v;
+	};
+
+	struct InternedAudioEffectParamChange
+	{
+		AudioEffectSymbol name = kInvalidAudioEffectSymbol;
+		AudioEffectSymbol key = kInvalidAudioEffectSymbol;
+		ByPulse<InternedAudioEffectParam> v;
+	};
+
+	struct InternedAudioEffectInvocation
+	{
+		AudioEffectSymbol name = kInvalidAudioEffectSymbol;
+		InternedAudioEffectParams v;
+	};
+
+	struct InternedAudioEffectFXInfo
+	{
+		std::vector<InternedAudioEffectDef> def; // Sorted by name
+		std::vector<InternedAudioEffectParamChange> paramChange; // Sorted by name and key
+		FXLane<std::vector<InternedAudioEffectInvocation>> longEvent; // Sorted by name at each pulse
+
+		// Returns nullptr if not found
+		// Note: Effects used without definition (e.g., "retrigger") can be resolved with StrToAudioEffectType
+		[[nodiscard]]
+		const InternedAudioEffectDef* findDef(AudioEffectSymbol name) const;
+	};
+
+	struct InternedAudioEffectLaserInfo
+	{
+		std::vector<InternedAudioEffectDef> def; // Sorted by name
+		std::vector<InternedAudioEffectParamChange> paramChange; // Sorted by name and key
+		ByPulse<std::vector<AudioEffectSymbol>> pulseEvent; // Effect names switched to at each pulse, sorted by name
+
+		// Returns nullptr if not found
+		[[nodiscard]]
+		const InternedAudioEffectDef* findDef(AudioEffectSymbol name) const;
+	};
+
+	// Copy of AudioEffectInfo with interned strings and pre-parsed parameter values
+	// Note: This is intended to be created once after loading so that the effects can be dispatched
+	//       without string comparison and parsing during playback. It is not updated along with the original.
+	struct InternedAudioEffectInfo
+	{
+		AudioEffectSymbolTable symbols;
+		InternedAudioEffectFXInfo fx;
+		InternedAudioEffectLaserInfo laser;
+	};
+
+	[[nodiscard]]
+	InternedAudioEffectInfo CreateInternedAudioEffectInfo(const AudioEffectInfo& audioEffect);
+}
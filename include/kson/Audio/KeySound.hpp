@@ -18,7 +18,7 @@ namespace kson
 	};
 
 	// Dictionary key: slam_up/slam_down/slam_swing/slam_mute
-	using KeySoundInvokeListLaser = Dict<std::set<Pulse>>;
+	using KeySoundInvokeListLaser = Dict<PulseSet>;
 
 	struct KeySoundLaserLegacyInfo
 	{
@@ -0,0 +1,65 @@
+#pragma once
+#include <memory_resource>
+
+namespace kson
+{
+#ifdef KSON_USE_CHART_ALLOCATOR
+	constexpr bool kUseChartAllocator = true;
+#else
+	constexpr bool kUseChartAllocator = false;
+#endif
+
+	// Returns the memory resource used by the chart containers created on the current thread
+	// Note: This is std::pmr::new_delete_resource() unless ScopedChartMemoryResource is alive on the current thread
+	[[nodiscard]]
+	std::pmr::memory_resource* CurrentChartMemoryResource();
+
+	// Makes the chart containers created on the current thread allocate from the resource while alive
+	// Note: This has effect only if KSON_USE_CHART_ALLOCATOR is defined (see kUseChartAllocator).
+	//       The resource must outlive the ChartData built in the scope. Copying a ChartData after the scope
+	//       is ended creates a copy that does not depend on the resource.
+	class ScopedChartMemoryResource
+	{
+	private:
+		std::pmr::memory_resource* m_prevResource;
+
+	public:
+		explicit ScopedChartMemoryResource(std::pmr::memory_resource* resource);
+
+		~ScopedChartMemoryResource();
+
+		ScopedChartMemoryResource(const ScopedChartMemoryResource&) = delete;
+
+		ScopedChartMemoryResource& operator=(const ScopedChartMemoryResource&) = delete;
+	};
+
+	// Polymorphic allocator whose default resource is CurrentChartMemoryResource() instead of the process-wide default
+	template <typename T>
+	class ChartAllocator : public std::pmr::polymorphic_allocator<T>
+	{
+	public:
+		ChartAllocator() noexcept
+			: std::pmr::polymorphic_allocator<T>(CurrentChartMemoryResource())
+		{
+		}
+
+		/*implicit*/ ChartAllocator(std::pmr::memory_resource* resource) noexcept
+			: std::pmr::polymorphic_allocator<T>(resource)
+		{
+		}
+
+		// Note: This is also used for the nested containers constructed by the uses-allocator construction
+		template <typename U>
+		/*implicit*/ ChartAllocator(const std::pmr::polymorphic_allocator<U>& other) noexcept
+			: std::pmr::polymorphic_allocator<T>(other.resource())
+		{
+		}
+
+		// Copies of a container are allocated from the resource of the current thread, not from the resource of the source
+		[[nodiscard]]
+		ChartAllocator select_on_container_copy_construction() const
+		{
+			return ChartAllocator();
+		}
+	};
+}
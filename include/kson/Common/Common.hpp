@@ -11,6 +11,7 @@
 #include <cassert>
 #include <cmath>
 #include <cstdint>
+#include "kson/Common/ChartMemoryResource.hpp"
 #include "kson/Encoding/Encoding.hpp"
 
 namespace kson
@@ -35,8 +36,30 @@ namespace kson
 	// The difference between Pulse and RelPulse is only for annotation
 	static_assert(std::is_same_v<Pulse, RelPulse>);
 
+	// Ordered containers used in the chart data
+	// Note: If KSON_USE_CHART_ALLOCATOR is defined, they allocate from CurrentChartMemoryResource() (see ScopedChartMemoryResource)
+#ifdef KSON_USE_CHART_ALLOCATOR
+	template <typename K, typename V>
+	using ChartMap = std::map<K, V, std::less<K>, ChartAllocator<std::pair<const K, V>>>;
+
+	template <typename K, typename V>
+	using ChartMultiMap = std::multimap<K, V, std::less<K>, ChartAllocator<std::pair<const K, V>>>;
+
+	template <typename T>
+	using ChartSet = std::set<T, std::less<T>, ChartAllocator<T>>;
+#else
+	template <typename K, typename V>
+	using ChartMap = std::map<K, V>;
+
+	template <typename K, typename V>
+	using ChartMultiMap = std::multimap<K, V>;
+
+	template <typename T>
+	using ChartSet = std::set<T>;
+#endif
+
 	template <typename T>
-	using ByPulse = std::map<Pulse, T>;
+	using ByPulse = ChartMap<Pulse, T>;
 
 	template <typename T>
 	using BTLane = std::array<ByPulse<T>, kNumBTLanesSZ>;
@@ -48,16 +71,18 @@ namespace kson
 	using LaserLane = std::array<ByPulse<T>, kNumLaserLanesSZ>;
 
 	template <typename T>
-	using ByPulseMulti = std::multimap<Pulse, T>;
+	using ByPulseMulti = ChartMultiMap<Pulse, T>;
 
 	template <typename T>
-	using ByRelPulse = std::map<RelPulse, T>;
+	using ByRelPulse = ChartMap<RelPulse, T>;
 
 	template <typename T>
-	using ByRelPulseMulti = std::multimap<RelPulse, T>;
+	using ByRelPulseMulti = ChartMultiMap<RelPulse, T>;
 
 	template <typename T>
-	using ByMeasureIdx = std::map<std::int64_t, T>;
+	using ByMeasureIdx = ChartMap<std::int64_t, T>;
+
+	using PulseSet = ChartSet<Pulse>;
 
 	template <typename T>
 	struct DefKeyValuePair
@@ -147,10 +172,10 @@ namespace kson
 
 	// Use std::map instead of std::unordered_map to ensure stable output order in saving
 	template <typename T>
-	using Dict = std::map<std::string, T>;
+	using Dict = ChartMap<std::string, T>;
 
-	template <typename T, typename U>
-	auto ValueItrAt(const std::map<T, U>& map, T key)
+	template <typename T, typename U, typename Compare, typename Alloc>
+	auto ValueItrAt(const std::map<T, U, Compare, Alloc>& map, T key)
 	{
 		auto itr = map.upper_bound(key);
 		if (itr != map.begin())
@@ -160,9 +185,9 @@ namespace kson
 		return itr;
 	}
 
-	template <typename T, typename U>
+	template <typename T, typename U, typename Compare, typename Alloc>
 	[[nodiscard]]
-	U ValueAtOrDefault(const std::map<T, U>& map, T key, const U& defaultValue)
+	U ValueAtOrDefault(const std::map<T, U, Compare, Alloc>& map, T key, const U& defaultValue)
 	{
 		const auto itr = ValueItrAt(map, key);
 		if (itr == map.end() || key < itr->first)
@@ -0,0 +1,222 @@
+#pragma once
+#include "kson/Common/Common.hpp"
+
+namespace kson
+{
+	// Sorted vector with a read-only std::map-like interface
+	// Note: This is intended for chart data that is immutable after loading (see FrozenChartData).
+	//       Elements are stored contiguously, so lookups are binary searches without pointer chasing.
+	template <typename K, typename V>
+	class FlatMap
+	{
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using value_type = std::pair<K, V>;
+		using container_type = std::vector<value_type>;
+		using const_iterator = typename container_type::const_iterator;
+		using iterator = const_iterator;
+		using const_reverse_iterator = typename container_type::const_reverse_iterator;
+		using reverse_iterator = const_reverse_iterator;
+		using size_type = std::size_t;
+
+	private:
+		container_type m_data;
+
+	public:
+		FlatMap() = default;
+
+		template <typename Compare, typename Alloc>
+		explicit FlatMap(const std::map<K, V, Compare, Alloc>& map)
+			: m_data(map.begin(), map.end())
+		{
+		}
+
+		// Converts each value of the map with V's constructor (e.g., LaserSection to FlatLaserSection)
+		template <typename U, typename Compare, typename Alloc>
+#ifdef __cpp_concepts
+			requires (!std::is_same_v<U, V>) && std::is_constructible_v<V, const U&>
+#endif
+		explicit FlatMap(const std::map<K, U, Compare, Alloc>& map)
+		{
+			m_data.reserve(map.size());
+			for (const auto& [key, value] : map)
+			{
+				m_data.emplace_back(key, V(value));
+			}
+		}
+
+		[[nodiscard]]
+		const_iterator begin() const
+		{
+			return m_data.cbegin();
+		}
+
+		[[nodiscard]]
+		const_iterator end() const
+		{
+			return m_data.cend();
+		}
+
+		[[nodiscard]]
+		const_iterator cbegin() const
+		{
+			return m_data.cbegin();
+		}
+
+		[[nodiscard]]
+		const_iterator cend() const
+		{
+			return m_data.cend();
+		}
+
+		[[nodiscard]]
+		const_reverse_iterator rbegin() const
+		{
+			return m_data.crbegin();
+		}
+
+		[[nodiscard]]
+		const_reverse_iterator rend() const
+		{
+			return m_data.crend();
+		}
+
+		[[nodiscard]]
+		std::size_t size() const
+		{
+			return m_data.size();
+		}
+
+		[[nodiscard]]
+		bool empty() const
+		{
+			return m_data.empty();
+		}
+
+		[[nodiscard]]
+		const_iterator lower_bound(const K& key) const
+		{
+			return std::lower_bound(m_data.begin(), m_data.end(), key, [](const value_type& element, const K& k) { return element.first < k; });
+		}
+
+		[[nodiscard]]
+		const_iterator upper_bound(const K& key) const
+		{
+			return std::upper_bound(m_data.begin(), m_data.end(), key, [](const K& k, const value_type& element) { return k < element.first; });
+		}
+
+		[[nodiscard]]
+		const_iterator find(const K& key) const
+		{
+			const auto itr = lower_bound(key);
+			if (itr != m_data.end() && itr->first == key)
+			{
+				return itr;
+			}
+			return m_data.end();
+		}
+
+		[[nodiscard]]
+		bool contains(const K& key) const
+		{
+			return find(key) != m_data.end();
+		}
+
+		[[nodiscard]]
+		std::size_t count(const K& key) const
+		{
+			return contains(key) ? std::size_t{ 1 } : std::size_t{ 0 };
+		}
+
+		[[nodiscard]]
+		const V& at(const K& key) const
+		{
+			const auto itr = find(key);
+			if (itr == m_data.end())
+			{
+				throw std::out_of_range("FlatMap::at: key not found");
+			}
+			return itr->second;
+		}
+	};
+
+	template <typename T>
+	using FlatByPulse = FlatMap<Pulse, T>;
+
+	template <typename T>
+	using FlatBTLane = std::array<FlatByPulse<T>, kNumBTLanesSZ>;
+
+	template <typename T>
+	using FlatFXLane = std::array<FlatByPulse<T>, kNumFXLanesSZ>;
+
+	template <typename T>
+	using FlatLaserLane = std::array<FlatByPulse<T>, kNumLaserLanesSZ>;
+
+	template <typename T>
+	using FlatByMeasureIdx = FlatMap<std::int64_t, T>;
+
+	using FlatGraph = FlatByPulse<GraphPoint>;
+
+	// Query helpers with the same behavior as the std::map versions in Common.hpp
+
+	template <typename T, typename U>
+	auto ValueItrAt(const FlatMap<T, U>& map, T key)
+	{
+		auto itr = map.upper_bound(key);
+		if (itr != map.begin())
+		{
+			--itr;
+		}
+		return itr;
+	}
+
+	template <typename T, typename U>
+	[[nodiscard]]
+	U ValueAtOrDefault(const FlatMap<T, U>& map, T key, const U& defaultValue)
+	{
+		const auto itr = ValueItrAt(map, key);
+		if (itr == map.end() || key < itr->first)
+		{
+			return defaultValue;
+		}
+		return itr->second;
+	}
+
+	template <typename T>
+	[[nodiscard]]
+	std::size_t CountInRange(const FlatByPulse<T>& map, Pulse start, Pulse end)
+	{
+		assert(start <= end);
+
+		const auto itr1 = map.lower_bound(start);
+		const auto itr2 = map.lower_bound(end);
+		return static_cast<std::size_t>(itr2 - itr1);
+	}
+
+	template <typename T>
+	[[nodiscard]]
+	auto FirstInRange(const FlatByPulse<T>& map, Pulse start, Pulse end)
+	{
+		assert(start <= end);
+
+		const auto itr = map.lower_bound(start);
+		if (itr == map.end() || itr->first >= end)
+		{
+			return map.end();
+		}
+		return itr;
+	}
+
+	template <typename T>
+	[[nodiscard]]
+	auto IntervalAt(const FlatByPulse<T>& map, Pulse pulse)
+	{
+		const auto itr = ValueItrAt(map, pulse);
+		if (itr != map.end() && itr->first <= pulse && pulse < itr->first + itr->second.length)
+		{
+			return itr;
+		}
+		return map.end();
+	}
+}
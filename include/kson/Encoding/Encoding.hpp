@@ -5,6 +5,11 @@ namespace kson
 {
 	namespace Encoding
 	{
+		// Converts Shift-JIS (CP932) to UTF-8 using the built-in CP932 table and appends it to *pDst (the capacity of *pDst is reused)
+		// Returns false if shiftJISStr is not a valid Shift-JIS string; in that case *pDst is left unchanged
+		bool ShiftJISToUTF8(std::string_view shiftJISStr, std::string* pDst);
+
+		// Note: If the input is not a valid Shift-JIS string, it is returned as is (assumed to be UTF-8).
 		[[nodiscard]]
 		std::string ShiftJISToUTF8(std::string_view shiftJISStr);
 	}
@@ -13,6 +13,7 @@ namespace kson
 
 		GeneralChartFormatError = 20000,
 		KsonParseError = 20001,
+		KsonBinParseError = 20002,
 
 		EncodingError = 30000,
 
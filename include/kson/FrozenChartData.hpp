@@ -0,0 +1,52 @@
+#pragma once
+#include "kson/Common/Common.hpp"
+#include "kson/Common/FlatMap.hpp"
+#include "kson/ChartData.hpp"
+
+namespace kson
+{
+	struct FrozenBeatInfo
+	{
+		FlatByPulse<double> bpm;
+
+		FlatByMeasureIdx<TimeSig> timeSig;
+
+		FlatGraph scrollSpeed;
+
+		FlatByPulse<RelPulse> stop;
+	};
+
+	struct FrozenNoteInfo
+	{
+		FlatBTLane<Interval> bt;
+		FlatFXLane<Interval> fx;
+		FlatLaserLane<FlatLaserSection> laser;
+	};
+
+	struct FrozenCamGraphs
+	{
+		FlatGraph zoomBottom;
+		FlatGraph zoomSide;
+		FlatGraph zoomTop;
+		FlatGraph rotationDeg;
+		FlatGraph centerSplit;
+	};
+
+	struct FrozenCameraInfo
+	{
+		FrozenCamGraphs cam;
+		FlatByPulse<TiltValue> tilt;
+	};
+
+	// Read-only copy of the frequently queried (e.g., every frame) parts of ChartData stored in sorted vectors
+	// Note: Other data (meta, audio, etc.) should be read from the original ChartData.
+	struct FrozenChartData
+	{
+		FrozenBeatInfo beat;
+		FrozenNoteInfo note;
+		FrozenCameraInfo camera;
+	};
+
+	[[nodiscard]]
+	FrozenChartData CreateFrozenChartData(const ChartData& chartData);
+}
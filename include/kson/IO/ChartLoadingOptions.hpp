@@ -0,0 +1,31 @@
+#pragma once
+
+namespace kson
+{
+	// Selects the ChartData sections to be loaded
+	// Note: Unselected sections are loaded as if they were absent from the file, so they are left default
+	//       (with the default values at zero, e.g., time signature 4/4 and auto tilt "normal").
+	//       meta, gauge, audio.bgm and audio.key_sound are always loaded, but the key sound events attached to notes are loaded only with note.
+	//       audio.audio_effect.fx.long_event (audio effects of long FX notes) requires both note and audioEffect.
+	struct ChartLoadingOptions
+	{
+		bool beat = true;
+		bool note = true;
+		bool camera = true;
+		bool audioEffect = true; // audio.audio_effect
+		bool bg = true;
+		bool editor = true;
+		bool compat = true;
+	};
+
+	// For gameplay without rendering or sound (e.g., score validation)
+	inline constexpr ChartLoadingOptions kChartLoadingOptionsBeatAndNote{
+		.beat = true,
+		.note = true,
+		.camera = false,
+		.audioEffect = false,
+		.bg = false,
+		.editor = false,
+		.compat = false,
+	};
+}
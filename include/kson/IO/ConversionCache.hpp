@@ -0,0 +1,59 @@
+#pragma once
+#include <optional>
+#include <span>
+#include <string_view>
+#include "kson/Common/Common.hpp"
+#include "kson/ChartData.hpp"
+#include "kson/IO/KshLoadingDiag.hpp"
+
+namespace kson
+{
+	enum class ConversionCacheFormat
+	{
+		kKson,
+		kKsonBin,
+	};
+
+	// Directory of converted charts keyed by the hash of the input bytes
+	// Note: The libkson version (including the git commit hash if available) and the kson and kson-bin format versions are mixed into every key,
+	//       so entries written by another version of libkson are never reused. versionKey (e.g., the application version) is mixed in as an additional salt.
+	//       Entries are stored as "<dir>/<2 hex digits>/<16 hex digits>_<input size>.<kson|ksonbin>".
+	//       Multiple processes may share a cache directory because each entry is written to a temporary file and then renamed.
+	class ConversionCache
+	{
+	private:
+		std::string m_dirPath;
+
+		std::uint64_t m_versionHash;
+
+	public:
+		ConversionCache(const std::string& dirPath, std::string_view versionKey);
+
+		[[nodiscard]]
+		const std::string& dirPath() const
+		{
+			return m_dirPath;
+		}
+
+		// Get the key of the entry converted from input (relative path in the cache directory)
+		[[nodiscard]]
+		std::string keyOf(std::span<const char> input, ConversionCacheFormat format) const;
+
+		[[nodiscard]]
+		std::string filePathOf(const std::string& key) const;
+
+		// Get the content of the entry, or std::nullopt if the entry does not exist
+		[[nodiscard]]
+		std::optional<std::string> load(const std::string& key) const;
+
+		// Note: Another writer may store the same key at the same time. Since the content is derived from the same input, either one wins.
+		ErrorType store(const std::string& key, std::string_view content) const;
+	};
+
+	// Loads a KSH chart through a kson-bin entry in the cache
+	// Note: The KSH is parsed and the entry is stored only if the entry does not exist or could not be loaded.
+	//       Warnings are reported to pKshDiag only in that case. Failures to store the entry are ignored.
+	ChartData LoadKshChartDataWithCache(std::span<const char> buffer, const ConversionCache& cache, KshLoadingDiag* pKshDiag = nullptr);
+
+	ChartData LoadKshChartDataWithCache(const std::string& filePath, const ConversionCache& cache, KshLoadingDiag* pKshDiag = nullptr);
+}
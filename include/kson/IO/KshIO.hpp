@@ -1,19 +1,61 @@
 #pragma once
+#include <functional>
+#include <span>
 #include "kson/Common/Common.hpp"
 #include "kson/ChartData.hpp"
+#include "kson/IO/ChartLoadingOptions.hpp"
 #include "kson/IO/KshLoadingDiag.hpp"
 #include "kson/IO/KshSavingDiag.hpp"
 
 namespace kson
 {
+	// Note: buffer is the content of a KSH file (not a file path)
+	MetaChartData LoadKshMetaChartData(std::span<const char> buffer);
+
 	MetaChartData LoadKshMetaChartData(std::istream& stream);
 
 	MetaChartData LoadKshMetaChartData(const std::string& filePath);
 
+	constexpr std::size_t kKshMetaScanMaxBytes = 64 * 1024;
+
+	// Fast path for song selection that scans only the header of a KSH file
+	// Note: Only title, artist, difficulty, level, BPM ("t", "to"), jacket and BGM (filename, volume, preview) are decoded.
+	//       The other fields are left default. The input is read by small chunks only until the first bar line ("--"),
+	//       and GeneralChartFormatError is returned if the bar line is not found within maxBytes.
+	MetaChartData ScanKshMetaChartData(std::span<const char> buffer, std::size_t maxBytes = kKshMetaScanMaxBytes);
+
+	MetaChartData ScanKshMetaChartData(std::istream& stream, std::size_t maxBytes = kKshMetaScanMaxBytes);
+
+	MetaChartData ScanKshMetaChartData(const std::string& filePath, std::size_t maxBytes = kKshMetaScanMaxBytes);
+
+	// Note: buffer is the content of a KSH file (not a file path)
+	//       Lines are parsed directly from the buffer without copying them into std::string
+	ChartData LoadKshChartData(std::span<const char> buffer, KshLoadingDiag* pKshDiag = nullptr);
+
 	ChartData LoadKshChartData(std::istream& stream, KshLoadingDiag* pKshDiag = nullptr);
 
 	ChartData LoadKshChartData(const std::string& filePath, KshLoadingDiag* pKshDiag = nullptr);
 
+	// Loads only the sections selected by options
+	// Note: Unselected option lines, comments and audio effect definitions are skipped without being parsed
+	ChartData LoadKshChartData(std::span<const char> buffer, const ChartLoadingOptions& options, KshLoadingDiag* pKshDiag = nullptr);
+
+	ChartData LoadKshChartData(std::istream& stream, const ChartLoadingOptions& options, KshLoadingDiag* pKshDiag = nullptr);
+
+	ChartData LoadKshChartData(const std::string& filePath, const ChartLoadingOptions& options, KshLoadingDiag* pKshDiag = nullptr);
+
+	// Loads multiple KSH files in parallel and passes each result to sink(i, chartData, diag) as soon as it is loaded
+	// Note: i is the index in filePaths. numThreads = 0 means std::thread::hardware_concurrency().
+	//       The sink is called concurrently from the worker threads, so it must be thread-safe.
+	//       If the sink throws, no more files are loaded and the first exception is rethrown after all the worker threads finish.
+	//       Only the charts being loaded or passed to the sink are kept in memory at the same time.
+	void LoadKshChartDataBatch(std::span<const std::string> filePaths, std::size_t numThreads, const std::function<void(std::size_t, ChartData&&, KshLoadingDiag&&)>& sink);
+
+	// Loads multiple KSH files in parallel
+	// Note: The i-th result (and diag) corresponds to filePaths[i]. numThreads = 0 means std::thread::hardware_concurrency().
+	//       All the charts are kept in the returned vector, so use the sink overload above for large libraries.
+	std::vector<ChartData> LoadKshChartDataBatch(std::span<const std::string> filePaths, std::size_t numThreads = 0, std::vector<KshLoadingDiag>* pKshDiags = nullptr);
+
 	ErrorType SaveKshChartData(std::ostream& stream, const ChartData& chartData, KshSavingDiag* pKshSavingDiag = nullptr);
 
 	ErrorType SaveKshChartData(const std::string& filePath, const ChartData& chartData, KshSavingDiag* pKshSavingDiag = nullptr);
@@ -0,0 +1,206 @@
+#pragma once
+#include <span>
+#include <string_view>
+#include "kson/Common/Common.hpp"
+#include "kson/ChartData.hpp"
+
+namespace kson
+{
+	// kson-bin: binary chart cache format
+	//
+	// Layout (little-endian):
+	//   Header (32 bytes): magic "KSONBIN\0", format version (u32), number of sections (u32), payload size (u64), payload checksum (u64)
+	//   Section table: {id (u32), index (u32), offset from the file start (u64), size (u64)} for each section
+	//   Section data: each section starts at an 8-byte boundary
+	//
+	// The frequently queried lanes (beat, note, camera body graphs) are stored as arrays of the fixed-width structs below,
+	// so that KsonBinChartView can expose them directly from the file content (e.g., a memory-mapped file).
+	// Strings are stored once in a string table and referenced by index.
+	// The other data (meta, audio, camera tilt and patterns, bg, editor, compat, impl) are stored in a sequential section.
+	//
+	// Note: A kson-bin file is a cache, not an interchange format. Files written with another version are rejected and should be regenerated.
+
+	inline constexpr std::uint32_t kKsonBinFormatVersion = 2;
+
+	inline constexpr std::size_t kKsonBinHeaderSize = 32;
+
+	struct KsonBinInterval
+	{
+		Pulse y = 0;
+		RelPulse length = 0;
+	};
+
+	struct KsonBinValue
+	{
+		Pulse y = 0;
+		double v = 0.0;
+	};
+
+	struct KsonBinTimeSig
+	{
+		std::int64_t measureIdx = 0;
+		std::int32_t n = 4;
+		std::int32_t d = 4;
+	};
+
+	struct KsonBinGraphPoint
+	{
+		Pulse y = 0; // Note: y is ry for laser points
+		double v = 0.0;
+		double vf = 0.0;
+		double a = 0.0;
+		double b = 0.0;
+	};
+
+	struct KsonBinLaserSection
+	{
+		Pulse y = 0;
+		std::uint32_t pointIdx = 0; // Index of the first point in KsonBinChartView::laserPoints()
+		std::uint32_t numPoints = 0;
+		std::int32_t w = kLaserXScale1x;
+		std::int32_t reserved = 0;
+	};
+
+	enum class KsonBinCamGraph : std::uint32_t
+	{
+		kZoomBottom,
+		kZoomSide,
+		kZoomTop,
+		kRotationDeg,
+		kCenterSplit,
+	};
+
+	inline constexpr std::size_t kNumKsonBinCamGraphs = 5;
+
+	// Read-only views over the fixed-width sections of a kson-bin file without decoding it
+	// Note: The header, checksum and section table are validated on construction, and error() is set if they are invalid.
+	//       The buffer must outlive the view and be aligned to 8 bytes (e.g., a memory-mapped file).
+	class KsonBinChartView
+	{
+	private:
+		template <typename T>
+		struct Section
+		{
+			const T* pData = nullptr;
+			std::size_t size = 0;
+
+			[[nodiscard]]
+			std::span<const T> span() const
+			{
+				return { pData, size };
+			}
+		};
+
+		Section<KsonBinValue> m_bpm;
+		Section<KsonBinTimeSig> m_timeSig;
+		Section<KsonBinGraphPoint> m_scrollSpeed;
+		Section<KsonBinInterval> m_stop;
+		std::array<Section<KsonBinInterval>, kNumBTLanesSZ> m_bt;
+		std::array<Section<KsonBinInterval>, kNumFXLanesSZ> m_fx;
+		std::array<Section<KsonBinLaserSection>, kNumLaserLanesSZ> m_laserSections;
+		std::array<Section<KsonBinGraphPoint>, kNumLaserLanesSZ> m_laserPoints;
+		std::array<Section<KsonBinGraphPoint>, kNumKsonBinCamGraphs> m_camGraphs;
+		Section<std::uint64_t> m_stringIndex; // {offset, size} pairs
+		Section<char> m_stringData;
+		Section<char> m_misc;
+
+		ErrorType m_error = ErrorType::KsonBinParseError;
+
+	public:
+		KsonBinChartView() = default;
+
+		explicit KsonBinChartView(std::span<const char> buffer);
+
+		[[nodiscard]]
+		ErrorType error() const
+		{
+			return m_error;
+		}
+
+		[[nodiscard]]
+		std::span<const KsonBinValue> bpm() const
+		{
+			return m_bpm.span();
+		}
+
+		[[nodiscard]]
+		std::span<const KsonBinTimeSig> timeSig() const
+		{
+			return m_timeSig.span();
+		}
+
+		[[nodiscard]]
+		std::span<const KsonBinGraphPoint> scrollSpeed() const
+		{
+			return m_scrollSpeed.span();
+		}
+
+		[[nodiscard]]
+		std::span<const KsonBinInterval> stop() const
+		{
+			return m_stop.span();
+		}
+
+		[[nodiscard]]
+		std::span<const KsonBinInterval> bt(std::size_t lane) const
+		{
+			return m_bt.at(lane).span();
+		}
+
+		[[nodiscard]]
+		std::span<const KsonBinInterval> fx(std::size_t lane) const
+		{
+			return m_fx.at(lane).span();
+		}
+
+		[[nodiscard]]
+		std::span<const KsonBinLaserSection> laserSections(std::size_t lane) const
+		{
+			return m_laserSections.at(lane).span();
+		}
+
+		[[nodiscard]]
+		std::span<const KsonBinGraphPoint> laserPoints(std::size_t lane) const
+		{
+			return m_laserPoints.at(lane).span();
+		}
+
+		[[nodiscard]]
+		std::span<const KsonBinGraphPoint> laserPoints(std::size_t lane, const KsonBinLaserSection& section) const
+		{
+			return laserPoints(lane).subspan(section.pointIdx, section.numPoints);
+		}
+
+		[[nodiscard]]
+		std::span<const KsonBinGraphPoint> camGraph(KsonBinCamGraph graph) const
+		{
+			return m_camGraphs.at(static_cast<std::size_t>(graph)).span();
+		}
+
+		[[nodiscard]]
+		std::size_t numStrings() const
+		{
+			return m_stringIndex.size / 2;
+		}
+
+		[[nodiscard]]
+		std::string_view string(std::size_t idx) const;
+
+		[[nodiscard]]
+		std::span<const char> miscData() const
+		{
+			return m_misc.span();
+		}
+	};
+
+	ErrorType SaveKsonBinChartData(std::ostream& stream, const ChartData& chartData);
+
+	ErrorType SaveKsonBinChartData(const std::string& filePath, const ChartData& chartData);
+
+	// Note: buffer is the content of a kson-bin file (not a file path) and must be aligned to 8 bytes
+	ChartData LoadKsonBinChartData(std::span<const char> buffer);
+
+	ChartData LoadKsonBinChartData(std::istream& stream);
+
+	ChartData LoadKsonBinChartData(const std::string& filePath);
+}
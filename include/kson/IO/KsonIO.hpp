@@ -1,6 +1,9 @@
 #pragma once
 #ifndef KSON_WITHOUT_JSON_DEPENDENCY
+#include <functional>
+#include <span>
 #include "kson/ChartData.hpp"
+#include "kson/IO/ChartLoadingOptions.hpp"
 #include "kson/IO/KsonLoadingDiag.hpp"
 
 namespace kson
@@ -15,6 +18,28 @@ namespace kson
 
 	ChartData LoadKsonChartData(const std::string& filePath, KsonLoadingDiag* pKsonDiag = nullptr);
 
+	// Loads only the sections selected by options
+	// Note: JSON subtrees of unselected sections are skipped without being stored
+	ChartData LoadKsonChartData(std::istream& stream, const ChartLoadingOptions& options, KsonLoadingDiag* pKsonDiag = nullptr);
+
+	ChartData LoadKsonChartData(const std::string& filePath, const ChartLoadingOptions& options, KsonLoadingDiag* pKsonDiag = nullptr);
+
+	// Loads multiple KSON files in parallel and passes each result to sink(i, chartData, diag) as soon as it is loaded
+	// Note: i is the index in filePaths. numThreads = 0 means std::thread::hardware_concurrency().
+	//       The sink is called concurrently from the worker threads, so it must be thread-safe.
+	//       If the sink throws, no more files are loaded and the first exception is rethrown after all the worker threads finish.
+	//       Only the charts being loaded or passed to the sink are kept in memory at the same time.
+	void LoadKsonChartDataBatch(std::span<const std::string> filePaths, std::size_t numThreads, const std::function<void(std::size_t, ChartData&&, KsonLoadingDiag&&)>& sink);
+
+	// Loads multiple KSON files in parallel
+	// Note: The i-th result (and diag) corresponds to filePaths[i]. numThreads = 0 means std::thread::hardware_concurrency().
+	//       All the charts are kept in the returned vector, so use the sink overload above for large libraries.
+	std::vector<ChartData> LoadKsonChartDataBatch(std::span<const std::string> filePaths, std::size_t numThreads = 0, std::vector<KsonLoadingDiag>* pKsonDiags = nullptr);
+
+	// Loads only format_version, meta and audio.bgm
+	// Note: Parsing stops as soon as these values are found, so the result may differ from LoadKsonChartData in these cases:
+	//       - A syntax error after these values is not reported.
+	//       - If a key appears more than once, the first value is used, while LoadKsonChartData uses the last one.
 	MetaChartData LoadKsonMetaChartData(std::istream& stream, KsonLoadingDiag* pKsonDiag = nullptr);
 
 	MetaChartData LoadKsonMetaChartData(const std::string& filePath, KsonLoadingDiag* pKsonDiag = nullptr);
@@ -1,5 +1,6 @@
 #pragma once
 #include "kson/Common/Common.hpp"
+#include "kson/Common/FlatMap.hpp"
 
 namespace kson
 {
@@ -20,6 +21,29 @@ namespace kson
 		}
 	};
 
+	// LaserSection with the points stored in a sorted vector (see FrozenChartData)
+	struct FlatLaserSection
+	{
+		FlatGraph v; // Laser points
+
+		std::int32_t w = kLaserXScale1x; // 1-2, sets whether the laser section is 2x-widen or not
+
+		FlatLaserSection() = default;
+
+		explicit FlatLaserSection(const LaserSection& laserSection)
+			: v(laserSection.v)
+			, w(laserSection.w)
+		{
+		}
+
+		// Returns 2x-widen or not
+		[[nodiscard]]
+		bool wide() const
+		{
+			return w == kLaserXScale2x;
+		}
+	};
+
 	struct NoteInfo
 	{
 		BTLane<Interval> bt;
@@ -1,6 +1,8 @@
 #pragma once
 #include <optional>
+#include <vector>
 #include "kson/Common/Common.hpp"
+#include "kson/Common/FlatMap.hpp"
 #include "kson/Note/NoteInfo.hpp"
 
 namespace kson
@@ -9,69 +11,180 @@ namespace kson
 	double GraphValueAt(const Graph& graph, Pulse pulse);
 
 	[[nodiscard]]
-	Graph BakeStopIntoScrollSpeed(const Graph& scrollSpeed, const ByPulse<RelPulse>& stop);
+	double GraphValueAt(const FlatGraph& graph, Pulse pulse);
 
-	template <class GS>
-	[[nodiscard]]
-	typename ByPulse<GS>::const_iterator GraphSectionAt(const ByPulse<GS>& graphSections, Pulse pulse)
-#ifdef __cpp_concepts
-		requires std::is_same_v<GS, GraphSection> || std::is_same_v<GS, LaserSection>
-#endif
+	// Stateful graph evaluator for monotonically increasing (e.g., frame-by-frame) queries
+	// Note: The values are the same as GraphValueAt (except for floating-point rounding errors).
+	//       The graph is copied into per-segment data, so the source graph does not need to outlive the sampler.
+	class GraphSampler
 	{
-		assert(!graphSections.empty());
-
-		auto itr = graphSections.upper_bound(pulse);
-		if (itr != graphSections.begin())
+	private:
+		struct Segment
 		{
-			--itr;
-		}
+			Pulse pulse = 0;
+			double startValue = 0.0; // vf of the segment start point
+			double endValue = 0.0; // v of the segment end point
+			double invLength = 0.0; // 0.0 for the last point
+			GraphCurveValue curve;
+		};
 
-		return itr;
-	}
+		std::vector<Segment> m_segments;
+
+		double m_firstValue = 0.0;
+
+		std::size_t m_segmentIdx = 0;
+
+		template <typename GraphType>
+		void resetImpl(const GraphType& graph);
+
+	public:
+		GraphSampler() = default;
+
+		explicit GraphSampler(const Graph& graph);
+
+		explicit GraphSampler(const FlatGraph& graph);
+
+		// Note: The allocated memory is reused
+		void reset(const Graph& graph);
+
+		void reset(const FlatGraph& graph);
+
+		[[nodiscard]]
+		double valueAt(Pulse pulse);
+
+		[[nodiscard]]
+		bool empty() const;
+	};
 
-	template <class GS>
 	[[nodiscard]]
-	std::optional<double> GraphSectionValueAt(const ByPulse<GS>& graphSections, Pulse pulse)
-#ifdef __cpp_concepts
-		requires std::is_same_v<GS, GraphSection> || std::is_same_v<GS, LaserSection>
-#endif
+	Graph BakeStopIntoScrollSpeed(const Graph& scrollSpeed, const ByPulse<RelPulse>& stop);
+
+	namespace detail
 	{
-		if (graphSections.empty())
-		{
-			return std::nullopt;
-		}
+		// Shared implementations of the graph section queries for ByPulse and FlatByPulse
 
-		const auto itr = GraphSectionAt(graphSections, pulse);
-		if (itr == graphSections.end())
-        {
-            return std::nullopt;
-        }
+		template <class GraphSections>
+		[[nodiscard]]
+		auto GraphSectionAtImpl(const GraphSections& graphSections, Pulse pulse)
+		{
+			assert(!graphSections.empty());
 
-		const auto& [y, graphSection] = *itr;
-		const RelPulse ry = pulse - y;
+			auto itr = graphSections.upper_bound(pulse);
+			if (itr != graphSections.begin())
+			{
+				--itr;
+			}
 
-		if (graphSection.v.size() <= 1)
-		{
-			return std::nullopt;
+			return itr;
 		}
 
+		template <class GraphSections>
+		[[nodiscard]]
+		std::optional<double> GraphSectionValueAtImpl(const GraphSections& graphSections, Pulse pulse)
 		{
-			const auto& [firstRy, _] = *graphSection.v.begin();
-			if (ry < firstRy)
+			if (graphSections.empty())
+			{
+				return std::nullopt;
+			}
+
+			const auto itr = GraphSectionAtImpl(graphSections, pulse);
+			if (itr == graphSections.end())
 			{
 				return std::nullopt;
 			}
+
+			const auto& [y, graphSection] = *itr;
+			const RelPulse ry = pulse - y;
+
+			if (graphSection.v.size() <= 1)
+			{
+				return std::nullopt;
+			}
+
+			{
+				const auto& [firstRy, _] = *graphSection.v.begin();
+				if (ry < firstRy)
+				{
+					return std::nullopt;
+				}
+			}
+
+			{
+				const auto& [lastRy, _] = *graphSection.v.rbegin();
+				if (ry >= lastRy)
+				{
+					return std::nullopt;
+				}
+			}
+
+			return std::make_optional(GraphValueAt(graphSection.v, ry));
 		}
 
+		template <class GraphSections>
+		[[nodiscard]]
+		std::optional<GraphPoint> GraphPointAtImpl(const GraphSections& graphSections, Pulse pulse)
 		{
-			const auto& [lastRy, _] = *graphSection.v.rbegin();
-			if (ry >= lastRy)
+			if (graphSections.empty())
+			{
+				return std::nullopt;
+			}
+
+			const auto itr = GraphSectionAtImpl(graphSections, pulse);
+			if (itr == graphSections.end())
+			{
+				return std::nullopt;
+			}
+
+			const auto& [y, graphSection] = *itr;
+			const RelPulse ry = pulse - y;
+
+			if (!graphSection.v.contains(ry))
 			{
 				return std::nullopt;
 			}
+
+			return graphSection.v.at(ry);
 		}
+	}
+
+	template <class GS>
+	[[nodiscard]]
+	typename ByPulse<GS>::const_iterator GraphSectionAt(const ByPulse<GS>& graphSections, Pulse pulse)
+#ifdef __cpp_concepts
+		requires std::is_same_v<GS, GraphSection> || std::is_same_v<GS, LaserSection>
+#endif
+	{
+		return detail::GraphSectionAtImpl(graphSections, pulse);
+	}
+
+	template <class GS>
+	[[nodiscard]]
+	typename FlatByPulse<GS>::const_iterator GraphSectionAt(const FlatByPulse<GS>& graphSections, Pulse pulse)
+#ifdef __cpp_concepts
+		requires std::is_same_v<GS, FlatLaserSection>
+#endif
+	{
+		return detail::GraphSectionAtImpl(graphSections, pulse);
+	}
+
+	template <class GS>
+	[[nodiscard]]
+	std::optional<double> GraphSectionValueAt(const ByPulse<GS>& graphSections, Pulse pulse)
+#ifdef __cpp_concepts
+		requires std::is_same_v<GS, GraphSection> || std::is_same_v<GS, LaserSection>
+#endif
+	{
+		return detail::GraphSectionValueAtImpl(graphSections, pulse);
+	}
 
-		return std::make_optional(GraphValueAt(graphSection.v, ry));
+	template <class GS>
+	[[nodiscard]]
+	std::optional<double> GraphSectionValueAt(const FlatByPulse<GS>& graphSections, Pulse pulse)
+#ifdef __cpp_concepts
+		requires std::is_same_v<GS, FlatLaserSection>
+#endif
+	{
+		return detail::GraphSectionValueAtImpl(graphSections, pulse);
 	}
 
 	template <class GS>
@@ -81,40 +194,116 @@ namespace kson
 		requires std::is_same_v<GS, GraphSection> || std::is_same_v<GS, LaserSection>
 #endif
 	{
-		const std::optional<double> sectionValue = GraphSectionValueAt(graphSections, pulse);
-		if (sectionValue.has_value())
-		{
-			return *sectionValue;
-		}
-		else
-		{
-			return defaultValue;
-		}
+		return GraphSectionValueAt(graphSections, pulse).value_or(defaultValue);
 	}
 
 	template <class GS>
 	[[nodiscard]]
-	std::optional<GraphPoint> GraphPointAt(const ByPulse<GS>& graphSections, Pulse pulse)
+	double GraphSectionValueAtWithDefault(const FlatByPulse<GS>& graphSections, Pulse pulse, double defaultValue)
+#ifdef __cpp_concepts
+		requires std::is_same_v<GS, FlatLaserSection>
+#endif
+	{
+		return GraphSectionValueAt(graphSections, pulse).value_or(defaultValue);
+	}
+
+	// Stateful version of GraphSectionValueAt for monotonically increasing queries
+	// Note: The graph sections must outlive the sampler and must not be modified while sampling
+	template <class GS>
+#ifdef __cpp_concepts
+		requires std::is_same_v<GS, GraphSection> || std::is_same_v<GS, LaserSection> || std::is_same_v<GS, FlatLaserSection>
+#endif
+	class GraphSectionSampler
 	{
-		if (graphSections.empty())
+	public:
+		using GraphSections = std::conditional_t<std::is_same_v<GS, FlatLaserSection>, FlatByPulse<GS>, ByPulse<GS>>;
+
+	private:
+		const GraphSections* m_pGraphSections;
+
+		typename GraphSections::const_iterator m_sectionItr;
+
+		GraphSampler m_sampler;
+
+	public:
+		explicit GraphSectionSampler(const GraphSections& graphSections)
+			: m_pGraphSections(&graphSections)
+			, m_sectionItr(graphSections.end())
 		{
-			return std::nullopt;
 		}
 
-		const auto itr = GraphSectionAt(graphSections, pulse);
-		if (itr == graphSections.end())
+		[[nodiscard]]
+		std::optional<double> valueAt(Pulse pulse)
 		{
-			return std::nullopt;
-		}
+			const auto& graphSections = *m_pGraphSections;
+			if (graphSections.empty())
+			{
+				return std::nullopt;
+			}
+
+			// Advance from the current section, or search from scratch when seeking backward
+			auto itr = m_sectionItr;
+			if (itr != graphSections.end() && itr->first <= pulse)
+			{
+				for (auto nextItr = std::next(itr); nextItr != graphSections.end() && nextItr->first <= pulse; ++nextItr)
+				{
+					itr = nextItr;
+				}
+			}
+			else
+			{
+				itr = GraphSectionAt(graphSections, pulse);
+			}
+
+			if (itr != m_sectionItr)
+			{
+				m_sectionItr = itr;
+				m_sampler.reset(itr->second.v);
+			}
+
+			const auto& [y, graphSection] = *itr;
+			const RelPulse ry = pulse - y;
+
+			if (graphSection.v.size() <= 1)
+			{
+				return std::nullopt;
+			}
+
+			if (ry < graphSection.v.begin()->first || ry >= graphSection.v.rbegin()->first)
+			{
+				return std::nullopt;
+			}
 
-		const auto& [y, graphSection] = *itr;
-		const RelPulse ry = pulse - y;
+			return std::make_optional(m_sampler.valueAt(ry));
+		}
 
-		if (!graphSection.v.contains(ry))
+		[[nodiscard]]
+		double valueAtWithDefault(Pulse pulse, double defaultValue)
 		{
-			return std::nullopt;
+			return valueAt(pulse).value_or(defaultValue);
 		}
+	};
+
+	template <class GS>
+	GraphSectionSampler(const ByPulse<GS>&) -> GraphSectionSampler<GS>;
+
+	template <class GS>
+	GraphSectionSampler(const FlatByPulse<GS>&) -> GraphSectionSampler<GS>;
+
+	template <class GS>
+	[[nodiscard]]
+	std::optional<GraphPoint> GraphPointAt(const ByPulse<GS>& graphSections, Pulse pulse)
+	{
+		return detail::GraphPointAtImpl(graphSections, pulse);
+	}
 
-		return graphSection.v.at(ry);
+	template <class GS>
+	[[nodiscard]]
+	std::optional<GraphPoint> GraphPointAt(const FlatByPulse<GS>& graphSections, Pulse pulse)
+#ifdef __cpp_concepts
+		requires std::is_same_v<GS, FlatLaserSection>
+#endif
+	{
+		return detail::GraphPointAtImpl(graphSections, pulse);
 	}
 }
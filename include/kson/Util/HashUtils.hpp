@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+#include <span>
+
+namespace kson
+{
+	inline constexpr std::uint64_t kHash64DefaultSeed = 14695981039346656037ULL;
+
+	// Get a 64-bit hash of the data (xxHash64-style rounds over 64-bit words with a final avalanche)
+	// Note: This is not a cryptographic hash. The result is stable across runs, but depends on the host byte order.
+	//       Pass the result of a previous call as seed to chain the hashes of multiple buffers.
+	//       The chained result is not equal to the hash of the concatenated buffers.
+	[[nodiscard]]
+	std::uint64_t Hash64(std::span<const char> data, std::uint64_t seed = kHash64DefaultSeed);
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <charconv>
+
+namespace kson
+{
+	// Parse a double value in the same way as std::from_chars with std::chars_format::general
+	// Note: Falls back to a locale-independent parser on standard libraries without floating-point std::from_chars.
+	//       The fallback result may differ from the correctly rounded value in the last bit, which is negligible for chart values.
+	std::from_chars_result FromCharsDouble(const char* first, const char* last, double& value);
+}
@@ -3,6 +3,8 @@
 #include "kson/Note/NoteInfo.hpp"
 #include "kson/Beat/BeatInfo.hpp"
 #include "kson/ChartData.hpp"
+#include <vector>
+#include <span>
 
 namespace kson
 {
@@ -14,9 +16,82 @@ namespace kson
 		std::map<Pulse, std::int64_t> timeSigChangeMeasureIdx;
 	};
 
+	// Tempo segment that starts at a tempo change
+	struct TimingSegment
+	{
+		Pulse pulse = 0;
+		double sec = 0.0;
+		double bpm = 120.0;
+	};
+
+	// Compact timing table for pulse/sec conversion
+	// Note: Segments are sorted by both pulse and sec, and the first segment always starts at zero
+	struct TimingIndex
+	{
+		std::vector<TimingSegment> segments;
+	};
+
+	// Cursor over TimingIndex for monotonically increasing (e.g., frame-by-frame) queries
+	// Note: The cursor advances from the previously used segment instead of searching the whole table.
+	//       Queries in the decreasing direction are also supported, but fall back to binary search.
+	class TimingCursor
+	{
+	private:
+		const TimingIndex* m_pIndex;
+
+		std::size_t m_segmentIdx = 0;
+
+		void seekByPulse(double pulse);
+
+		void seekBySec(double sec);
+
+	public:
+		explicit TimingCursor(const TimingIndex& index);
+
+		[[nodiscard]]
+		double pulseToSec(Pulse pulse);
+
+		[[nodiscard]]
+		double pulseDoubleToSec(double pulseDouble);
+
+		[[nodiscard]]
+		Pulse secToPulse(double sec);
+
+		[[nodiscard]]
+		double secToPulseDouble(double sec);
+
+		[[nodiscard]]
+		double currentBPM() const;
+	};
+
 	[[nodiscard]]
 	Pulse TimeSigOneMeasurePulse(const TimeSig& timeSig);
 
+	// Note: The results of the TimingIndex overloads are the same as the TimingCache ones
+	[[nodiscard]]
+	TimingIndex CreateTimingIndex(const BeatInfo& beatInfo);
+
+	[[nodiscard]]
+	double PulseToSec(Pulse pulse, const TimingIndex& index);
+
+	[[nodiscard]]
+	double PulseDoubleToSec(double pulseDouble, const TimingIndex& index);
+
+	[[nodiscard]]
+	Pulse SecToPulse(double sec, const TimingIndex& index);
+
+	[[nodiscard]]
+	double SecToPulseDouble(double sec, const TimingIndex& index);
+
+	// Batch conversion of many values at once (e.g., every note start in a lane)
+	// Note: Sorted input is converted in one pass by walking the tempo segments.
+	//       Unsorted input is also supported, but is slower.
+	//       The values are converted one by one (not with SIMD), and the results are the same as PulseToSec and SecToPulse.
+	//       The sizes of the source and destination must be the same.
+	void PulsesToSec(std::span<const Pulse> pulses, std::span<double> dstSecs, const TimingIndex& index);
+
+	void SecsToPulse(std::span<const double> secs, std::span<Pulse> dstPulses, const TimingIndex& index);
+
 	[[nodiscard]]
 	TimingCache CreateTimingCache(const BeatInfo& beatInfo);
 
@@ -1,13 +1,21 @@
 #pragma once
 #include "Error.hpp"
 #include "ChartData.hpp"
+#include "FrozenChartData.hpp"
+#include "Audio/InternedAudioEffect.hpp"
+#include "Audio/CompiledAudioEffect.hpp"
+#include "IO/ChartLoadingOptions.hpp"
+#include "IO/ConversionCache.hpp"
 #include "IO/IDiag.hpp"
 #include "IO/KshIO.hpp"
 #include "IO/KshLoadingDiag.hpp"
 #include "IO/KshSavingDiag.hpp"
+#include "IO/KsonBinIO.hpp"
 #include "IO/KsonIO.hpp"
 #include "IO/KsonLoadingDiag.hpp"
 #include "Util/TimingUtils.hpp"
 #include "Util/GraphUtils.hpp"
 #include "Util/GraphCurve.hpp"
 #include "Util/TiltUtils.hpp"
+#include "Util/HashUtils.hpp"
+#include "Util/NumericUtils.hpp"
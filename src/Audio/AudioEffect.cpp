@@ -65,15 +65,71 @@ std::string_view kson::AudioEffectTypeToStr(AudioEffectType type)
 	}
 }
 
+kson::AudioEffectDefIndex::AudioEffectDefIndex(const std::vector<AudioEffectDefKVP>& def)
+	: m_pDef(&def)
+{
+	sync();
+}
+
+void kson::AudioEffectDefIndex::sync()
+{
+	const std::vector<AudioEffectDefKVP>& def = *m_pDef;
+	if (def.size() < m_numIndexed)
+	{
+		// The list has been cleared or shrunk
+		m_indices.clear();
+		m_numIndexed = 0;
+	}
+	for (; m_numIndexed < def.size(); ++m_numIndexed)
+	{
+		// Note: emplace does not overwrite the existing index, so the first definition is kept
+		m_indices.emplace(def[m_numIndexed].name, m_numIndexed);
+	}
+}
+
+void kson::AudioEffectDefIndex::rebuild()
+{
+	m_indices.clear();
+	m_numIndexed = 0;
+	sync();
+}
+
+std::size_t kson::AudioEffectDefIndex::indexOf(std::string_view name) const
+{
+	assert(m_numIndexed == m_pDef->size() && "AudioEffectDefIndex::sync() must be called after appending definitions");
+
+	const auto it = m_indices.find(name);
+	if (it == m_indices.end())
+	{
+		return npos;
+	}
+	return it->second;
+}
+
+bool kson::AudioEffectDefIndex::contains(std::string_view name) const
+{
+	return indexOf(name) != npos;
+}
+
+const AudioEffectDef* kson::AudioEffectDefIndex::find(std::string_view name) const
+{
+	const std::size_t idx = indexOf(name);
+	if (idx == npos)
+	{
+		return nullptr;
+	}
+	return &(*m_pDef)[idx].v;
+}
+
 bool kson::AudioEffectFXInfo::defContains(std::string_view name) const
 {
-	// Note: This is inefficient, so we recommend caching the result of defAsDict if this is used often
+	// Note: This is inefficient, so we recommend using AudioEffectDefIndex if this is used often
 	return std::any_of(def.begin(), def.end(), [name](const auto& kvp) { return kvp.name == name; });
 }
 
 const AudioEffectDef& kson::AudioEffectFXInfo::defByName(std::string_view name) const
 {
-	// Note: This is inefficient, so we recommend caching the result of defAsDict if this is used often
+	// Note: This is inefficient, so we recommend using AudioEffectDefIndex if this is used often
 	const auto it = std::find_if(def.begin(), def.end(), [name](const auto& kvp) { return kvp.name == name; });
 	if (it == def.end())
 	{
@@ -94,14 +150,14 @@ Dict<AudioEffectDef> kson::AudioEffectFXInfo::defAsDict() const
 
 bool kson::AudioEffectLaserInfo::defContains(std::string_view name) const
 {
-	// Note: If you call this function frequently, it's recommended to first call defAsDict to get the dictionary and use it,
+	// Note: If you call this function frequently, it's recommended to use AudioEffectDefIndex,
 	//       as this function uses linear search.
 	return std::any_of(def.begin(), def.end(), [name](const auto& kvp) { return kvp.name == name; });
 }
 
 const AudioEffectDef& kson::AudioEffectLaserInfo::defByName(std::string_view name) const
 {
-	// Note: If you call this function frequently, it's recommended to first call defAsDict to get the dictionary and use it,
+	// Note: If you call this function frequently, it's recommended to use AudioEffectDefIndex,
 	//       as this function uses linear search.
 	const auto it = std::find_if(def.begin(), def.end(), [name](const auto& kvp) { return kvp.name == name; });
 	if (it == def.end())
@@ -0,0 +1,238 @@
+#include "kson/Audio/CompiledAudioEffect.hpp"
+
+namespace
+{
+	using namespace kson;
+
+	// Note: The order must be the same as AudioEffectParamID
+	constexpr std::array<std::string_view, kNumAudioEffectParamIDs> kAudioEffectParamNames
+	{
+		"attack_time",
+		"bandwidth",
+		"chunk_size",
+		"delay",
+		"depth",
+		"feedback",
+		"feedback_level",
+		"filename",
+		"freq",
+		"freq_1",
+		"freq_2",
+		"freq_max",
+		"gain",
+		"hi_cut_gain",
+		"hold_time",
+		"mix",
+		"overlap",
+		"period",
+		"pitch",
+		"q",
+		"rate",
+		"ratio",
+		"reduction",
+		"release_time",
+		"speed",
+		"stage",
+		"stereo_width",
+		"trigger",
+		"update_period",
+		"update_trigger",
+		"v",
+		"vol",
+		"wave_length",
+	};
+
+	const std::unordered_map<std::string_view, AudioEffectParamID> s_strToAudioEffectParamID = []
+		{
+			std::unordered_map<std::string_view, AudioEffectParamID> map;
+			for (std::size_t i = 0; i < kNumAudioEffectParamIDs; ++i)
+			{
+				map.emplace(kAudioEffectParamNames[i], static_cast<AudioEffectParamID>(i));
+			}
+			return map;
+		}();
+
+	std::vector<CompiledAudioEffect> CompileEffects(
+		const std::vector<InternedAudioEffectDef>& defs,
+		const std::vector<InternedAudioEffectParamChange>& paramChanges,
+		const std::set<AudioEffectSymbol>& usedNames,
+		const AudioEffectSymbolTable& symbols)
+	{
+		std::vector<CompiledAudioEffect> effects;
+		effects.reserve(defs.size());
+		for (const auto& def : defs)
+		{
+			effects.push_back({
+				.name = def.name,
+				.type = def.type,
+				.params = CompileAudioEffectParams(def.v, symbols),
+			});
+		}
+
+		// Note: Effects used without definition (e.g., "retrigger") are added if the names are preset effects
+		const auto definedEnd = static_cast<std::ptrdiff_t>(effects.size());
+		for (const AudioEffectSymbol name : usedNames)
+		{
+			const auto definedItr = std::lower_bound(effects.begin(), effects.begin() + definedEnd, name, [](const auto& effect, AudioEffectSymbol value) { return effect.name < value; });
+			const bool isDefined = definedItr != effects.begin() + definedEnd && definedItr->name == name;
+			if (isDefined)
+			{
+				continue;
+			}
+
+			const AudioEffectType type = StrToAudioEffectType(symbols.str(name));
+			if (type != AudioEffectType::Unspecified)
+			{
+				effects.push_back({ .name = name, .type = type });
+			}
+		}
+		std::sort(effects.begin(), effects.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+
+		for (const auto& change : paramChanges)
+		{
+			const auto effectItr = std::lower_bound(effects.begin(), effects.end(), change.name, [](const auto& effect, AudioEffectSymbol value) { return effect.name < value; });
+			const AudioEffectParamID id = StrToAudioEffectParamID(symbols.str(change.key));
+			if (effectItr == effects.end() || effectItr->name != change.name || id == AudioEffectParamID::Unspecified)
+			{
+				continue;
+			}
+
+			std::map<Pulse, AudioEffectParamValue> values;
+			for (const auto& [y, param] : change.v)
+			{
+				values.emplace_hint(values.end(), y, param.value);
+			}
+			effectItr->paramChange[static_cast<std::size_t>(id)] = FlatByPulse<AudioEffectParamValue>(values);
+		}
+
+		return effects;
+	}
+
+	const CompiledAudioEffect* FindEffect(const std::vector<CompiledAudioEffect>& effects, AudioEffectSymbol name)
+	{
+		const auto itr = std::lower_bound(effects.begin(), effects.end(), name, [](const auto& effect, AudioEffectSymbol value) { return effect.name < value; });
+		if (itr == effects.end() || itr->name != name)
+		{
+			return nullptr;
+		}
+		return &*itr;
+	}
+}
+
+kson::AudioEffectParamID kson::StrToAudioEffectParamID(std::string_view str)
+{
+	const auto itr = s_strToAudioEffectParamID.find(str);
+	if (itr == s_strToAudioEffectParamID.end())
+	{
+		return AudioEffectParamID::Unspecified;
+	}
+	return itr->second;
+}
+
+std::string_view kson::AudioEffectParamIDToStr(AudioEffectParamID id)
+{
+	const std::size_t idx = static_cast<std::size_t>(id);
+	if (idx >= kNumAudioEffectParamIDs)
+	{
+		return "";
+	}
+	return kAudioEffectParamNames[idx];
+}
+
+kson::CompiledAudioEffectParams kson::CompileAudioEffectParams(const InternedAudioEffectParams& params, const AudioEffectSymbolTable& symbols)
+{
+	CompiledAudioEffectParams compiled;
+	for (const auto& param : params)
+	{
+		const AudioEffectParamID id = StrToAudioEffectParamID(symbols.str(param.key));
+		if (id == AudioEffectParamID::Unspecified)
+		{
+			continue;
+		}
+
+		const std::size_t idx = static_cast<std::size_t>(id);
+		compiled.v[idx] = param.value;
+		compiled.raw[idx] = param.raw;
+	}
+	return compiled;
+}
+
+kson::AudioEffectParamValue kson::CompiledAudioEffect::valueAt(AudioEffectParamID id, Pulse pulse, const CompiledAudioEffectParams* pOverrides) const
+{
+	const std::size_t idx = static_cast<std::size_t>(id);
+	assert(idx < kNumAudioEffectParamIDs);
+
+	if (pOverrides != nullptr && pOverrides->contains(id))
+	{
+		return pOverrides->v[idx];
+	}
+
+	const auto& changes = paramChange[idx];
+	if (changes.empty())
+	{
+		return params.v[idx];
+	}
+	return ValueAtOrDefault(changes, pulse, params.v[idx]);
+}
+
+kson::AudioEffectParamScalars kson::CompiledAudioEffect::evaluate(Pulse pulse, double laserValue, bool isOn, const CompiledAudioEffectParams* pOverrides) const
+{
+	AudioEffectParamScalars scalars;
+	for (std::size_t i = 0; i < kNumAudioEffectParamIDs; ++i)
+	{
+		scalars[i] = valueAt(static_cast<AudioEffectParamID>(i), pulse, pOverrides).evaluate(laserValue, isOn);
+	}
+	return scalars;
+}
+
+const kson::CompiledAudioEffect* kson::CompiledAudioEffectFXInfo::find(AudioEffectSymbol name) const
+{
+	return FindEffect(effects, name);
+}
+
+const kson::CompiledAudioEffect* kson::CompiledAudioEffectLaserInfo::find(AudioEffectSymbol name) const
+{
+	return FindEffect(effects, name);
+}
+
+kson::CompiledAudioEffectInfo kson::CompileAudioEffectInfo(const InternedAudioEffectInfo& interned)
+{
+	const AudioEffectSymbolTable& symbols = interned.symbols;
+	CompiledAudioEffectInfo compiled;
+
+	std::set<AudioEffectSymbol> fxNames;
+	for (const auto& change : interned.fx.paramChange)
+	{
+		fxNames.insert(change.name);
+	}
+	for (std::size_t i = 0; i < kNumFXLanesSZ; ++i)
+	{
+		for (const auto& [y, invocations] : interned.fx.longEvent[i])
+		{
+			auto& compiledInvocations = compiled.fx.longEvent[i][y];
+			compiledInvocations.reserve(invocations.size());
+			for (const auto& invocation : invocations)
+			{
+				fxNames.insert(invocation.name);
+				compiledInvocations.push_back({
+					.name = invocation.name,
+					.v = CompileAudioEffectParams(invocation.v, symbols),
+				});
+			}
+		}
+	}
+	compiled.fx.effects = CompileEffects(interned.fx.def, interned.fx.paramChange, fxNames, symbols);
+
+	std::set<AudioEffectSymbol> laserNames;
+	for (const auto& change : interned.laser.paramChange)
+	{
+		laserNames.insert(change.name);
+	}
+	for (const auto& [y, names] : interned.laser.pulseEvent)
+	{
+		laserNames.insert(names.begin(), names.end());
+	}
+	compiled.laser.effects = CompileEffects(interned.laser.def, interned.laser.paramChange, laserNames, symbols);
+
+	return compiled;
+}
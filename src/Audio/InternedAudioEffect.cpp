@@ -0,0 +1,310 @@
+#include "kson/Audio/InternedAudioEffect.hpp"
+#include "kson/Util/NumericUtils.hpp"
+#include <tuple>
+
+namespace
+{
+	using namespace kson;
+
+	bool ParseDouble(std::string_view str, double* pValue)
+	{
+		if (str.empty())
+		{
+			return false;
+		}
+		const char* const last = str.data() + str.size();
+		const auto [ptr, ec] = FromCharsDouble(str.data(), last, *pValue);
+		return ec == std::errc{} && ptr == last;
+	}
+
+	AudioEffectParamScalar ParseScalar(std::string_view str)
+	{
+		if (str == "on")
+		{
+			return { AudioEffectParamUnit::kSwitch, 1.0 };
+		}
+		if (str == "off")
+		{
+			return { AudioEffectParamUnit::kSwitch, 0.0 };
+		}
+
+		if (const std::size_t slashPos = str.find('/'); slashPos != std::string_view::npos)
+		{
+			double numerator, denominator;
+			if (ParseDouble(str.substr(0, slashPos), &numerator) && ParseDouble(str.substr(slashPos + 1), &denominator) && denominator != 0.0)
+			{
+				return { AudioEffectParamUnit::kFraction, numerator / denominator };
+			}
+			return {};
+		}
+
+		struct Suffix
+		{
+			std::string_view str;
+			AudioEffectParamUnit unit;
+			double scale;
+		};
+
+		// Note: Longer suffixes must come first ("ms" before "s", "kHz" before "Hz")
+		static constexpr Suffix kSuffixes[] = {
+			{ "samples", AudioEffectParamUnit::kSamples, 1.0 },
+			{ "kHz", AudioEffectParamUnit::kHz, 1000.0 },
+			{ "Hz", AudioEffectParamUnit::kHz, 1.0 },
+			{ "dB", AudioEffectParamUnit::kDecibel, 1.0 },
+			{ "ms", AudioEffectParamUnit::kSec, 0.001 },
+			{ "s", AudioEffectParamUnit::kSec, 1.0 },
+			{ "%", AudioEffectParamUnit::kRate, 0.01 },
+		};
+
+		AudioEffectParamUnit unit = AudioEffectParamUnit::kNumber;
+		double scale = 1.0;
+		for (const auto& suffix : kSuffixes)
+		{
+			if (str.ends_with(suffix.str))
+			{
+				str.remove_suffix(suffix.str.size());
+				unit = suffix.unit;
+				scale = suffix.scale;
+				break;
+			}
+		}
+
+		double value;
+		if (!ParseDouble(str, &value))
+		{
+			return {};
+		}
+		return { unit, value * scale };
+	}
+
+	template <typename Map>
+	InternedAudioEffectParams InternParams(const Map& params, AudioEffectSymbolTable& symbols)
+	{
+		InternedAudioEffectParams interned;
+		interned.reserve(params.size());
+		for (const auto& [key, value] : params)
+		{
+			interned.push_back({
+				.key = symbols.intern(key),
+				.raw = symbols.intern(value),
+				.value = ParseAudioEffectParamValue(value),
+			});
+		}
+		std::sort(interned.begin(), interned.end(), [](const auto& a, const auto& b) { return a.key < b.key; });
+		return interned;
+	}
+
+	std::vector<InternedAudioEffectDef> InternDefs(const std::vector<AudioEffectDefKVP>& defs, AudioEffectSymbolTable& symbols)
+	{
+		std::vector<InternedAudioEffectDef> interned;
+		interned.reserve(defs.size());
+		for (const auto& [name, def] : defs)
+		{
+			interned.push_back({
+				.name = symbols.intern(name),
+				.type = def.type,
+				.v = InternParams(def.v, symbols),
+			});
+		}
+
+		// Note: The first definition is used if the same name is defined more than once, which is the same as defByName
+		std::stable_sort(interned.begin(), interned.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+		interned.erase(std::unique(interned.begin(), interned.end(), [](const auto& a, const auto& b) { return a.name == b.name; }), interned.end());
+		return interned;
+	}
+
+	std::vector<InternedAudioEffectParamChange> InternParamChanges(const Dict<Dict<ByPulse<std::string>>>& paramChange, AudioEffectSymbolTable& symbols)
+	{
+		std::vector<InternedAudioEffectParamChange> interned;
+		for (const auto& [name, params] : paramChange)
+		{
+			const AudioEffectSymbol nameSymbol = symbols.intern(name);
+			for (const auto& [key, values] : params)
+			{
+				InternedAudioEffectParamChange& change = interned.emplace_back();
+				change.name = nameSymbol;
+				change.key = symbols.intern(key);
+				for (const auto& [y, value] : values)
+				{
+					change.v.emplace_hint(change.v.end(), y, InternedAudioEffectParam{
+						.key = change.key,
+						.raw = symbols.intern(value),
+						.value = ParseAudioEffectParamValue(value),
+					});
+				}
+			}
+		}
+		std::sort(interned.begin(), interned.end(), [](const auto& a, const auto& b) { return std::tie(a.name, a.key) < std::tie(b.name, b.key); });
+		return interned;
+	}
+
+	const InternedAudioEffectDef* FindDef(const std::vector<InternedAudioEffectDef>& defs, AudioEffectSymbol name)
+	{
+		const auto itr = std::lower_bound(defs.begin(), defs.end(), name, [](const auto& def, AudioEffectSymbol value) { return def.name < value; });
+		if (itr == defs.end() || itr->name != name)
+		{
+			return nullptr;
+		}
+		return &*itr;
+	}
+}
+
+AudioEffectSymbol kson::AudioEffectSymbolTable::intern(std::string_view str)
+{
+	if (const auto itr = m_symbols.find(str); itr != m_symbols.end())
+	{
+		return itr->second;
+	}
+
+	const AudioEffectSymbol symbol = static_cast<AudioEffectSymbol>(m_strings.size());
+	m_strings.emplace_back(str);
+	m_symbols.emplace(std::string(str), symbol);
+	return symbol;
+}
+
+AudioEffectSymbol kson::AudioEffectSymbolTable::find(std::string_view str) const
+{
+	const auto itr = m_symbols.find(str);
+	if (itr == m_symbols.end())
+	{
+		return kInvalidAudioEffectSymbol;
+	}
+	return itr->second;
+}
+
+const std::string& kson::AudioEffectSymbolTable::str(AudioEffectSymbol symbol) const
+{
+	static const std::string kEmptyString;
+	if (symbol >= m_strings.size())
+	{
+		return kEmptyString;
+	}
+	return m_strings[symbol];
+}
+
+std::size_t kson::AudioEffectSymbolTable::size() const
+{
+	return m_strings.size();
+}
+
+bool kson::AudioEffectParamValue::isValid() const
+{
+	return off.unit != AudioEffectParamUnit::kInvalid
+		&& onMin.unit != AudioEffectParamUnit::kInvalid
+		&& onMax.unit != AudioEffectParamUnit::kInvalid;
+}
+
+kson::AudioEffectParamScalar kson::AudioEffectParamValue::evaluate(double laserValue, bool isOn) const
+{
+	if (!isOn)
+	{
+		return off;
+	}
+
+	if (onMin.unit != onMax.unit)
+	{
+		return laserValue < 0.5 ? onMin : onMax;
+	}
+
+	return { onMin.unit, onMin.v + (onMax.v - onMin.v) * laserValue };
+}
+
+kson::AudioEffectParamValue kson::ParseAudioEffectParamValue(std::string_view str)
+{
+	std::string_view offStr = str;
+	std::string_view onStr = str;
+	const std::size_t gtPos = str.find('>');
+	if (gtPos != std::string_view::npos)
+	{
+		offStr = str.substr(0, gtPos);
+		onStr = str.substr(gtPos + 1);
+	}
+
+	// Note: The search starts from the second character so that a leading '-' is treated as a minus sign
+	std::string_view onMinStr = onStr;
+	std::string_view onMaxStr = onStr;
+	const std::size_t hyphenPos = onStr.empty() ? std::string_view::npos : onStr.find('-', 1);
+	if (hyphenPos != std::string_view::npos)
+	{
+		onMinStr = onStr.substr(0, hyphenPos);
+		onMaxStr = onStr.substr(hyphenPos + 1);
+	}
+
+	if (gtPos == std::string_view::npos)
+	{
+		offStr = onMinStr;
+	}
+
+	return {
+		.off = ParseScalar(offStr),
+		.onMin = ParseScalar(onMinStr),
+		.onMax = ParseScalar(onMaxStr),
+	};
+}
+
+const kson::InternedAudioEffectParam* kson::FindInternedAudioEffectParam(const InternedAudioEffectParams& params, AudioEffectSymbol key)
+{
+	const auto itr = std::lower_bound(params.begin(), params.end(), key, [](const auto& param, AudioEffectSymbol value) { return param.key < value; });
+	if (itr == params.end() || itr->key != key)
+	{
+		return nullptr;
+	}
+	return &*itr;
+}
+
+const kson::InternedAudioEffectDef* kson::InternedAudioEffectFXInfo::findDef(AudioEffectSymbol name) const
+{
+	return FindDef(def, name);
+}
+
+const kson::InternedAudioEffectDef* kson::InternedAudioEffectLaserInfo::findDef(AudioEffectSymbol name) const
+{
+	return FindDef(def, name);
+}
+
+kson::InternedAudioEffectInfo kson::CreateInternedAudioEffectInfo(const AudioEffectInfo& audioEffect)
+{
+	InternedAudioEffectInfo interned;
+	AudioEffectSymbolTable& symbols = interned.symbols;
+
+	interned.fx.def = InternDefs(audioEffect.fx.def, symbols);
+	interned.fx.paramChange = InternParamChanges(audioEffect.fx.paramChange, symbols);
+	for (const auto& [name, lanes] : audioEffect.fx.longEvent)
+	{
+		const AudioEffectSymbol nameSymbol = symbols.intern(name);
+		for (std::size_t i = 0; i < kNumFXLanesSZ; ++i)
+		{
+			for (const auto& [y, params] : lanes[i])
+			{
+				interned.fx.longEvent[i][y].push_back({
+					.name = nameSymbol,
+					.v = InternParams(params, symbols),
+				});
+			}
+		}
+	}
+	for (auto& lane : interned.fx.longEvent)
+	{
+		for (auto& [y, invocations] : lane)
+		{
+			std::sort(invocations.begin(), invocations.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+		}
+	}
+
+	interned.laser.def = InternDefs(audioEffect.laser.def, symbols);
+	interned.laser.paramChange = InternParamChanges(audioEffect.laser.paramChange, symbols);
+	for (const auto& [name, pulses] : audioEffect.laser.pulseEvent)
+	{
+		const AudioEffectSymbol nameSymbol = symbols.intern(name);
+		for (const Pulse y : pulses)
+		{
+			interned.laser.pulseEvent[y].push_back(nameSymbol);
+		}
+	}
+	for (auto& [y, names] : interned.laser.pulseEvent)
+	{
+		std::sort(names.begin(), names.end());
+	}
+
+	return interned;
+}
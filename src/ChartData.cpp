@@ -10,7 +10,7 @@ namespace kson
 		chartData.beat.timeSig.emplace(0, TimeSig{ 4, 4 });
 		chartData.beat.scrollSpeed.emplace(0, GraphValue{ 1.0, 1.0 });
 		chartData.audio.bgm.vol = 0.75;
-		chartData.audio.audioEffect.laser.pulseEvent.emplace("peaking_filter", std::set<Pulse>{ 0 });
+		chartData.audio.audioEffect.laser.pulseEvent.emplace("peaking_filter", PulseSet{ 0 });
 		chartData.audio.audioEffect.laser.legacy.filterGain.emplace(0, 0.5);
 		chartData.audio.audioEffect.laser.peakingFilterDelay = 40;
 		chartData.audio.keySound.laser.vol.emplace(0, 0.5);
@@ -0,0 +1,22 @@
+#include "kson/Common/ChartMemoryResource.hpp"
+
+namespace
+{
+	thread_local std::pmr::memory_resource* t_chartMemoryResource = nullptr;
+}
+
+std::pmr::memory_resource* kson::CurrentChartMemoryResource()
+{
+	return t_chartMemoryResource != nullptr ? t_chartMemoryResource : std::pmr::new_delete_resource();
+}
+
+kson::ScopedChartMemoryResource::ScopedChartMemoryResource(std::pmr::memory_resource* resource)
+	: m_prevResource(t_chartMemoryResource)
+{
+	t_chartMemoryResource = resource;
+}
+
+kson::ScopedChartMemoryResource::~ScopedChartMemoryResource()
+{
+	t_chartMemoryResource = m_prevResource;
+}
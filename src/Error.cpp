@@ -18,6 +18,8 @@ const char *kson::GetErrorString(kson::ErrorType errorType)
 		return "Chart format error";
 	case kson::ErrorType::KsonParseError:
 		return "KSON parse error";
+	case kson::ErrorType::KsonBinParseError:
+		return "kson-bin parse error";
 	case kson::ErrorType::EncodingError:
 		return "Encoding error";
 	default:
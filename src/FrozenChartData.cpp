@@ -0,0 +1,44 @@
+#include "kson/FrozenChartData.hpp"
+
+namespace
+{
+	using namespace kson;
+
+	template <typename FlatT, typename T, std::size_t N>
+	std::array<FlatByPulse<FlatT>, N> FreezeLanes(const std::array<ByPulse<T>, N>& lanes)
+	{
+		std::array<FlatByPulse<FlatT>, N> frozenLanes;
+		for (std::size_t i = 0; i < N; ++i)
+		{
+			frozenLanes[i] = FlatByPulse<FlatT>(lanes[i]);
+		}
+		return frozenLanes;
+	}
+}
+
+namespace kson
+{
+	FrozenChartData CreateFrozenChartData(const ChartData& chartData)
+	{
+		FrozenChartData frozen;
+
+		frozen.beat.bpm = FlatByPulse<double>(chartData.beat.bpm);
+		frozen.beat.timeSig = FlatByMeasureIdx<TimeSig>(chartData.beat.timeSig);
+		frozen.beat.scrollSpeed = FlatGraph(chartData.beat.scrollSpeed);
+		frozen.beat.stop = FlatByPulse<RelPulse>(chartData.beat.stop);
+
+		frozen.note.bt = FreezeLanes<Interval>(chartData.note.bt);
+		frozen.note.fx = FreezeLanes<Interval>(chartData.note.fx);
+		frozen.note.laser = FreezeLanes<FlatLaserSection>(chartData.note.laser);
+
+		const auto& body = chartData.camera.cam.body;
+		frozen.camera.cam.zoomBottom = FlatGraph(body.zoomBottom);
+		frozen.camera.cam.zoomSide = FlatGraph(body.zoomSide);
+		frozen.camera.cam.zoomTop = FlatGraph(body.zoomTop);
+		frozen.camera.cam.rotationDeg = FlatGraph(body.rotationDeg);
+		frozen.camera.cam.centerSplit = FlatGraph(body.centerSplit);
+		frozen.camera.tilt = FlatByPulse<TiltValue>(chartData.camera.tilt);
+
+		return frozen;
+	}
+}
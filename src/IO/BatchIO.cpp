@@ -0,0 +1,199 @@
+#include "kson/IO/KshIO.hpp"
+#include "kson/IO/KsonIO.hpp"
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+namespace
+{
+	using namespace kson;
+
+	std::filesystem::path U8Path(const std::string& utf8Str)
+	{
+		return std::filesystem::path(
+			std::u8string_view(reinterpret_cast<const char8_t*>(utf8Str.data()), utf8Str.size()));
+	}
+
+	std::size_t ResolveNumThreads(std::size_t numThreads, std::size_t numTasks)
+	{
+		if (numThreads == 0)
+		{
+			numThreads = std::max(std::size_t{ 1 }, static_cast<std::size_t>(std::thread::hardware_concurrency()));
+		}
+		return std::max(std::size_t{ 1 }, std::min(numThreads, numTasks));
+	}
+
+	// Returns task indices sorted by file size in descending order
+	// Note: Starting from larger files avoids a single large chart being left to the end and keeping one thread busy alone
+	std::vector<std::size_t> LargestFirstOrder(std::span<const std::string> filePaths)
+	{
+		std::vector<std::uintmax_t> fileSizes(filePaths.size());
+		for (std::size_t i = 0; i < filePaths.size(); ++i)
+		{
+			std::error_code ec;
+			const std::uintmax_t fileSize = std::filesystem::file_size(U8Path(filePaths[i]), ec);
+			fileSizes[i] = ec ? 0 : fileSize;
+		}
+
+		std::vector<std::size_t> order(filePaths.size());
+		std::iota(order.begin(), order.end(), std::size_t{ 0 });
+		std::stable_sort(order.begin(), order.end(), [&fileSizes](std::size_t a, std::size_t b) { return fileSizes[a] > fileSizes[b]; });
+		return order;
+	}
+
+	// Runs func(i) for each task index on the worker threads
+	// Note: Each worker takes the next task from a shared atomic cursor when it finishes the previous one,
+	//       so a worker that got small charts keeps taking the remaining work instead of waiting for the others.
+	//       If func throws or a thread cannot be started, no more tasks are started and the first exception is rethrown after all workers finish.
+	template <typename Func>
+	void RunBatch(std::span<const std::string> filePaths, std::size_t numThreads, Func func)
+	{
+		const std::vector<std::size_t> order = LargestFirstOrder(filePaths);
+		std::atomic<std::size_t> cursor{ 0 };
+
+		std::mutex exceptionMutex;
+		std::exception_ptr firstException;
+		const auto stopWithCurrentException = [&]
+		{
+			{
+				std::lock_guard lock(exceptionMutex);
+				if (!firstException)
+				{
+					firstException = std::current_exception();
+				}
+			}
+			cursor.store(order.size(), std::memory_order_relaxed);
+		};
+
+		const auto worker = [&]
+		{
+			std::size_t orderIdx;
+			while ((orderIdx = cursor.fetch_add(1, std::memory_order_relaxed)) < order.size())
+			{
+				try
+				{
+					func(order[orderIdx]);
+				}
+				catch (...)
+				{
+					// Exceptions must not escape from worker threads
+					stopWithCurrentException();
+				}
+			}
+		};
+
+		numThreads = ResolveNumThreads(numThreads, filePaths.size());
+
+		std::vector<std::thread> threads;
+		if (numThreads > 1)
+		{
+			try
+			{
+				threads.reserve(numThreads - 1);
+				for (std::size_t i = 0; i + 1 < numThreads; ++i)
+				{
+					threads.emplace_back(worker);
+				}
+			}
+			catch (...)
+			{
+				stopWithCurrentException();
+			}
+		}
+
+		worker(); // The calling thread also works
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		if (firstException)
+		{
+			std::rethrow_exception(firstException);
+		}
+	}
+
+	template <typename DiagType, typename LoadFunc>
+	void LoadChartDataBatchImpl(std::span<const std::string> filePaths, std::size_t numThreads, const std::function<void(std::size_t, ChartData&&, DiagType&&)>& sink, LoadFunc loadFunc)
+	{
+		RunBatch(filePaths, numThreads, [&](std::size_t i)
+		{
+			DiagType diag;
+			ChartData chartData;
+			try
+			{
+				chartData = loadFunc(filePaths[i], &diag);
+			}
+			catch (...)
+			{
+				// Exceptions must not escape from worker threads
+				chartData = ChartData();
+				chartData.error = ErrorType::UnknownError;
+			}
+
+			// Note: The chart is handed over as soon as it is loaded, so the worker does not keep it alive
+			sink(i, std::move(chartData), std::move(diag));
+		});
+	}
+
+	// Collects the results passed to the sink into a vector
+	template <typename DiagType, typename LoadBatchFunc>
+	std::vector<ChartData> CollectChartDataBatch(std::size_t numFiles, std::vector<DiagType>* pDiags, LoadBatchFunc loadBatch)
+	{
+		std::vector<ChartData> results(numFiles);
+		if (pDiags)
+		{
+			pDiags->assign(numFiles, DiagType{});
+		}
+
+		loadBatch([&results, pDiags](std::size_t i, ChartData&& chartData, DiagType&& diag)
+		{
+			// Note: Each index is written by exactly one worker, so no lock is needed
+			results[i] = std::move(chartData);
+			if (pDiags)
+			{
+				(*pDiags)[i] = std::move(diag);
+			}
+		});
+
+		return results;
+	}
+}
+
+void kson::LoadKshChartDataBatch(std::span<const std::string> filePaths, std::size_t numThreads, const std::function<void(std::size_t, ChartData&&, KshLoadingDiag&&)>& sink)
+{
+	LoadChartDataBatchImpl(filePaths, numThreads, sink, [](const std::string& filePath, KshLoadingDiag* pKshDiag)
+	{
+		return LoadKshChartData(filePath, pKshDiag);
+	});
+}
+
+std::vector<ChartData> kson::LoadKshChartDataBatch(std::span<const std::string> filePaths, std::size_t numThreads, std::vector<KshLoadingDiag>* pKshDiags)
+{
+	return CollectChartDataBatch<KshLoadingDiag>(filePaths.size(), pKshDiags, [&](const auto& sink)
+	{
+		LoadKshChartDataBatch(filePaths, numThreads, sink);
+	});
+}
+
+#ifndef KSON_WITHOUT_JSON_DEPENDENCY
+void kson::LoadKsonChartDataBatch(std::span<const std::string> filePaths, std::size_t numThreads, const std::function<void(std::size_t, ChartData&&, KsonLoadingDiag&&)>& sink)
+{
+	LoadChartDataBatchImpl(filePaths, numThreads, sink, [](const std::string& filePath, KsonLoadingDiag* pKsonDiag)
+	{
+		return LoadKsonChartData(filePath, pKsonDiag);
+	});
+}
+
+std::vector<ChartData> kson::LoadKsonChartDataBatch(std::span<const std::string> filePaths, std::size_t numThreads, std::vector<KsonLoadingDiag>* pKsonDiags)
+{
+	return CollectChartDataBatch<KsonLoadingDiag>(filePaths.size(), pKsonDiags, [&](const auto& sink)
+	{
+		LoadKsonChartDataBatch(filePaths, numThreads, sink);
+	});
+}
+#endif
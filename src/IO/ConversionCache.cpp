@@ -0,0 +1,186 @@
+#include "kson/IO/ConversionCache.hpp"
+#include "kson/IO/KshIO.hpp"
+#include "kson/IO/KsonBinIO.hpp"
+#include "kson/IO/KsonIO.hpp"
+#include "kson/Util/HashUtils.hpp"
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#ifndef KSON_VERSION_FULL
+#error "KSON_VERSION_FULL must be defined by the build system"
+#endif
+
+namespace
+{
+	using namespace kson;
+
+	constexpr std::string_view kLibraryVersion = KSON_VERSION_FULL;
+
+	std::filesystem::path U8Path(const std::string& utf8Str)
+	{
+		return std::filesystem::path(
+			std::u8string_view(reinterpret_cast<const char8_t*>(utf8Str.data()), utf8Str.size()));
+	}
+
+	std::string PathToU8String(const std::filesystem::path& path)
+	{
+		const std::u8string u8Str = path.u8string();
+		return std::string(reinterpret_cast<const char*>(u8Str.data()), u8Str.size());
+	}
+
+	template <typename T>
+	std::uint64_t HashValue(const T& value, std::uint64_t seed)
+	{
+		return Hash64(std::span<const char>(reinterpret_cast<const char*>(&value), sizeof(value)), seed);
+	}
+
+	std::string ToHexString(std::uint64_t value)
+	{
+		char buf[17];
+		std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(value));
+		return buf;
+	}
+
+	// Returns a file name unique among the threads and processes writing to the same directory
+	std::string TemporaryFileName(const std::filesystem::path& targetPath)
+	{
+		static const std::uint64_t s_processSalt = []
+			{
+				std::random_device rd;
+				return (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+			}();
+		static std::atomic<std::uint64_t> s_counter{ 0 };
+
+		const std::uint64_t counter = s_counter.fetch_add(1, std::memory_order_relaxed);
+		return PathToU8String(targetPath.filename()) + ".tmp" + ToHexString(s_processSalt) + "_" + std::to_string(counter);
+	}
+
+	std::optional<std::string> ReadAllFromFile(const std::filesystem::path& fsPath)
+	{
+		std::ifstream ifs(fsPath, std::ios_base::binary);
+		if (!ifs.good())
+		{
+			return std::nullopt;
+		}
+		std::string content(std::istreambuf_iterator<char>(ifs), {});
+		if (ifs.bad())
+		{
+			return std::nullopt;
+		}
+		return content;
+	}
+}
+
+kson::ConversionCache::ConversionCache(const std::string& dirPath, std::string_view versionKey)
+	: m_dirPath(dirPath)
+	, m_versionHash(HashValue(kKsonBinFormatVersion, HashValue(kKsonFormatVersion, Hash64(versionKey, Hash64(kLibraryVersion)))))
+{
+}
+
+std::string kson::ConversionCache::keyOf(std::span<const char> input, ConversionCacheFormat format) const
+{
+	const std::string hash = ToHexString(Hash64(input, m_versionHash));
+	const char* extension = format == ConversionCacheFormat::kKsonBin ? ".ksonbin" : ".kson";
+	return hash.substr(0, 2) + "/" + hash + "_" + std::to_string(input.size()) + extension;
+}
+
+std::string kson::ConversionCache::filePathOf(const std::string& key) const
+{
+	return PathToU8String(U8Path(m_dirPath) / U8Path(key));
+}
+
+std::optional<std::string> kson::ConversionCache::load(const std::string& key) const
+{
+	return ReadAllFromFile(U8Path(filePathOf(key)));
+}
+
+kson::ErrorType kson::ConversionCache::store(const std::string& key, std::string_view content) const
+{
+	const std::filesystem::path targetPath = U8Path(filePathOf(key));
+
+	std::error_code ec;
+	std::filesystem::create_directories(targetPath.parent_path(), ec);
+	if (ec)
+	{
+		return ErrorType::CouldNotOpenOutputFileStream;
+	}
+
+	// Note: Readers never see a partially written entry because the entry appears only by the rename below
+	const std::filesystem::path tempPath = targetPath.parent_path() / U8Path(TemporaryFileName(targetPath));
+	{
+		std::ofstream ofs(tempPath, std::ios_base::binary);
+		if (!ofs.good())
+		{
+			return ErrorType::CouldNotOpenOutputFileStream;
+		}
+		ofs.write(content.data(), static_cast<std::streamsize>(content.size()));
+		if (!ofs.good())
+		{
+			ofs.close();
+			std::filesystem::remove(tempPath, ec);
+			return ErrorType::GeneralIOError;
+		}
+	}
+
+	std::filesystem::rename(tempPath, targetPath, ec);
+	if (ec)
+	{
+		// Note: On Windows, the rename fails while another process has the entry open. The entry written by the other writer is kept in that case.
+		std::filesystem::remove(tempPath, ec);
+		return std::filesystem::exists(targetPath, ec) ? ErrorType::None : ErrorType::GeneralIOError;
+	}
+
+	return ErrorType::None;
+}
+
+kson::ChartData kson::LoadKshChartDataWithCache(std::span<const char> buffer, const ConversionCache& cache, KshLoadingDiag* pKshDiag)
+{
+	const std::string key = cache.keyOf(buffer, ConversionCacheFormat::kKsonBin);
+	const std::string cacheFilePath = cache.filePathOf(key);
+
+	std::error_code ec;
+	if (std::filesystem::exists(U8Path(cacheFilePath), ec))
+	{
+		ChartData chartData = LoadKsonBinChartData(cacheFilePath);
+		if (chartData.error == ErrorType::None)
+		{
+			return chartData;
+		}
+		// The entry is broken (e.g., written by a crashed process of an older version), so convert again and overwrite it
+	}
+
+	ChartData chartData = LoadKshChartData(buffer, pKshDiag);
+	if (chartData.error != ErrorType::None)
+	{
+		return chartData;
+	}
+
+	std::ostringstream oss;
+	if (SaveKsonBinChartData(oss, chartData) == ErrorType::None)
+	{
+		[[maybe_unused]] const ErrorType storeError = cache.store(key, oss.view());
+	}
+
+	return chartData;
+}
+
+kson::ChartData kson::LoadKshChartDataWithCache(const std::string& filePath, const ConversionCache& cache, KshLoadingDiag* pKshDiag)
+{
+	const auto fsPath = U8Path(filePath);
+	if (!std::filesystem::exists(fsPath))
+	{
+		return { .error = ErrorType::FileNotFound };
+	}
+
+	const std::optional<std::string> buffer = ReadAllFromFile(fsPath);
+	if (!buffer.has_value())
+	{
+		return { .error = ErrorType::CouldNotOpenInputFileStream };
+	}
+
+	return LoadKshChartDataWithCache(std::span<const char>(buffer->data(), buffer->size()), cache, pKshDiag);
+}
@@ -1,8 +1,10 @@
 #include "kson/IO/KshIO.hpp"
 #include "kson/Encoding/Encoding.hpp"
+#include "kson/Util/NumericUtils.hpp"
 #include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <iterator>
 #include <unordered_set>
 #include <optional>
 #include <charconv>
@@ -22,6 +24,7 @@ namespace
 	constexpr char kBlockSeparator = '|';
 	constexpr std::string_view kMeasureSeparator = "--";
 	constexpr char kAudioEffectStrSeparator = ';';
+	constexpr std::string_view kUTF8BOM = "\xEF\xBB\xBF";
 
 	enum BlockIdx : std::size_t
 	{
@@ -56,52 +59,38 @@ namespace
 	template <typename T>
 	T ParseNumeric(std::string_view str, T defaultValue = T{ 0 })
 	{
-#ifdef _MSC_VER
-		T result{ defaultValue };
-		std::from_chars_result r;
-		if constexpr (std::is_integral_v<T>)
+		// Accept leading whitespaces and '+' for compatibility with std::stoll/std::stod
+		while (!str.empty() && (str.front() == ' ' || ('\t' <= str.front() && str.front() <= '\r')))
 		{
-			r = std::from_chars(str.data(), str.data() + str.size(), result, 10);
+			str.remove_prefix(1);
 		}
-		else
-		{
-			r = std::from_chars(str.data(), str.data() + str.size(), result, std::chars_format::fixed);
-		}
-
-		if (r.ec == std::errc{})
+		if (str.starts_with('+'))
 		{
-			return static_cast<T>(result);
+			str.remove_prefix(1);
 		}
 
-		return defaultValue;
-#else
-		try
+		const char* const first = str.data();
+		const char* const last = str.data() + str.size();
+		if constexpr (std::is_integral_v<T>)
 		{
-			if constexpr (std::is_integral_v<T>)
-			{
-				if constexpr (std::is_unsigned_v<T>)
-				{
-					return static_cast<T>(std::stoull(std::string(str)));
-				}
-				else
-				{
-					return static_cast<T>(std::stoll(std::string(str)));
-				}
-			}
-			else
+			// Note: The value is parsed as 64-bit and then cast to T, which is the same as std::stoll/std::stoull
+			using ParseType = std::conditional_t<std::is_unsigned_v<T>, std::uint64_t, std::int64_t>;
+			ParseType result{};
+			if (std::from_chars(first, last, result, 10).ec == std::errc{})
 			{
-				return static_cast<T>(std::stod(std::string(str)));
+				return static_cast<T>(result);
 			}
 		}
-		catch (const std::out_of_range& e)
-		{
-			return defaultValue;
-		}
-		catch (const std::invalid_argument& e)
+		else
 		{
-			return defaultValue;
+			double result{};
+			if (FromCharsDouble(first, last, result).ec == std::errc{})
+			{
+				return static_cast<T>(result);
+			}
 		}
-#endif
+
+		return defaultValue;
 	}
 
 	template <typename T, typename U>
@@ -374,27 +363,119 @@ namespace
 		};
 	}
 
-	bool EliminateUTF8BOM(std::istream& stream)
+	// Reads lines from a contiguous buffer as std::string_view without copying
+	class KshLineReader
 	{
-		bool isUTF8;
-		char bom[3];
-		stream.read(bom, 3);
-		if (stream.gcount() == 3 &&
-			bom[0] == '\xEF' &&
-			bom[1] == '\xBB' &&
-			bom[2] == '\xBF')
+	private:
+		std::string_view m_buffer;
+
+		std::size_t m_pos = 0;
+
+	public:
+		explicit KshLineReader(std::string_view buffer)
+			: m_buffer(buffer)
 		{
-			isUTF8 = true;
-			// BOM found, stream position is already after BOM
 		}
-		else
+
+		// Skips UTF-8 BOM and returns whether it was found
+		bool eliminateUTF8BOM()
 		{
-			isUTF8 = false;
-			// No BOM or incomplete read, reset to beginning
-			stream.clear();
-			stream.seekg(0, std::ios_base::beg);
+			if (m_pos == 0 && m_buffer.starts_with(kUTF8BOM))
+			{
+				m_pos = kUTF8BOM.size();
+				return true;
+			}
+			return false;
 		}
-		return isUTF8;
+
+		// Same behavior as std::getline with '\n', except that the trailing CR is eliminated
+		bool readLine(std::string_view* pLine)
+		{
+			if (m_pos >= m_buffer.size())
+			{
+				return false;
+			}
+
+			const std::size_t lfIdx = m_buffer.find('\n', m_pos);
+			const std::size_t endIdx = (lfIdx == std::string_view::npos) ? m_buffer.size() : lfIdx;
+			std::string_view line = m_buffer.substr(m_pos, endIdx - m_pos);
+			m_pos = (lfIdx == std::string_view::npos) ? m_buffer.size() : lfIdx + 1;
+
+			// Eliminate CR
+			if (!line.empty() && line.back() == '\r')
+			{
+				line.remove_suffix(1);
+			}
+
+			*pLine = line;
+			return true;
+		}
+
+		[[nodiscard]]
+		char peek() const
+		{
+			return m_pos < m_buffer.size() ? m_buffer[m_pos] : '\0';
+		}
+	};
+
+	// Converts a whole Shift-JIS file into UTF-8 (with BOM) at once, instead of converting each value line by line
+	// Returns false if the buffer is not a valid Shift-JIS string
+	bool TranscodeShiftJISBuffer(std::string_view buffer, std::string* pDst)
+	{
+		pDst->reserve(kUTF8BOM.size() + buffer.size() * 2);
+		pDst->assign(kUTF8BOM);
+		return Encoding::ShiftJISToUTF8(buffer, pDst);
+	}
+
+	// Reads the whole stream into a string
+	std::string ReadAllFromStream(std::istream& stream)
+	{
+		return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	// Reads the lines before the first bar line ("--") from the stream (body lines are not read)
+	std::string ReadHeaderFromStream(std::istream& stream)
+	{
+		std::string header;
+		std::string line;
+		while (std::getline(stream, line, '\n'))
+		{
+			header += line;
+			header += '\n';
+
+			std::string_view lineView = line;
+			if (!lineView.empty() && lineView.back() == '\r')
+			{
+				lineView.remove_suffix(1);
+			}
+			if (lineView == kMeasureSeparator)
+			{
+				break;
+			}
+		}
+		return header;
+	}
+
+	// Reads the whole file into a string with a single read
+	std::optional<std::string> ReadAllFromFile(const std::filesystem::path& fsPath)
+	{
+		std::ifstream ifs(fsPath, std::ios_base::binary);
+		if (!ifs.good())
+		{
+			return std::nullopt;
+		}
+
+		std::error_code ec;
+		const auto fileSize = std::filesystem::file_size(fsPath, ec);
+		if (ec)
+		{
+			return ReadAllFromStream(ifs);
+		}
+
+		std::string buffer(static_cast<std::size_t>(fileSize), '\0');
+		ifs.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		buffer.resize(static_cast<std::size_t>(ifs.gcount()));
+		return buffer;
 	}
 
 	double RoundToKshDoubleValue(double value)
@@ -520,7 +601,7 @@ namespace
 	void ApplyBufferedCurvesToTilt(
 		const std::string& paramName,
 		ByPulse<TiltValue>& tilt,
-		const std::unordered_map<std::string, std::map<Pulse, GraphCurveValue>>& bufferedCurves)
+		const std::unordered_map<std::string, ByPulse<GraphCurveValue>>& bufferedCurves)
 	{
 		if (!bufferedCurves.contains(paramName))
 		{
@@ -551,15 +632,32 @@ namespace
 			return;
 		}
 
+		// Both the curves and the sections are sorted by pulse, so they are merged in a single sweep
+		// Note: Laser sections in a lane never overlap, so the owning section is the last one starting at or before the curve pulse
+		auto& lane = chartData.note.laser[laneIdx];
+		if (lane.empty())
+		{
+			return;
+		}
+
+		auto sectionIt = lane.begin();
 		for (const auto& [pulse, curve] : bufferedCurves.at(paramName))
 		{
-			for (auto& [sectionPulse, section] : chartData.note.laser[laneIdx])
+			if (pulse < sectionIt->first)
 			{
-				const RelPulse relPulse = pulse - sectionPulse;
-				if (relPulse >= 0 && section.v.contains(relPulse))
-				{
-					section.v.at(relPulse).curve = curve;
-				}
+				continue;
+			}
+
+			for (auto nextIt = std::next(sectionIt); nextIt != lane.end() && nextIt->first <= pulse; nextIt = std::next(sectionIt))
+			{
+				sectionIt = nextIt;
+			}
+
+			auto& [sectionPulse, section] = *sectionIt;
+			const auto pointIt = section.v.find(pulse - sectionPulse);
+			if (pointIt != section.v.end())
+			{
+				pointIt->second.curve = curve;
 			}
 		}
 	}
@@ -1250,25 +1348,20 @@ namespace
 	};
 
 	template <typename ChartDataType>
-	ChartDataType CreateChartDataFromMetaDataStream(std::istream& stream, bool* pIsUTF8, KshLoadingDiag* pKshDiag = nullptr, std::int64_t* pFileLineNo = nullptr)
+	ChartDataType CreateChartDataFromMetaData(KshLineReader& reader, bool* pIsUTF8, KshLoadingDiag* pKshDiag = nullptr, std::int64_t* pFileLineNo = nullptr)
 #ifdef __cpp_concepts
 		requires std::is_same_v<ChartDataType, kson::ChartData> || std::is_same_v<ChartDataType, kson::MetaChartData>
 #endif
 	{
-		if (!stream.good())
-		{
-			return { .error = ErrorType::GeneralIOError };
-		}
-
 		ChartDataType chartData;
-		const bool isUTF8 = EliminateUTF8BOM(stream);
+		const bool isUTF8 = reader.eliminateUTF8BOM();
 		if (pIsUTF8)
 		{
 			*pIsUTF8 = isUTF8;
 		}
 
 		// First option line must be "title="
-		if (stream.peek() != 't')
+		if (reader.peek() != 't')
 		{
 			if (pKshDiag)
 			{
@@ -1285,17 +1378,11 @@ namespace
 		[[maybe_unused]] bool barLineExists = false;
 		std::unordered_map<std::string, std::string> metaDataHashMap;
 		std::int64_t headerLineNo = 0;
-		std::string line;
-		while (std::getline(stream, line, '\n'))
+		std::string_view line;
+		while (reader.readLine(&line))
 		{
 			++headerLineNo;
 
-			// Eliminate CR
-			if (!line.empty() && *line.crbegin() == '\r')
-			{
-				line.pop_back();
-			}
-
 			if (IsBarLine(line))
 			{
 				// Chart meta data is before the first bar line ("--")
@@ -1308,7 +1395,7 @@ namespace
 			{
 				if constexpr (std::is_same_v<ChartDataType, ChartData>)
 				{
-					std::string commentText = line.substr(2); // 2 = strlen("//")
+					std::string commentText(line.substr(2)); // 2 = strlen("//")
 					std::size_t pos = 0;
 					while ((pos = commentText.find("\\n", pos)) != std::string::npos)
 					{
@@ -1502,9 +1589,254 @@ namespace
 		return chartData;
 	}
 
+	// Header keys decoded by KshMetaScanner (the other keys are skipped without decoding)
+	enum MetaScanKeyIdx : std::size_t
+	{
+		kMetaScanKeyTitle = 0,
+		kMetaScanKeyArtist,
+		kMetaScanKeyDifficulty,
+		kMetaScanKeyLevel,
+		kMetaScanKeyBPM,
+		kMetaScanKeyStdBPM,
+		kMetaScanKeyJacket,
+		kMetaScanKeyBGM,
+		kMetaScanKeyBGMVol,
+		kMetaScanKeyPreviewOffset,
+		kMetaScanKeyPreviewDuration,
+		kMetaScanKeyVer,
+		kMetaScanKeyVerCompat,
+
+		kNumMetaScanKeys,
+	};
+
+	constexpr std::array<std::string_view, kNumMetaScanKeys> kMetaScanKeys
+	{
+		"title",
+		"artist",
+		"difficulty",
+		"level",
+		"t",
+		"to",
+		"jacket",
+		"m",
+		"mvol",
+		"po",
+		"plength",
+		"ver",
+		"ver_compat",
+	};
+
+	constexpr std::size_t kMetaScanChunkSize = 512; // Note: Typical KSH headers are a few hundred bytes
+
+	// Scans KSH header lines one by one and decodes only the whitelisted keys
+	class KshMetaScanner
+	{
+	private:
+		bool m_isFirstLine = true;
+
+		bool m_isUTF8 = false;
+
+		bool m_barLineFound = false;
+
+		bool m_encodingError = false;
+
+		std::array<std::optional<std::string>, kNumMetaScanKeys> m_values;
+
+		[[nodiscard]]
+		std::string_view valueOr(MetaScanKeyIdx idx, std::string_view defaultValue) const
+		{
+			return m_values[idx].has_value() ? std::string_view(*m_values[idx]) : defaultValue;
+		}
+
+		[[nodiscard]]
+		std::int32_t intValueOr(MetaScanKeyIdx idx, std::int32_t defaultValue) const
+		{
+			const std::string_view str = valueOr(idx, "");
+			if (str.empty())
+			{
+				return defaultValue;
+			}
+			return ParseNumeric<std::int32_t>(str);
+		}
+
+	public:
+		// Returns false if scanning should stop (the first bar line is found or an encoding error occurred)
+		bool feedLine(std::string_view line)
+		{
+			if (m_isFirstLine)
+			{
+				m_isFirstLine = false;
+				if (line.starts_with(kUTF8BOM))
+				{
+					m_isUTF8 = true;
+					line.remove_prefix(kUTF8BOM.size());
+				}
+			}
+
+			// Eliminate CR
+			if (!line.empty() && line.back() == '\r')
+			{
+				line.remove_suffix(1);
+			}
+
+			if (IsBarLine(line))
+			{
+				m_barLineFound = true;
+				return false;
+			}
+
+			if (IsCommentLine(line) || !IsOptionLine(line))
+			{
+				return true;
+			}
+
+			// Note: Keys are compared before decoding since '=' never appears in Shift-JIS multibyte characters
+			const std::size_t equalIdx = line.find(kOptionSeparator);
+			const auto itr = std::find(kMetaScanKeys.begin(), kMetaScanKeys.end(), line.substr(0, equalIdx));
+			if (itr == kMetaScanKeys.end())
+			{
+				return true;
+			}
+
+			const std::string_view value = line.substr(equalIdx + 1);
+			std::string valueUTF8 = ToUTF8(value, m_isUTF8);
+			if (!value.empty() && valueUTF8.empty())
+			{
+				m_encodingError = true;
+				return false;
+			}
+			m_values[static_cast<std::size_t>(itr - kMetaScanKeys.begin())] = std::move(valueUTF8);
+
+			return true;
+		}
+
+		[[nodiscard]]
+		MetaChartData result() const
+		{
+			if (m_encodingError)
+			{
+				return { .error = ErrorType::EncodingError };
+			}
+
+			// .ksh files must have at least one bar line ("--") and "title=" line
+			if (!m_barLineFound || !m_values[kMetaScanKeyTitle].has_value())
+			{
+				return { .error = ErrorType::GeneralChartFormatError };
+			}
+
+			// Note: The conversion below must be consistent with CreateChartDataFromMetaData
+			MetaChartData chartData;
+			chartData.meta.title = *m_values[kMetaScanKeyTitle];
+			chartData.meta.artist = valueOr(kMetaScanKeyArtist, "");
+			chartData.meta.jacketFilename = valueOr(kMetaScanKeyJacket, "");
+
+			const std::string_view difficultyName = valueOr(kMetaScanKeyDifficulty, "infinite");
+			if (s_difficultyNameTable.contains(difficultyName))
+			{
+				chartData.meta.difficulty.idx = s_difficultyNameTable.at(difficultyName);
+			}
+			else
+			{
+				chartData.meta.difficulty.idx = 3; // Unknown difficulty is recognized as "infinite" (=3)
+				chartData.meta.difficulty.name = difficultyName;
+			}
+
+			chartData.meta.level = std::clamp(intValueOr(kMetaScanKeyLevel, 1), 1, 20);
+			chartData.meta.dispBPM = valueOr(kMetaScanKeyBPM, "");
+			chartData.meta.stdBPM = ParseNumeric<double>(valueOr(kMetaScanKeyStdBPM, "0"), 0.0);
+
+			const std::string_view kshVersionCompat = valueOr(kMetaScanKeyVerCompat, "");
+			const std::int32_t kshVersionInt = ParseNumeric<std::int32_t>(kshVersionCompat.empty() ? valueOr(kMetaScanKeyVer, "100") : kshVersionCompat, 100);
+
+			chartData.audio.bgm.filename = Split<1>(valueOr(kMetaScanKeyBGM, ""), ';')[0];
+			chartData.audio.bgm.vol = intValueOr(kMetaScanKeyBGMVol, 100) / 100.0;
+			if (kshVersionInt == 100)
+			{
+				// For historical reasons, if the KSH format version is "100" (including unspecified), the volume is multiplied by 0.6.
+				chartData.audio.bgm.vol *= 0.6;
+			}
+			chartData.audio.bgm.preview.offset = intValueOr(kMetaScanKeyPreviewOffset, 0);
+			chartData.audio.bgm.preview.duration = intValueOr(kMetaScanKeyPreviewDuration, 0);
+
+			return chartData;
+		}
+	};
+
+	// Returns whether the option line in the chart body is used by the sections selected by options
+	bool IsOptionLineLoaded(std::string_view key, const ChartLoadingOptions& options)
+	{
+		if (key.ends_with("_curve"))
+		{
+			key.remove_suffix(6); // 6 = strlen("_curve")
+		}
+
+		if (key == "t" || key == "stop" || key == "scroll_speed")
+		{
+			return options.beat;
+		}
+		if (key == "laser_l" || key == "laser_r" || key == "laserrange_l" || key == "laserrange_r" || key == "fx-l_se" || key == "fx-r_se" || key == "chokkakuse")
+		{
+			return options.note;
+		}
+		if (key == "zoom_top" || key == "zoom_bottom" || key == "zoom_side" || key == "center_split" || key == "rotation_deg" || key == "tilt")
+		{
+			return options.camera;
+		}
+		if (key == "fx-l" || key == "fx-r" || key == "fx-l_param1" || key == "fx-r_param1")
+		{
+			return options.note && options.audioEffect;
+		}
+		if (key == "pfiltergain" || key == "filtertype" || key.starts_with("fx:") || key.starts_with("filter:"))
+		{
+			return options.audioEffect;
+		}
+		if (key == "chokkakuvol")
+		{
+			return true;
+		}
+
+		// Unrecognized option lines are stored in compat.ksh_unknown.option
+		return options.compat;
+	}
+
+	// Resets the sections not selected by options
+	// Note: Sections that come from the header (e.g., bg, compat) are also reset here because they are read before options are checked
+	void ResetUnloadedSections(ChartData& chartData, const ChartLoadingOptions& options)
+	{
+		if (!options.beat)
+		{
+			chartData.beat = BeatInfo{};
+		}
+		if (!options.note)
+		{
+			chartData.note = NoteInfo{};
+		}
+		if (!options.camera)
+		{
+			chartData.camera = CameraInfo{};
+		}
+		if (!options.audioEffect)
+		{
+			chartData.audio.audioEffect = AudioEffectInfo{};
+		}
+		if (!options.bg)
+		{
+			chartData.bg = BGInfo{};
+		}
+		if (!options.editor)
+		{
+			chartData.editor = EditorInfo{};
+		}
+		if (!options.compat)
+		{
+			chartData.compat = CompatInfo{};
+		}
+	}
+
 	void ParseKshChartBody(
-		std::istream& stream,
+		KshLineReader& reader,
 		ChartData* pChartData,
+		const ChartLoadingOptions& options,
 		KshLoadingDiag* pKshDiag,
 		bool isUTF8,
 		std::int64_t* pFileLineNo)
@@ -1536,7 +1868,7 @@ namespace
 
 		// Buffers
 		// (needed because actual addition cannot come before the pulse value calculation)
-		std::vector<std::string> chartLines;
+		std::vector<std::string_view> chartLines; // Note: Views into the source buffer
 		std::vector<BufOptionLine> optionLines;
 		std::vector<BufCommentLine> commentLines;
 		std::vector<BufUnknownLine> unknownLines;
@@ -1553,24 +1885,22 @@ namespace
 		std::array<std::unordered_map<std::size_t, BufKeySound>, kNumFXLanesSZ> currentMeasureFXKeySounds; // "fx-l_se=" or "fx-r_se=" in KSH
 		std::unordered_map<std::size_t, std::string> currentMeasureLaserKeySounds; // "chokkakuse=" in KSH
 
+		// Name lookup for "#define_fx"/"#define_filter" (synced before use because filter types can append laser definitions)
+		AudioEffectDefIndex fxDefIndex(chartData.audio.audioEffect.fx.def);
+		AudioEffectDefIndex laserDefIndex(chartData.audio.audioEffect.laser.def);
+
 		Pulse currentPulse = 0;
 		std::int64_t currentMeasureIdx = 0;
 
 		bool useLegacyScaleForManualTilt = false;
 
 		// Read chart body
-		// The stream start from the next of the first bar line ("--")
-		std::string line;
-		while (std::getline(stream, line, '\n'))
+		// The reader starts from the next of the first bar line ("--")
+		std::string_view line;
+		while (reader.readLine(&line))
 		{
 			++fileLineNo;
 
-			// Eliminate CR
-			if (!line.empty() && *line.crbegin() == '\r')
-			{
-				line.pop_back();
-			}
-
 			// Skip empty lines
 			if (line.empty())
 			{
@@ -1580,7 +1910,12 @@ namespace
 			// Comments
 			if (IsCommentLine(line))
 			{
-				std::string commentText = line.substr(2); // 2 = strlen("//")
+				if (!options.editor)
+				{
+					continue;
+				}
+
+				std::string commentText(line.substr(2)); // 2 = strlen("//")
 				std::size_t pos = 0;
 				while ((pos = commentText.find("\\n", pos)) != std::string::npos)
 				{
@@ -1597,6 +1932,11 @@ namespace
 			// User-defined audio effects
 			if (line[0] == '#')
 			{
+				if (!options.audioEffect)
+				{
+					continue;
+				}
+
 				const bool isDefineFX = line.starts_with("#define_fx ");
 				const bool isDefineFilter = !isDefineFX && line.starts_with("#define_filter ");
 				if (isDefineFX || isDefineFilter)
@@ -1717,9 +2057,10 @@ namespace
 					}
 
 					auto& def = isDefineFX ? chartData.audio.audioEffect.fx.def : chartData.audio.audioEffect.laser.def;
-					auto existingIt = std::find_if(def.begin(), def.end(),
-						[&name](const auto& kvp) { return kvp.name == name; });
-					if (existingIt != def.end())
+					AudioEffectDefIndex& defIndex = isDefineFX ? fxDefIndex : laserDefIndex;
+					defIndex.sync();
+					const std::size_t existingIdx = defIndex.indexOf(name);
+					if (existingIdx != AudioEffectDefIndex::npos)
 					{
 						pKshDiag->warnings.push_back({
 							.type = KshLoadingWarningType::AudioEffectDuplicateName,
@@ -1727,7 +2068,7 @@ namespace
 							.message = "Duplicate audio effect definition '" + name + "' found. The later definition will be used.",
 							.lineNo = fileLineNo,
 						});
-						existingIt->v = AudioEffectDef{
+						def[existingIdx].v = AudioEffectDef{
 							.type = s_audioEffectTypeTable.at(type),
 							.v = std::move(paramsKson),
 						};
@@ -1768,7 +2109,7 @@ namespace
 					currentTimeSig = ParseTimeSig(value);
 					chartData.beat.timeSig.insert_or_assign(currentMeasureIdx, currentTimeSig);
 				}
-				else
+				else if (IsOptionLineLoaded(key, options))
 				{
 					optionLines.push_back({
 						.lineIdx = chartLines.size(),
@@ -2018,7 +2359,10 @@ namespace
 					}
 
 					// Add notes
-					for (std::size_t i = 0; i < bufLineCount; ++i)
+					// Note: Lane spins are in the laser block but belong to camera
+					const bool loadNote = options.note;
+					const bool loadLaneSpin = options.camera;
+					for (std::size_t i = 0; i < bufLineCount && (loadNote || loadLaneSpin); ++i)
 					{
 						const std::string_view buf = chartLines.at(i);
 						std::size_t currentBlock = 0;
@@ -2035,6 +2379,12 @@ namespace
 								continue;
 							}
 
+							if (!loadNote && !(currentBlock == kBlockIdxLaser && laneIdx == kNumLaserLanesSZ))
+							{
+								++laneIdx;
+								continue;
+							}
+
 							if (currentBlock == kBlockIdxBT && laneIdx < kNumBTLanesSZ) // BT notes
 							{
 								auto& preparedLongNoteRef = preparedLongNoteArray.bt[laneIdx];
@@ -2141,7 +2491,7 @@ namespace
 									break;
 								}
 							}
-							else if (currentBlock == kBlockIdxLaser && laneIdx == kNumLaserLanesSZ) // Lane spin
+							else if (currentBlock == kBlockIdxLaser && laneIdx == kNumLaserLanesSZ && loadLaneSpin) // Lane spin
 							{
 								// Create a lane spin from string
 								const PreparedLaneSpin laneSpin = PreparedLaneSpin::FromKshSpinStr(buf.substr(j));
@@ -2232,9 +2582,13 @@ namespace
 			}
 
 			// Insert unrecognized line
+			if (!options.compat)
+			{
+				continue;
+			}
 			unknownLines.push_back({
 				.lineIdx = chartLines.size(),
-				.value = line,
+				.value = std::string(line),
 			});
 		}
 
@@ -2305,13 +2659,14 @@ namespace
 		}
 
 		// Convert FX parameters
+		fxDefIndex.sync();
 		for (auto& [audioEffectName, lanes] : chartData.audio.audioEffect.fx.longEvent)
 		{
 			AudioEffectType type = AudioEffectType::Unspecified;
-			if (chartData.audio.audioEffect.fx.defContains(audioEffectName))
+			if (const AudioEffectDef* pDef = fxDefIndex.find(audioEffectName))
 			{
 				// User-defined audio effects
-				type = chartData.audio.audioEffect.fx.defByName(audioEffectName).type;
+				type = pDef->type;
 			}
 			else
 			{
@@ -2454,6 +2809,8 @@ namespace
 			}
 		}
 
+		ResetUnloadedSections(chartData, options);
+
 		// Add default values at zero if not present
 		if (!chartData.camera.tilt.contains(0))
 		{
@@ -2503,9 +2860,21 @@ std::vector<std::string> kson::KshLoadingDiag::editorWarnings() const
 	return result;
 }
 
+MetaChartData kson::LoadKshMetaChartData(std::span<const char> buffer)
+{
+	KshLineReader reader(std::string_view(buffer.data(), buffer.size()));
+	return CreateChartDataFromMetaData<MetaChartData>(reader, nullptr);
+}
+
 MetaChartData kson::LoadKshMetaChartData(std::istream& stream)
 {
-	return CreateChartDataFromMetaDataStream<MetaChartData>(stream, nullptr);
+	if (!stream.good())
+	{
+		return { .error = ErrorType::GeneralIOError };
+	}
+
+	const std::string header = ReadHeaderFromStream(stream);
+	return LoadKshMetaChartData(std::span<const char>(header.data(), header.size()));
 }
 
 MetaChartData kson::LoadKshMetaChartData(const std::string& filePath)
@@ -2525,8 +2894,91 @@ MetaChartData kson::LoadKshMetaChartData(const std::string& filePath)
 	return LoadKshMetaChartData(ifs);
 }
 
+MetaChartData kson::ScanKshMetaChartData(std::span<const char> buffer, std::size_t maxBytes)
+{
+	std::string_view bufferView(buffer.data(), buffer.size());
+	if (bufferView.size() > maxBytes)
+	{
+		// Drop the incomplete last line so that it is not mistaken for a bar line
+		bufferView = bufferView.substr(0, maxBytes);
+		bufferView = bufferView.substr(0, bufferView.find_last_of('\n') + 1);
+	}
+
+	KshMetaScanner scanner;
+	KshLineReader reader(bufferView);
+	std::string_view line;
+	while (reader.readLine(&line) && scanner.feedLine(line))
+	{
+	}
+	return scanner.result();
+}
 
-kson::ChartData kson::LoadKshChartData(std::istream& stream, KshLoadingDiag* pKshDiag)
+MetaChartData kson::ScanKshMetaChartData(std::istream& stream, std::size_t maxBytes)
+{
+	if (!stream.good())
+	{
+		return { .error = ErrorType::GeneralIOError };
+	}
+
+	// Read the stream by small chunks until the first bar line ("--") is found
+	KshMetaScanner scanner;
+	std::string buffer;
+	std::size_t lineStartIdx = 0;
+	while (buffer.size() < maxBytes)
+	{
+		const std::size_t prevSize = buffer.size();
+		const std::size_t chunkSize = std::min(kMetaScanChunkSize, maxBytes - prevSize);
+		buffer.resize(prevSize + chunkSize);
+		stream.read(buffer.data() + prevSize, static_cast<std::streamsize>(chunkSize));
+		buffer.resize(prevSize + static_cast<std::size_t>(stream.gcount()));
+
+		std::size_t lfIdx;
+		while ((lfIdx = buffer.find('\n', lineStartIdx)) != std::string::npos)
+		{
+			if (!scanner.feedLine(std::string_view(buffer).substr(lineStartIdx, lfIdx - lineStartIdx)))
+			{
+				return scanner.result();
+			}
+			lineStartIdx = lfIdx + 1;
+		}
+
+		if (!stream.good())
+		{
+			// The last line without LF
+			if (lineStartIdx < buffer.size())
+			{
+				scanner.feedLine(std::string_view(buffer).substr(lineStartIdx));
+			}
+			break;
+		}
+	}
+
+	return scanner.result();
+}
+
+MetaChartData kson::ScanKshMetaChartData(const std::string& filePath, std::size_t maxBytes)
+{
+	const auto fsPath = U8Path(filePath);
+	if (!std::filesystem::exists(fsPath))
+	{
+		return { .error = ErrorType::FileNotFound };
+	}
+
+	std::ifstream ifs(fsPath, std::ios_base::binary);
+	if (!ifs.good())
+	{
+		return { .error = ErrorType::CouldNotOpenInputFileStream };
+	}
+
+	return ScanKshMetaChartData(ifs, maxBytes);
+}
+
+kson::ChartData kson::LoadKshChartData(std::span<const char> buffer, KshLoadingDiag* pKshDiag)
+{
+	return LoadKshChartData(buffer, ChartLoadingOptions{}, pKshDiag);
+}
+
+kson::ChartData kson::LoadKshChartData(std::span<const char> buffer, const ChartLoadingOptions& options, KshLoadingDiag* pKshDiag)
 {
 	KshLoadingDiag localDiag;
 	if (!pKshDiag)
@@ -2534,15 +2986,22 @@ kson::ChartData kson::LoadKshChartData(std::istream& stream, KshLoadingDiag* pKs
 		pKshDiag = &localDiag;
 	}
 
-	if (!stream.good())
+	std::string_view source(buffer.data(), buffer.size());
+
+	// Legacy charts without BOM are in Shift-JIS, so convert the whole file once up front
+	// Note: If the file contains invalid Shift-JIS sequences, each value is converted line by line instead
+	std::string transcodedBuffer;
+	if (!source.starts_with(kUTF8BOM) && TranscodeShiftJISBuffer(source, &transcodedBuffer))
 	{
-		return { .error = ErrorType::GeneralIOError };
+		source = transcodedBuffer;
 	}
 
+	KshLineReader reader(source);
+
 	// Load chart meta data
 	bool isUTF8;
 	std::int64_t fileLineNo = 0;
-	ChartData chartData = CreateChartDataFromMetaDataStream<ChartData>(stream, &isUTF8, pKshDiag, &fileLineNo);
+	ChartData chartData = CreateChartDataFromMetaData<ChartData>(reader, &isUTF8, pKshDiag, &fileLineNo);
 	if (chartData.error != ErrorType::None)
 	{
 		return chartData;
@@ -2550,7 +3009,7 @@ kson::ChartData kson::LoadKshChartData(std::istream& stream, KshLoadingDiag* pKs
 
 	try
 	{
-		ParseKshChartBody(stream, &chartData, pKshDiag, isUTF8, &fileLineNo);
+		ParseKshChartBody(reader, &chartData, options, pKshDiag, isUTF8, &fileLineNo);
 	}
 	catch (const std::exception& e)
 	{
@@ -2566,7 +3025,28 @@ kson::ChartData kson::LoadKshChartData(std::istream& stream, KshLoadingDiag* pKs
 	return chartData;
 }
 
+kson::ChartData kson::LoadKshChartData(std::istream& stream, KshLoadingDiag* pKshDiag)
+{
+	return LoadKshChartData(stream, ChartLoadingOptions{}, pKshDiag);
+}
+
+kson::ChartData kson::LoadKshChartData(std::istream& stream, const ChartLoadingOptions& options, KshLoadingDiag* pKshDiag)
+{
+	if (!stream.good())
+	{
+		return { .error = ErrorType::GeneralIOError };
+	}
+
+	const std::string buffer = ReadAllFromStream(stream);
+	return LoadKshChartData(std::span<const char>(buffer.data(), buffer.size()), options, pKshDiag);
+}
+
 ChartData kson::LoadKshChartData(const std::string& filePath, KshLoadingDiag* pKshDiag)
+{
+	return LoadKshChartData(filePath, ChartLoadingOptions{}, pKshDiag);
+}
+
+ChartData kson::LoadKshChartData(const std::string& filePath, const ChartLoadingOptions& options, KshLoadingDiag* pKshDiag)
 {
 	const auto fsPath = U8Path(filePath);
 	if (!std::filesystem::exists(fsPath))
@@ -2574,11 +3054,11 @@ ChartData kson::LoadKshChartData(const std::string& filePath, KshLoadingDiag* pK
 		return { .error = ErrorType::FileNotFound };
 	}
 
-	std::ifstream ifs(fsPath, std::ios_base::binary);
-	if (!ifs.good())
+	const std::optional<std::string> buffer = ReadAllFromFile(fsPath);
+	if (!buffer.has_value())
 	{
 		return { .error = ErrorType::CouldNotOpenInputFileStream };
 	}
 
-	return LoadKshChartData(ifs, pKshDiag);
+	return LoadKshChartData(std::span<const char>(buffer->data(), buffer->size()), options, pKshDiag);
 }
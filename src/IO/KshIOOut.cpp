@@ -8,6 +8,10 @@
 #include <cmath>
 #include <limits>
 #include <set>
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <type_traits>
 
 namespace
 {
@@ -384,12 +388,13 @@ namespace
 		// FX long event parameter loss
 		{
 			const auto& fxInfo = chartData.audio.audioEffect.fx;
+			const AudioEffectDefIndex fxDefIndex(fxInfo.def);
 			for (const auto& [effectName, lanes] : fxInfo.longEvent)
 			{
 				AudioEffectType effectType = AudioEffectType::Unspecified;
-				if (fxInfo.defContains(effectName))
+				if (const AudioEffectDef* pDef = fxDefIndex.find(effectName))
 				{
-					effectType = fxInfo.defByName(effectName).type;
+					effectType = pDef->type;
 				}
 				else
 				{
@@ -451,8 +456,65 @@ namespace
 		}
 	}
 
+	// Contiguous output buffer for KSH text
+	// Note: The whole chart is formatted into this buffer and written to the stream at once,
+	//       instead of calling std::ostream::operator<< for each small piece
+	class KshOutputBuffer
+	{
+	private:
+		std::string m_buffer;
+
+	public:
+		KshOutputBuffer()
+		{
+			m_buffer.reserve(64 * 1024);
+		}
+
+		KshOutputBuffer& operator<<(char c)
+		{
+			m_buffer.push_back(c);
+			return *this;
+		}
+
+		KshOutputBuffer& operator<<(const char* str)
+		{
+			m_buffer.append(str);
+			return *this;
+		}
+
+		KshOutputBuffer& operator<<(std::string_view str)
+		{
+			m_buffer.append(str);
+			return *this;
+		}
+
+		template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, bool>, std::nullptr_t> = nullptr>
+		KshOutputBuffer& operator<<(T value)
+		{
+			char buf[24];
+			const auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+			assert(ec == std::errc{});
+			m_buffer.append(buf, ptr);
+			return *this;
+		}
+
+		// Floating-point values must be formatted explicitly with FormatDouble()
+		KshOutputBuffer& operator<<(double) = delete;
+
+		void write(const char* data, std::size_t size)
+		{
+			m_buffer.append(data, size);
+		}
+
+		[[nodiscard]]
+		std::string_view view() const
+		{
+			return m_buffer;
+		}
+	};
+
 	// Write UTF-8 BOM
-	void WriteBOM(std::ostream& stream)
+	void WriteBOM(KshOutputBuffer& stream)
 	{
 		const unsigned char bom[] = { 0xEF, 0xBB, 0xBF };
 		stream.write(reinterpret_cast<const char*>(bom), sizeof(bom));
@@ -469,20 +531,47 @@ namespace
 	{
 		value = RoundToKshDoubleValue(value);
 
-		std::ostringstream oss;
-		oss << std::fixed << std::setprecision(3) << value;
-		std::string str = oss.str();
+		// Same as std::fixed with std::setprecision(3)
+		char buf[512];
+#if defined(_MSC_VER) || defined(__cpp_lib_to_chars)
+		const auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, 3);
+		std::size_t length = ec == std::errc{} ? static_cast<std::size_t>(ptr - buf) : 0;
+#else
+		const int result = std::snprintf(buf, sizeof(buf), "%.3f", value);
+		std::size_t length = result > 0 ? std::min(static_cast<std::size_t>(result), sizeof(buf) - 1) : 0;
+#endif
 
 		// Remove trailing zeros
-		str.erase(str.find_last_not_of('0') + 1, std::string::npos);
+		if (std::string_view(buf, length).find('.') != std::string_view::npos)
+		{
+			while (length > 0 && buf[length - 1] == '0')
+			{
+				--length;
+			}
+		}
 
 		// Remove trailing decimal point
-		if (!str.empty() && str.back() == '.')
+		if (length > 0 && buf[length - 1] == '.')
 		{
-			str.pop_back();
+			--length;
 		}
 
-		return str;
+		return std::string(buf, length);
+	}
+
+	// Format double value in the same way as std::ostream's default formatting (same as "%g")
+	// Note: Unlike FormatDouble, the value is not rounded to 3 decimal places
+	std::string FormatDoubleGeneral(double value)
+	{
+		char buf[32];
+#if defined(_MSC_VER) || defined(__cpp_lib_to_chars)
+		const auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, 6);
+		const std::size_t length = ec == std::errc{} ? static_cast<std::size_t>(ptr - buf) : 0;
+#else
+		const int result = std::snprintf(buf, sizeof(buf), "%g", value);
+		const std::size_t length = result > 0 ? std::min(static_cast<std::size_t>(result), sizeof(buf) - 1) : 0;
+#endif
+		return std::string(buf, length);
 	}
 
 	// Convert RelPulse to KSH length string
@@ -514,9 +603,28 @@ namespace
 		// FX audio effect state (output only when changed)
 		std::array<std::string, kNumFXLanesSZ> currentFXAudioEffects;
 
-		MeasureExportState()
+		// Name lookup for the FX audio effect definitions
+		AudioEffectDefIndex fxDefIndex;
+
+		// FX long events by pulse (effect name and parameters) for each lane
+		// Note: If multiple effects start at the same pulse, the first one in the name order is used
+		std::array<ByPulse<std::pair<const std::string*, const AudioEffectParams*>>, kNumFXLanesSZ> fxLongEventsByPulse;
+
+		explicit MeasureExportState(const ChartData& chartData)
+			: fxDefIndex(chartData.audio.audioEffect.fx.def)
 		{
 			currentFXAudioEffects.fill("");
+
+			for (const auto& [effectName, lanes] : chartData.audio.audioEffect.fx.longEvent)
+			{
+				for (std::size_t laneIdx = 0; laneIdx < kNumFXLanesSZ; ++laneIdx)
+				{
+					for (const auto& [y, params] : lanes[laneIdx])
+					{
+						fxLongEventsByPulse[laneIdx].emplace(y, std::make_pair(&effectName, &params));
+					}
+				}
+			}
 		}
 	};
 
@@ -732,7 +840,7 @@ namespace
 
 	// Write BPM to header
 	// Returns the header BPM string that was output
-	std::string WriteBPMToHeader(std::ostream& stream, const std::string& dispBPM, const ByPulse<double>& bpmMap, const CompatInfo& compat, KshSavingDiag* pKshSavingDiag)
+	std::string WriteBPMToHeader(KshOutputBuffer& stream, const std::string& dispBPM, const ByPulse<double>& bpmMap, const CompatInfo& compat, KshSavingDiag* pKshSavingDiag)
 	{
 		// If dispBPM is set, use it as-is
 		if (!dispBPM.empty())
@@ -811,7 +919,7 @@ namespace
 	}
 
 	// Write header section
-	void WriteHeader(std::ostream& stream, const ChartData& chartData, std::string* headerBPMStr = nullptr, KshSavingDiag* pKshSavingDiag = nullptr)
+	void WriteHeader(KshOutputBuffer& stream, const ChartData& chartData, std::string* headerBPMStr = nullptr, KshSavingDiag* pKshSavingDiag = nullptr)
 	{
 		const auto& meta = chartData.meta;
 		const auto& audio = chartData.audio;
@@ -1083,14 +1191,57 @@ namespace
 		stream << "--\r\n";
 	}
 
+	// Forward cursor over a BT/FX lane
+	// Note: Pulses must be given in increasing order so that the whole export is linear in the output size
+	class NoteLaneCursor
+	{
+	private:
+		ByPulse<Interval>::const_iterator m_itr;
+
+		ByPulse<Interval>::const_iterator m_end;
+
+		// Max end pulse of the notes starting before the current pulse
+		Pulse m_maxEndPulse = std::numeric_limits<Pulse>::min();
+
+	public:
+		NoteLaneCursor() = default;
+
+		explicit NoteLaneCursor(const ByPulse<Interval>& lane)
+			: m_itr(lane.begin())
+			, m_end(lane.end())
+		{
+		}
+
+		// Returns the note starting at the pulse, or nullptr if there is none
+		const Interval* advance(Pulse pulse)
+		{
+			while (m_itr != m_end && m_itr->first < pulse)
+			{
+				m_maxEndPulse = std::max(m_maxEndPulse, m_itr->first + m_itr->second.length);
+				++m_itr;
+			}
+
+			if (m_itr != m_end && m_itr->first == pulse)
+			{
+				return &m_itr->second;
+			}
+			return nullptr;
+		}
+
+		// Returns whether a long note started before the pulse continues at the pulse (but not at the end)
+		bool isLongNoteContinuing(Pulse pulse) const
+		{
+			return pulse < m_maxEndPulse;
+		}
+	};
+
 	// Get BT char at pulse
-	char GetBTCharAt(const ByPulse<Interval>& lane, Pulse pulse, Pulse)
+	char GetBTCharAt(NoteLaneCursor& cursor, Pulse pulse)
 	{
 		// Check if note starts at this pulse
-		if (lane.contains(pulse))
+		if (const Interval* pInterval = cursor.advance(pulse))
 		{
-			const Interval& interval = lane.at(pulse);
-			if (interval.length == 0)
+			if (pInterval->length == 0)
 			{
 				return '1'; // Chip note
 			}
@@ -1101,28 +1252,21 @@ namespace
 		}
 
 		// Check if note continues at this pulse
-		for (const auto& [startPulse, interval] : lane)
+		if (cursor.isLongNoteContinuing(pulse))
 		{
-			const Pulse endPulse = startPulse + interval.length;
-
-			// Note continues at this pulse (but not at the end)
-			if (pulse > startPulse && pulse < endPulse)
-			{
-				return '2'; // Long note continuation
-			}
+			return '2'; // Long note continuation
 		}
 
 		return '0'; // No note
 	}
 
 	// Get FX char at pulse
-	char GetFXCharAt(const ByPulse<Interval>& lane, Pulse pulse, Pulse)
+	char GetFXCharAt(NoteLaneCursor& cursor, Pulse pulse)
 	{
 		// Check if note starts at this pulse
-		if (lane.contains(pulse))
+		if (const Interval* pInterval = cursor.advance(pulse))
 		{
-			const Interval& interval = lane.at(pulse);
-			if (interval.length == 0)
+			if (pInterval->length == 0)
 			{
 				return '2'; // Chip note (2 in FX lane)
 			}
@@ -1133,15 +1277,9 @@ namespace
 		}
 
 		// Check if note continues at this pulse
-		for (const auto& [startPulse, interval] : lane)
+		if (cursor.isLongNoteContinuing(pulse))
 		{
-			const Pulse endPulse = startPulse + interval.length;
-
-			// Note continues at this pulse (but not at the end)
-			if (pulse > startPulse && pulse < endPulse)
-			{
-				return '1'; // Long note continuation
-			}
+			return '1'; // Long note continuation
 		}
 
 		return '0'; // No note
@@ -1364,22 +1502,135 @@ namespace
 		return segments;
 	}
 
-	// Get laser char at pulse using intermediate representation
-	char GetLaserCharAt(const std::vector<KshLaserSegment>& segments, Pulse pulse, std::int32_t laneIdx, MeasureExportState& state)
+	// Forward cursor over KSH laser segments
+	// Note: Pulses must be given in increasing order. The results are the same as scanning all segments from the beginning.
+	class LaserSegmentCursor
 	{
-		auto& laserState = state.laserStates[laneIdx];
+	private:
+		const std::vector<KshLaserSegment>* m_pSegments = nullptr;
 
-		// Find the segment containing this pulse
-		for (const auto& seg : segments)
+		// Segments before this index end before the current pulse
+		std::size_t m_firstIdx = 0;
+
+		// Whether the scan can stop at the first segment starting after the pulse
+		bool m_isSorted = true;
+
+	public:
+		LaserSegmentCursor() = default;
+
+		explicit LaserSegmentCursor(const std::vector<KshLaserSegment>& segments)
+			: m_pSegments(&segments)
+			, m_isSorted(std::is_sorted(segments.begin(), segments.end(), [](const KshLaserSegment& a, const KshLaserSegment& b) { return a.startPulse < b.startPulse; }))
 		{
-			const Pulse segmentEnd = seg.startPulse + seg.length;
+		}
 
-			// Check if pulse is within this segment
-			if (pulse < seg.startPulse || pulse > segmentEnd)
+		// Returns the first segment containing the pulse (including both ends), or nullptr if there is none
+		const KshLaserSegment* segmentAt(Pulse pulse)
+		{
+			const auto& segments = *m_pSegments;
+			while (m_firstIdx < segments.size() && segments[m_firstIdx].startPulse + segments[m_firstIdx].length < pulse)
 			{
-				continue;
+				++m_firstIdx;
+			}
+
+			for (std::size_t i = m_firstIdx; i < segments.size(); ++i)
+			{
+				const KshLaserSegment& seg = segments[i];
+				if (seg.startPulse > pulse)
+				{
+					if (m_isSorted)
+					{
+						break;
+					}
+					continue;
+				}
+				if (pulse <= seg.startPulse + seg.length)
+				{
+					return &seg;
+				}
 			}
+			return nullptr;
+		}
 
+		// Returns the first segment starting a laser section at the pulse, or nullptr if there is none
+		const KshLaserSegment* sectionStartAt(Pulse pulse)
+		{
+			const auto& segments = *m_pSegments;
+			for (std::size_t i = m_firstIdx; i < segments.size(); ++i)
+			{
+				const KshLaserSegment& seg = segments[i];
+				if (seg.startPulse > pulse && m_isSorted)
+				{
+					break;
+				}
+				if (seg.startPulse == pulse && seg.isSectionStart)
+				{
+					return &seg;
+				}
+			}
+			return nullptr;
+		}
+	};
+
+	// Forward cursor over KSON laser sections
+	// Note: Pulses must be given in increasing order
+	class LaserSectionCursor
+	{
+	private:
+		ByPulse<LaserSection>::const_iterator m_itr;
+
+		ByPulse<LaserSection>::const_iterator m_end;
+
+	public:
+		LaserSectionCursor() = default;
+
+		explicit LaserSectionCursor(const ByPulse<LaserSection>& lane)
+			: m_itr(lane.begin())
+			, m_end(lane.end())
+		{
+		}
+
+		// Returns the first laser point at the pulse, or nullptr if there is none
+		const GraphPoint* pointAt(Pulse pulse)
+		{
+			// Skip sections that end before the pulse
+			while (m_itr != m_end && (m_itr->second.v.empty() || m_itr->first + m_itr->second.v.rbegin()->first < pulse))
+			{
+				++m_itr;
+			}
+
+			for (auto itr = m_itr; itr != m_end && itr->first <= pulse; ++itr)
+			{
+				const auto& [sectionPulse, section] = *itr;
+				const auto pointItr = section.v.find(pulse - sectionPulse);
+				if (pointItr != section.v.end())
+				{
+					return &pointItr->second;
+				}
+			}
+			return nullptr;
+		}
+	};
+
+	// Per-lane cursors used while writing note lines
+	struct NoteLineCursors
+	{
+		std::array<NoteLaneCursor, kNumBTLanes> bt;
+		std::array<NoteLaneCursor, kNumFXLanes> fx;
+		std::array<LaserSegmentCursor, kNumLaserLanes> laserSegment;
+		std::array<LaserSectionCursor, kNumLaserLanes> laserSection;
+	};
+
+	// Get laser char at pulse using intermediate representation
+	char GetLaserCharAt(LaserSegmentCursor& cursor, Pulse pulse, std::int32_t laneIdx, MeasureExportState& state)
+	{
+		auto& laserState = state.laserStates[laneIdx];
+
+		// Find the segment containing this pulse
+		if (const KshLaserSegment* pSeg = cursor.segmentAt(pulse))
+		{
+			const KshLaserSegment& seg = *pSeg;
+			const Pulse segmentEnd = seg.startPulse + seg.length;
 			if (pulse == seg.startPulse)
 			{
 				// Segment start
@@ -1420,7 +1671,7 @@ namespace
 	}
 
 	// Generate KSH audio effect string from KSON long_event parameters
-	std::string GenerateKshAudioEffectString(const ChartData& chartData, const std::string& effectName, const AudioEffectParams& params, bool isFX)
+	std::string GenerateKshAudioEffectString(const AudioEffectDefIndex& defIndex, const std::string& effectName, const AudioEffectParams& params)
 	{
 		std::string result = IsKsonPresetFXEffectName(effectName)
 			? std::string{ KsonPresetFXEffectNameToKsh(effectName) }
@@ -1434,14 +1685,9 @@ namespace
 		AudioEffectType type = AudioEffectType::Unspecified;
 
 		// First, try to find in custom definitions
-		const auto& defs = isFX ? chartData.audio.audioEffect.fx.def : chartData.audio.audioEffect.laser.def;
-		for (const auto& [name, def] : defs)
+		if (const AudioEffectDef* pDef = defIndex.find(effectName))
 		{
-			if (name == effectName)
-			{
-				type = def.type;
-				break;
-			}
+			type = pDef->type;
 		}
 
 		// If not found in custom definitions, check if it's a preset effect
@@ -1539,7 +1785,7 @@ namespace
 	}
 
 	// Write zoom parameter (zoom_top, zoom_bottom, zoom_side)
-	void WriteZoomParameter(std::ostream& stream, const std::string& paramName, const GraphPoint& graphPoint, KshSavingDiag* pKshSavingDiag)
+	void WriteZoomParameter(KshOutputBuffer& stream, const std::string& paramName, const GraphPoint& graphPoint, KshSavingDiag* pKshSavingDiag)
 	{
 		const double clampedV = std::clamp(graphPoint.v.v, -kZoomAbsMax, kZoomAbsMax);
 		if (pKshSavingDiag && clampedV != graphPoint.v.v)
@@ -1574,12 +1820,12 @@ namespace
 
 		if (graphPoint.curve.a != 0.0 || graphPoint.curve.b != 0.0)
 		{
-			stream << paramName << "_curve=" << graphPoint.curve.a << ";" << graphPoint.curve.b << "\r\n";
+			stream << paramName << "_curve=" << FormatDoubleGeneral(graphPoint.curve.a) << ";" << FormatDoubleGeneral(graphPoint.curve.b) << "\r\n";
 		}
 	}
 
 	// Write note line
-	void WriteNoteLine(std::ostream& stream, const ChartData& chartData, const std::array<std::vector<KshLaserSegment>, kNumLaserLanes>& laserSegments, Pulse pulse, Pulse oneLinePulse, MeasureExportState& state, bool useLegacyScaleForManualTilt, KshSavingDiag* pKshSavingDiag)
+	void WriteNoteLine(KshOutputBuffer& stream, const ChartData& chartData, NoteLineCursors& cursors, Pulse pulse, MeasureExportState& state, bool useLegacyScaleForManualTilt, KshSavingDiag* pKshSavingDiag)
 	{
 		// Note: The output order below should be the same as v1's order (*command_save in kshooteditor.hsp) for better compatibility of internet ranking hashing
 
@@ -1683,7 +1929,7 @@ namespace
 					.message = "center_split value " + std::to_string(graphPoint.v.v) + " clamped to " + std::to_string(clampedV),
 				});
 			}
-			stream << "center_split=" << clampedV << "\r\n";
+			stream << "center_split=" << FormatDoubleGeneral(clampedV) << "\r\n";
 
 			// Output vf on next line if v != vf (immediate change)
 			if (!AlmostEquals(graphPoint.v.v, graphPoint.v.vf))
@@ -1697,12 +1943,12 @@ namespace
 						.message = "center_split vf value " + std::to_string(graphPoint.v.vf) + " clamped to " + std::to_string(clampedVf),
 					});
 				}
-				stream << "center_split=" << clampedVf << "\r\n";
+				stream << "center_split=" << FormatDoubleGeneral(clampedVf) << "\r\n";
 			}
 
 			if (graphPoint.curve.a != 0.0 || graphPoint.curve.b != 0.0)
 			{
-				stream << "center_split_curve=" << graphPoint.curve.a << ";" << graphPoint.curve.b << "\r\n";
+				stream << "center_split_curve=" << FormatDoubleGeneral(graphPoint.curve.a) << ";" << FormatDoubleGeneral(graphPoint.curve.b) << "\r\n";
 			}
 		}
 
@@ -1953,36 +2199,22 @@ namespace
 		for (std::int32_t i = 0; i < kNumLaserLanes; ++i)
 		{
 			// Find segment starting at this pulse
-			for (const auto& seg : laserSegments[i])
+			const KshLaserSegment* pSeg = cursors.laserSegment[i].sectionStartAt(pulse);
+			if (pSeg != nullptr && pSeg->wide)
 			{
-				if (seg.startPulse == pulse && seg.isSectionStart)
-				{
-					// Output wide annotation
-					if (seg.wide)
-					{
-						stream << "laserrange_" << (i == 0 ? 'l' : 'r') << "=2x\r\n";
-					}
-					break;
-				}
+				// Output wide annotation
+				stream << "laserrange_" << (i == 0 ? 'l' : 'r') << "=2x\r\n";
 			}
 		}
 
 		// Output laser curve for points at this pulse
 		for (std::int32_t i = 0; i < kNumLaserLanes; ++i)
 		{
-			for (const auto& [sectionPulse, section] : chartData.note.laser[i])
+			const GraphPoint* pPoint = cursors.laserSection[i].pointAt(pulse);
+			if (pPoint != nullptr && (pPoint->curve.a != 0.0 || pPoint->curve.b != 0.0))
 			{
-				const RelPulse relPulse = pulse - sectionPulse;
-				if (relPulse >= 0 && section.v.contains(relPulse))
-				{
-					const auto& point = section.v.at(relPulse);
-					if (point.curve.a != 0.0 || point.curve.b != 0.0)
-					{
-						stream << "laser_" << (i == 0 ? 'l' : 'r') << "_curve="
-							<< FormatDouble(point.curve.a) << ";" << FormatDouble(point.curve.b) << "\r\n";
-					}
-					break;
-				}
+				stream << "laser_" << (i == 0 ? 'l' : 'r') << "_curve="
+					<< FormatDouble(pPoint->curve.a) << ";" << FormatDouble(pPoint->curve.b) << "\r\n";
 			}
 		}
 
@@ -2055,55 +2287,50 @@ namespace
 
 		// Check for FX audio effect annotations (fx-l, fx-r)
 		// Output in lane order (fx-l before fx-r) to match v1 behavior
-		if (!chartData.audio.audioEffect.fx.longEvent.empty())
+		for (std::int32_t laneIdx = 0; laneIdx < kNumFXLanes; ++laneIdx)
 		{
-			for (std::int32_t laneIdx = 0; laneIdx < kNumFXLanes; ++laneIdx)
+			const auto& fxLongEvents = state.fxLongEventsByPulse[laneIdx];
+			const auto it = fxLongEvents.find(pulse);
+			if (it == fxLongEvents.end())
 			{
-				for (const auto& [effectName, laneEvents] : chartData.audio.audioEffect.fx.longEvent)
-				{
-					if (!laneEvents[laneIdx].contains(pulse))
-					{
-						continue;
-					}
+				continue;
+			}
 
-					// Empty effect name represents "effect off"
-					if (effectName.empty())
-					{
-						stream << "fx-" << (laneIdx == 0 ? 'l' : 'r') << "=\r\n";
-						state.currentFXAudioEffects[laneIdx].clear();
-						break;
-					}
+			// Empty effect name represents "effect off"
+			const auto& [pEffectName, pParams] = it->second;
+			if (pEffectName->empty())
+			{
+				stream << "fx-" << (laneIdx == 0 ? 'l' : 'r') << "=\r\n";
+				state.currentFXAudioEffects[laneIdx].clear();
+				continue;
+			}
 
-					const auto& params = laneEvents[laneIdx].at(pulse);
-					const std::string audioEffectStr = GenerateKshAudioEffectString(chartData, effectName, params, true);
+			const std::string audioEffectStr = GenerateKshAudioEffectString(state.fxDefIndex, *pEffectName, *pParams);
 
-					// Output fx-l/fx-r
-					stream << "fx-" << (laneIdx == 0 ? 'l' : 'r') << "=" << audioEffectStr << "\r\n";
-					state.currentFXAudioEffects[laneIdx] = audioEffectStr;
-					break;
-				}
-			}
+			// Output fx-l/fx-r
+			stream << "fx-" << (laneIdx == 0 ? 'l' : 'r') << "=" << audioEffectStr << "\r\n";
+			state.currentFXAudioEffects[laneIdx] = audioEffectStr;
 		}
 
 		// BT notes (4 chars)
 		std::array<char, kNumBTLanes> btChars;
 		for (std::int32_t i = 0; i < kNumBTLanes; ++i)
 		{
-			btChars[i] = GetBTCharAt(chartData.note.bt[i], pulse, oneLinePulse);
+			btChars[i] = GetBTCharAt(cursors.bt[i], pulse);
 		}
 
 		// FX notes (2 chars)
 		std::array<char, kNumFXLanes> fxChars;
 		for (std::int32_t i = 0; i < kNumFXLanes; ++i)
 		{
-			fxChars[i] = GetFXCharAt(chartData.note.fx[i], pulse, oneLinePulse);
+			fxChars[i] = GetFXCharAt(cursors.fx[i], pulse);
 		}
 
 		// Laser notes (2 chars)
 		std::array<char, kNumLaserLanes> laserChars;
 		for (std::int32_t i = 0; i < kNumLaserLanes; ++i)
 		{
-			laserChars[i] = GetLaserCharAt(laserSegments[i], pulse, i, state);
+			laserChars[i] = GetLaserCharAt(cursors.laserSegment[i], pulse, i, state);
 		}
 
 		// Output: "0011|22|AB" or "0011|22|AB@)240"
@@ -2148,23 +2375,21 @@ namespace
 		stream << "\r\n";
 	}
 
-	// Calculate optimal division for a measure
-	std::int32_t CalculateOptimalDivision(const ChartData& chartData, const std::array<std::vector<KshLaserSegment>, kNumLaserLanes>& laserSegments, Pulse measureStart, Pulse measureLength)
+	// Event that affects the division of the measure containing it
+	struct DivisionEvent
 	{
-		const Pulse measureEnd = measureStart + measureLength;
-		Pulse gcd = measureLength;
-		bool shouldDoubleResolution = false;
+		Pulse pulse;
+		bool requiresDoubleResolution; // Start or end of long notes or laser segments
+	};
 
-		// Helper function to update GCD with a pulse if it's within the measure
-		auto updateGCD = [&](Pulse pulse) {
-			if (pulse >= measureStart && pulse < measureEnd)
-			{
-				const Pulse relPulse = pulse - measureStart;
-				if (relPulse > 0 && relPulse < measureLength)
-				{
-					gcd = std::gcd(gcd, relPulse);
-				}
-			}
+	// Collect all events affecting the measure division, sorted by pulse
+	// Note: This is done once before writing measures so that each measure only looks at its own events
+	std::vector<DivisionEvent> CollectDivisionEvents(const ChartData& chartData, const std::array<std::vector<KshLaserSegment>, kNumLaserLanes>& laserSegments)
+	{
+		std::vector<DivisionEvent> events;
+
+		auto addEvent = [&](Pulse pulse, bool requiresDoubleResolution = false) {
+			events.push_back({ .pulse = pulse, .requiresDoubleResolution = requiresDoubleResolution });
 		};
 
 		// BT notes
@@ -2172,20 +2397,11 @@ namespace
 		{
 			for (const auto& [pulse, interval] : lane)
 			{
-				updateGCD(pulse);
-				updateGCD(pulse + interval.length);
-
-				// Long BT notes starting in this measure require doubled resolution
-				if (interval.length > 0 && pulse >= measureStart && pulse < measureEnd)
+				// Long BT notes starting or ending in the measure require doubled resolution
+				addEvent(pulse, interval.length > 0);
+				if (interval.length > 0)
 				{
-					shouldDoubleResolution = true;
-				}
-
-				// Long BT notes ending in this measure require doubled resolution
-				const Pulse endPulse = pulse + interval.length;
-				if (interval.length > 0 && endPulse >= measureStart && endPulse < measureEnd)
-				{
-					shouldDoubleResolution = true;
+					addEvent(pulse + interval.length, true);
 				}
 			}
 		}
@@ -2195,20 +2411,11 @@ namespace
 		{
 			for (const auto& [pulse, interval] : lane)
 			{
-				updateGCD(pulse);
-				updateGCD(pulse + interval.length);
-
-				// Long FX notes starting in this measure require doubled resolution
-				if (interval.length > 0 && pulse >= measureStart && pulse < measureEnd)
-				{
-					shouldDoubleResolution = true;
-				}
-
-				// Long FX notes ending in this measure require doubled resolution
-				const Pulse endPulse = pulse + interval.length;
-				if (interval.length > 0 && endPulse >= measureStart && endPulse < measureEnd)
+				// Long FX notes starting or ending in the measure require doubled resolution
+				addEvent(pulse, interval.length > 0);
+				if (interval.length > 0)
 				{
-					shouldDoubleResolution = true;
+					addEvent(pulse + interval.length, true);
 				}
 			}
 		}
@@ -2216,87 +2423,74 @@ namespace
 		// Laser notes
 		for (std::int32_t laneIdx = 0; laneIdx < kNumLaserLanes; ++laneIdx)
 		{
-			const auto& segments = laserSegments[laneIdx];
-			for (std::size_t segIdx = 0; segIdx < segments.size(); ++segIdx)
+			for (const auto& seg : laserSegments[laneIdx])
 			{
-				const auto& seg = segments[segIdx];
-				updateGCD(seg.startPulse);
-				updateGCD(seg.startPulse + seg.length);
-
-				// Laser segments starting or ending in this measure require doubled resolution
-				if (seg.startPulse >= measureStart && seg.startPulse < measureEnd)
-				{
-					shouldDoubleResolution = true;
-				}
-
-				const Pulse endPulse = seg.startPulse + seg.length;
-				if (endPulse >= measureStart && endPulse < measureEnd)
-				{
-					shouldDoubleResolution = true;
-				}
+				// Laser segments starting or ending in the measure require doubled resolution
+				addEvent(seg.startPulse, true);
+				addEvent(seg.startPulse + seg.length, true);
 			}
 		}
 
 		// BPM changes
 		for (const auto& [pulse, bpm] : chartData.beat.bpm)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 
 		// Stops
 		for (const auto& [pulse, length] : chartData.beat.stop)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 
 		// Scroll speed
 		for (const auto& [pulse, graphPoint] : chartData.beat.scrollSpeed)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 
 		// Camera rotation
 		for (const auto& [pulse, graphPoint] : chartData.camera.cam.body.rotationDeg)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 
 		// Camera zoom
 		for (const auto& [pulse, graphPoint] : chartData.camera.cam.body.zoomTop)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 		for (const auto& [pulse, graphPoint] : chartData.camera.cam.body.zoomBottom)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 		for (const auto& [pulse, graphPoint] : chartData.camera.cam.body.zoomSide)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 		for (const auto& [pulse, graphPoint] : chartData.camera.cam.body.centerSplit)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 
 		// Camera tilt
 		for (const auto& [pulse, tiltValue] : chartData.camera.tilt)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 
 		// Spin events
 		for (const auto& [pulse, spinEvent] : chartData.camera.cam.pattern.laser.slamEvent.spin)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 		for (const auto& [pulse, spinEvent] : chartData.camera.cam.pattern.laser.slamEvent.halfSpin)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 		for (const auto& [pulse, swingEvent] : chartData.camera.cam.pattern.laser.slamEvent.swing)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 
 		if (!chartData.audio.audioEffect.fx.longEvent.empty())
@@ -2307,7 +2501,7 @@ namespace
 				{
 					for (const auto& [pulse, params] : laneEvents[laneIdx])
 					{
-						updateGCD(pulse);
+						addEvent(pulse);
 					}
 				}
 			}
@@ -2321,7 +2515,7 @@ namespace
 				{
 					for (const auto& [pulse, value] : pulseValueMap)
 					{
-						updateGCD(pulse);
+						addEvent(pulse);
 					}
 				}
 			}
@@ -2335,7 +2529,7 @@ namespace
 				{
 					for (const auto& [pulse, value] : pulseValueMap)
 					{
-						updateGCD(pulse);
+						addEvent(pulse);
 					}
 				}
 			}
@@ -2347,19 +2541,19 @@ namespace
 			{
 				for (const auto& pulse : pulses)
 				{
-					updateGCD(pulse);
+					addEvent(pulse);
 				}
 			}
 		}
 
 		for (const auto& [pulse, vol] : chartData.audio.keySound.laser.vol)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 
 		for (const auto& [pulse, gain] : chartData.audio.audioEffect.laser.legacy.filterGain)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 
 		if (!chartData.audio.keySound.laser.slamEvent.empty())
@@ -2368,7 +2562,7 @@ namespace
 			{
 				for (const auto& pulse : pulses)
 				{
-					updateGCD(pulse);
+					addEvent(pulse);
 				}
 			}
 		}
@@ -2382,7 +2576,7 @@ namespace
 				{
 					for (const auto& [pulse, chipData] : lanes[laneIdx])
 					{
-						updateGCD(pulse);
+						addEvent(pulse);
 					}
 				}
 			}
@@ -2390,20 +2584,48 @@ namespace
 
 		for (const auto& [pulse, comment] : chartData.editor.comment)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
 		}
 
 		for (const auto& [optionKey, pulseValueMap] : chartData.compat.kshUnknown.option)
 		{
 			for (const auto& [pulse, values] : pulseValueMap)
 			{
-				updateGCD(pulse);
+				addEvent(pulse);
 			}
 		}
 
 		for (const auto& [pulse, line] : chartData.compat.kshUnknown.line)
 		{
-			updateGCD(pulse);
+			addEvent(pulse);
+		}
+
+		std::sort(events.begin(), events.end(), [](const DivisionEvent& a, const DivisionEvent& b) { return a.pulse < b.pulse; });
+
+		return events;
+	}
+
+	// Calculate optimal division for a measure
+	// measureEvents: events within the measure (measureStart <= pulse < measureStart + measureLength)
+	std::int32_t CalculateOptimalDivision(std::span<const DivisionEvent> measureEvents, Pulse measureStart, Pulse measureLength)
+	{
+		Pulse gcd = measureLength;
+		bool shouldDoubleResolution = false;
+
+		for (const DivisionEvent& event : measureEvents)
+		{
+			assert(measureStart <= event.pulse && event.pulse < measureStart + measureLength);
+
+			const Pulse relPulse = event.pulse - measureStart;
+			if (relPulse > 0)
+			{
+				gcd = std::gcd(gcd, relPulse);
+			}
+
+			if (event.requiresDoubleResolution)
+			{
+				shouldDoubleResolution = true;
+			}
 		}
 
 		// Calculate division in KSON resolution (960) to preserve all note timings
@@ -2452,7 +2674,7 @@ namespace
 	}
 
 	// Write measures
-	void WriteMeasures(std::ostream& stream, const ChartData& chartData, MeasureExportState& state, KshSavingDiag* pKshSavingDiag)
+	void WriteMeasures(KshOutputBuffer& stream, const ChartData& chartData, MeasureExportState& state, KshSavingDiag* pKshSavingDiag)
 	{
 		// Check if legacy manual tilt scale should be used
 		// This matches the logic in ksh_io_in.cpp: ver < 170 && any abs(tilt) >= 10.0
@@ -2511,6 +2733,25 @@ namespace
 			laserSegments[laneIdx] = ConvertLaserToKshSegments(chartData.note.laser[laneIdx], laneIdx);
 		}
 
+		// Lines are written in increasing pulse order, so each lane is scanned only once
+		NoteLineCursors cursors;
+		for (std::int32_t i = 0; i < kNumBTLanes; ++i)
+		{
+			cursors.bt[i] = NoteLaneCursor(chartData.note.bt[i]);
+		}
+		for (std::int32_t i = 0; i < kNumFXLanes; ++i)
+		{
+			cursors.fx[i] = NoteLaneCursor(chartData.note.fx[i]);
+		}
+		for (std::int32_t i = 0; i < kNumLaserLanes; ++i)
+		{
+			cursors.laserSegment[i] = LaserSegmentCursor(laserSegments[i]);
+			cursors.laserSection[i] = LaserSectionCursor(chartData.note.laser[i]);
+		}
+
+		const std::vector<DivisionEvent> divisionEvents = CollectDivisionEvents(chartData, laserSegments);
+		std::size_t divisionEventIdx = 0;
+
 		const Pulse maxPulse = CalculateMaxPulse(chartData);
 		Pulse currentPulse = 0;
 		std::int64_t measureIdx = 0;
@@ -2530,7 +2771,18 @@ namespace
 			}
 
 			// Calculate optimal division for this measure
-			const std::int32_t division = CalculateOptimalDivision(chartData, laserSegments, currentPulse, measureLength);
+			const Pulse measureEnd = currentPulse + measureLength;
+			while (divisionEventIdx < divisionEvents.size() && divisionEvents[divisionEventIdx].pulse < currentPulse)
+			{
+				++divisionEventIdx;
+			}
+			const std::size_t measureEventsBegin = divisionEventIdx;
+			while (divisionEventIdx < divisionEvents.size() && divisionEvents[divisionEventIdx].pulse < measureEnd)
+			{
+				++divisionEventIdx;
+			}
+			const std::span<const DivisionEvent> measureEvents(divisionEvents.data() + measureEventsBegin, divisionEventIdx - measureEventsBegin);
+			const std::int32_t division = CalculateOptimalDivision(measureEvents, currentPulse, measureLength);
 			const Pulse oneLinePulse = measureLength / division;
 
 			// Write each line
@@ -2538,7 +2790,7 @@ namespace
 			{
 				const Pulse pulse = currentPulse + lineIdx * oneLinePulse;
 
-				WriteNoteLine(stream, chartData, laserSegments, pulse, oneLinePulse, state, useLegacyScaleForManualTilt, pKshSavingDiag);
+				WriteNoteLine(stream, chartData, cursors, pulse, state, useLegacyScaleForManualTilt, pKshSavingDiag);
 			}
 
 			stream << kMeasureSeparator << "\r\n";
@@ -2548,7 +2800,7 @@ namespace
 	}
 
 	// Write audio effect definitions (#define_fx and #define_filter)
-	void WriteAudioEffectDefinitions(std::ostream& stream, const ChartData& chartData)
+	void WriteAudioEffectDefinitions(KshOutputBuffer& stream, const ChartData& chartData)
 	{
 		// Write #define_fx
 		if (!chartData.audio.audioEffect.fx.def.empty())
@@ -2627,16 +2879,20 @@ kson::ErrorType kson::SaveKshChartData(std::ostream& stream, const ChartData& ch
 
 	try
 	{
-		WriteBOM(stream);
+		KshOutputBuffer buffer;
+		WriteBOM(buffer);
 
-		MeasureExportState state;
+		MeasureExportState state(chartData);
 
 		ScanForDataLossWarnings(chartData, pKshSavingDiag);
 
 		// Write header and store the header BPM string in state
-		WriteHeader(stream, chartData, &state.headerBPMStr, pKshSavingDiag);
-		WriteMeasures(stream, chartData, state, pKshSavingDiag);
-		WriteAudioEffectDefinitions(stream, chartData);
+		WriteHeader(buffer, chartData, &state.headerBPMStr, pKshSavingDiag);
+		WriteMeasures(buffer, chartData, state, pKshSavingDiag);
+		WriteAudioEffectDefinitions(buffer, chartData);
+
+		const std::string_view output = buffer.view();
+		stream.write(output.data(), static_cast<std::streamsize>(output.size()));
 
 		return stream.good() ? ErrorType::None : ErrorType::GeneralIOError;
 	}
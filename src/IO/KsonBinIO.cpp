@@ -0,0 +1,1119 @@
+#include "kson/IO/KsonBinIO.hpp"
+#include "kson/Util/HashUtils.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+	using namespace kson;
+
+	std::filesystem::path U8Path(const std::string& utf8Str)
+	{
+		return std::filesystem::path(
+			std::u8string_view(reinterpret_cast<const char8_t*>(utf8Str.data()), utf8Str.size()));
+	}
+
+	// Note: Values are written in the native byte order, so kson-bin is supported only on little-endian hosts.
+	constexpr bool kIsLittleEndian = std::endian::native == std::endian::little;
+
+	constexpr std::array<char, 8> kMagic = { 'K', 'S', 'O', 'N', 'B', 'I', 'N', '\0' };
+
+	constexpr std::size_t kSectionAlignment = 8;
+
+	enum class SectionId : std::uint32_t
+	{
+		kStringIndex,
+		kStringData,
+		kBPM,
+		kTimeSig,
+		kScrollSpeed,
+		kStop,
+		kBT,
+		kFX,
+		kLaserSections,
+		kLaserPoints,
+		kCamGraph,
+		kMisc,
+	};
+
+	struct Header
+	{
+		std::array<char, 8> magic;
+		std::uint32_t version;
+		std::uint32_t numSections;
+		std::uint64_t payloadSize;
+		std::uint64_t checksum;
+	};
+
+	struct SectionEntry
+	{
+		SectionId id;
+		std::uint32_t index;
+		std::uint64_t offset;
+		std::uint64_t size;
+	};
+
+	static_assert(sizeof(Header) == kKsonBinHeaderSize);
+	static_assert(sizeof(SectionEntry) == 24);
+	static_assert(sizeof(KsonBinInterval) == 16 && std::is_trivially_copyable_v<KsonBinInterval>);
+	static_assert(sizeof(KsonBinValue) == 16 && std::is_trivially_copyable_v<KsonBinValue>);
+	static_assert(sizeof(KsonBinTimeSig) == 16 && std::is_trivially_copyable_v<KsonBinTimeSig>);
+	static_assert(sizeof(KsonBinGraphPoint) == 40 && std::is_trivially_copyable_v<KsonBinGraphPoint>);
+	static_assert(sizeof(KsonBinLaserSection) == 24 && std::is_trivially_copyable_v<KsonBinLaserSection>);
+
+	// Note: This is not a cryptographic hash. It is only meant to detect truncated or corrupted cache files.
+	std::uint64_t Checksum(std::span<const char> data)
+	{
+		return Hash64(data);
+	}
+
+	constexpr std::size_t AlignUp(std::size_t value)
+	{
+		return (value + kSectionAlignment - 1) / kSectionAlignment * kSectionAlignment;
+	}
+
+	// Lists the fields stored in the sequential section
+	// Note: Archive is either MiscWriter or MiscReader, so that the fields are always written and read in the same order.
+	//       MiscWriter never modifies the data although the references are non-const.
+
+	template <typename Archive>
+	void Transfer(Archive& ar, DifficultyInfo& d)
+	{
+		ar(d.idx);
+		ar(d.name);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, MetaInfo& d)
+	{
+		ar(d.title);
+		ar(d.titleTranslit);
+		ar(d.titleImgFilename);
+		ar(d.artist);
+		ar(d.artistTranslit);
+		ar(d.artistImgFilename);
+		ar(d.chartAuthor);
+		ar(d.difficulty);
+		ar(d.level);
+		ar(d.dispBPM);
+		ar(d.stdBPM);
+		ar(d.jacketFilename);
+		ar(d.jacketAuthor);
+		ar(d.iconFilename);
+		ar(d.information);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, GaugeInfo& d)
+	{
+		ar(d.total);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, BGMPreviewInfo& d)
+	{
+		ar(d.offset);
+		ar(d.duration);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, LegacyBGMInfo& d)
+	{
+		ar(d.filenameF);
+		ar(d.filenameP);
+		ar(d.filenameFP);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, BGMInfo& d)
+	{
+		ar(d.filename);
+		ar(d.vol);
+		ar(d.offset);
+		ar(d.preview);
+		ar(d.legacy);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, KeySoundInvokeFX& d)
+	{
+		ar(d.vol);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, KeySoundInfo& d)
+	{
+		ar(d.fx.chipEvent);
+		ar(d.laser.vol);
+		ar(d.laser.slamEvent);
+		ar(d.laser.legacy.volAuto);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, AudioEffectDef& d)
+	{
+		ar(d.type);
+		ar(d.v);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, AudioEffectDefKVP& d)
+	{
+		ar(d.name);
+		ar(d.v);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, AudioEffectInfo& d)
+	{
+		ar(d.fx.def);
+		ar(d.fx.paramChange);
+		ar(d.fx.longEvent);
+		ar(d.laser.def);
+		ar(d.laser.paramChange);
+		ar(d.laser.pulseEvent);
+		ar(d.laser.peakingFilterDelay);
+		ar(d.laser.legacy.filterGain);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, AudioInfo& d)
+	{
+		ar(d.bgm);
+		ar(d.keySound);
+		ar(d.audioEffect);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, GraphCurveValue& d)
+	{
+		ar(d.a);
+		ar(d.b);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, TiltGraphPoint& d)
+	{
+		ar(d.v.v);
+		ar(d.v.vf);
+		ar(d.curve);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, CamPatternInvokeSwingValue& d)
+	{
+		ar(d.scale);
+		ar(d.repeat);
+		ar(d.decayOrder);
+	}
+
+	template <typename Archive, typename ValueType>
+	void Transfer(Archive& ar, kson::detail::BasicCamPatternInvoke<ValueType>& d)
+	{
+		ar(d.d);
+		ar(d.length);
+		ar(d.v);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, CamPatternInfo& d)
+	{
+		ar(d.laser.slamEvent.spin);
+		ar(d.laser.slamEvent.halfSpin);
+		ar(d.laser.slamEvent.swing);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, KshBGInfo& d)
+	{
+		ar(d.filename);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, BGInfo& d)
+	{
+		ar(d.filename);
+		ar(d.legacy.bg);
+		ar(d.legacy.layer.filename);
+		ar(d.legacy.layer.duration);
+		ar(d.legacy.layer.rotation.tilt);
+		ar(d.legacy.layer.rotation.spin);
+		ar(d.legacy.movie.filename);
+		ar(d.legacy.movie.offset);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, EditorInfo& d)
+	{
+		ar(d.appName);
+		ar(d.appVersion);
+		ar(d.comment);
+	}
+
+	template <typename Archive>
+	void Transfer(Archive& ar, CompatInfo& d)
+	{
+		ar(d.kshVersion);
+		ar(d.kshUnknown.meta);
+		ar(d.kshUnknown.option);
+		ar(d.kshUnknown.line);
+	}
+
+	template <typename Archive>
+	void TransferMisc(Archive& ar, ChartData& chartData)
+	{
+		ar(chartData.meta);
+		ar(chartData.gauge);
+		ar(chartData.audio);
+		ar(chartData.camera.tilt);
+		ar(chartData.camera.cam.pattern);
+		ar(chartData.bg);
+		ar(chartData.editor);
+		ar(chartData.compat);
+	}
+
+	class StringTable
+	{
+	private:
+		std::vector<std::string_view> m_strings;
+
+		std::unordered_map<std::string_view, std::uint32_t> m_indices;
+
+	public:
+		// Note: str must outlive the table
+		std::uint32_t add(std::string_view str)
+		{
+			const auto [it, inserted] = m_indices.try_emplace(str, static_cast<std::uint32_t>(m_strings.size()));
+			if (inserted)
+			{
+				m_strings.push_back(str);
+			}
+			return it->second;
+		}
+
+		[[nodiscard]]
+		const std::vector<std::string_view>& strings() const
+		{
+			return m_strings;
+		}
+	};
+
+	class MiscWriter
+	{
+	private:
+		std::string& m_buffer;
+
+		StringTable& m_stringTable;
+
+		void writeSize(std::size_t size)
+		{
+			(*this)(static_cast<std::uint64_t>(size));
+		}
+
+	public:
+		MiscWriter(std::string& buffer, StringTable& stringTable)
+			: m_buffer(buffer)
+			, m_stringTable(stringTable)
+		{
+		}
+
+		template <typename T>
+		void operator()(const T& value)
+		{
+			if constexpr (std::is_arithmetic_v<T>)
+			{
+				m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+			}
+			else if constexpr (std::is_enum_v<T>)
+			{
+				(*this)(static_cast<std::underlying_type_t<T>>(value));
+			}
+			else
+			{
+				Transfer(*this, const_cast<T&>(value));
+			}
+		}
+
+		void operator()(const std::string& value)
+		{
+			(*this)(m_stringTable.add(value));
+		}
+
+		void operator()(const std::tuple<>&)
+		{
+		}
+
+		template <typename T, std::size_t N>
+		void operator()(const std::array<T, N>& value)
+		{
+			for (const auto& v : value)
+			{
+				(*this)(v);
+			}
+		}
+
+		template <typename T>
+		void operator()(const std::vector<T>& value)
+		{
+			writeSize(value.size());
+			for (const auto& v : value)
+			{
+				(*this)(v);
+			}
+		}
+
+		template <typename T, typename Compare, typename Alloc>
+		void operator()(const std::set<T, Compare, Alloc>& value)
+		{
+			writeSize(value.size());
+			for (const auto& v : value)
+			{
+				(*this)(v);
+			}
+		}
+
+		template <typename K, typename V, typename Compare, typename Alloc>
+		void operator()(const std::map<K, V, Compare, Alloc>& value)
+		{
+			writeSize(value.size());
+			for (const auto& [k, v] : value)
+			{
+				(*this)(k);
+				(*this)(v);
+			}
+		}
+
+		template <typename K, typename V, typename Compare, typename Alloc>
+		void operator()(const std::multimap<K, V, Compare, Alloc>& value)
+		{
+			writeSize(value.size());
+			for (const auto& [k, v] : value)
+			{
+				(*this)(k);
+				(*this)(v);
+			}
+		}
+
+		template <typename V>
+		void operator()(const std::unordered_map<std::string, V>& value)
+		{
+			// Sort by key so that the same chart always produces the same bytes
+			std::vector<const typename std::unordered_map<std::string, V>::value_type*> sorted;
+			sorted.reserve(value.size());
+			for (const auto& kvp : value)
+			{
+				sorted.push_back(&kvp);
+			}
+			std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+			writeSize(sorted.size());
+			for (const auto* pKVP : sorted)
+			{
+				(*this)(pKVP->first);
+				(*this)(pKVP->second);
+			}
+		}
+
+		template <typename... Ts>
+		void operator()(const std::variant<Ts...>& value)
+		{
+			(*this)(static_cast<std::uint8_t>(value.index()));
+			std::visit([this](const auto& v) { (*this)(v); }, value);
+		}
+	};
+
+	class MiscReader
+	{
+	private:
+		std::span<const char> m_data;
+
+		const KsonBinChartView& m_view;
+
+		std::size_t m_pos = 0;
+
+		bool m_failed = false;
+
+		bool readSize(std::size_t* pSize)
+		{
+			std::uint64_t size = 0;
+			(*this)(size);
+
+			// Every element takes at least one byte, so a larger size can only come from broken data
+			if (m_failed || size > m_data.size() - m_pos)
+			{
+				m_failed = true;
+				return false;
+			}
+			*pSize = static_cast<std::size_t>(size);
+			return true;
+		}
+
+		template <typename T>
+		void readElementsTo(std::vector<T>& value)
+		{
+			std::size_t size;
+			if (!readSize(&size))
+			{
+				return;
+			}
+			value.resize(size);
+			for (auto& v : value)
+			{
+				(*this)(v);
+			}
+		}
+
+		template <typename Container>
+		void readPairsTo(Container& value)
+		{
+			value.clear();
+			std::size_t size;
+			if (!readSize(&size))
+			{
+				return;
+			}
+			for (std::size_t i = 0; i < size && !m_failed; ++i)
+			{
+				typename Container::key_type k{};
+				typename Container::mapped_type v{};
+				(*this)(k);
+				(*this)(v);
+				value.emplace_hint(value.end(), std::move(k), std::move(v));
+			}
+		}
+
+		template <std::size_t I, typename... Ts>
+		void readVariantAlternative(std::variant<Ts...>& value, std::size_t index)
+		{
+			if constexpr (I < sizeof...(Ts))
+			{
+				if (index == I)
+				{
+					(*this)(value.template emplace<I>());
+				}
+				else
+				{
+					readVariantAlternative<I + 1>(value, index);
+				}
+			}
+			else
+			{
+				m_failed = true;
+			}
+		}
+
+	public:
+		MiscReader(std::span<const char> data, const KsonBinChartView& view)
+			: m_data(data)
+			, m_view(view)
+		{
+		}
+
+		[[nodiscard]]
+		bool succeeded() const
+		{
+			return !m_failed && m_pos == m_data.size();
+		}
+
+		template <typename T>
+		void operator()(T& value)
+		{
+			if constexpr (std::is_arithmetic_v<T>)
+			{
+				if (m_failed || m_data.size() - m_pos < sizeof(T))
+				{
+					m_failed = true;
+					return;
+				}
+				std::memcpy(&value, m_data.data() + m_pos, sizeof(T));
+				m_pos += sizeof(T);
+			}
+			else if constexpr (std::is_enum_v<T>)
+			{
+				std::underlying_type_t<T> underlying{};
+				(*this)(underlying);
+				value = static_cast<T>(underlying);
+			}
+			else
+			{
+				Transfer(*this, value);
+			}
+		}
+
+		void operator()(std::string& value)
+		{
+			std::uint32_t idx = 0;
+			(*this)(idx);
+			if (m_failed || idx >= m_view.numStrings())
+			{
+				m_failed = true;
+				return;
+			}
+			value = m_view.string(idx);
+		}
+
+		void operator()(std::tuple<>&)
+		{
+		}
+
+		template <typename T, std::size_t N>
+		void operator()(std::array<T, N>& value)
+		{
+			for (auto& v : value)
+			{
+				(*this)(v);
+			}
+		}
+
+		template <typename T>
+		void operator()(std::vector<T>& value)
+		{
+			readElementsTo(value);
+		}
+
+		template <typename T, typename Compare, typename Alloc>
+		void operator()(std::set<T, Compare, Alloc>& value)
+		{
+			value.clear();
+			std::size_t size;
+			if (!readSize(&size))
+			{
+				return;
+			}
+			for (std::size_t i = 0; i < size && !m_failed; ++i)
+			{
+				T v{};
+				(*this)(v);
+				value.emplace_hint(value.end(), std::move(v));
+			}
+		}
+
+		template <typename K, typename V, typename Compare, typename Alloc>
+		void operator()(std::map<K, V, Compare, Alloc>& value)
+		{
+			readPairsTo(value);
+		}
+
+		template <typename K, typename V, typename Compare, typename Alloc>
+		void operator()(std::multimap<K, V, Compare, Alloc>& value)
+		{
+			readPairsTo(value);
+		}
+
+		template <typename V>
+		void operator()(std::unordered_map<std::string, V>& value)
+		{
+			value.clear();
+			std::size_t size;
+			if (!readSize(&size))
+			{
+				return;
+			}
+			value.reserve(size);
+			for (std::size_t i = 0; i < size && !m_failed; ++i)
+			{
+				std::string k;
+				V v{};
+				(*this)(k);
+				(*this)(v);
+				value.insert_or_assign(std::move(k), std::move(v));
+			}
+		}
+
+		template <typename... Ts>
+		void operator()(std::variant<Ts...>& value)
+		{
+			std::uint8_t index = 0;
+			(*this)(index);
+			if (m_failed)
+			{
+				return;
+			}
+			readVariantAlternative<0>(value, index);
+		}
+	};
+
+	template <typename T>
+	void AppendArray(std::string& buffer, const std::vector<T>& values)
+	{
+		buffer.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+	}
+
+	KsonBinGraphPoint ToKsonBinGraphPoint(Pulse y, const GraphPoint& point)
+	{
+		return {
+			.y = y,
+			.v = point.v.v,
+			.vf = point.v.vf,
+			.a = point.curve.a,
+			.b = point.curve.b,
+		};
+	}
+
+	GraphPoint ToGraphPoint(const KsonBinGraphPoint& point)
+	{
+		return GraphPoint{ GraphValue{ point.v, point.vf }, GraphCurveValue{ point.a, point.b } };
+	}
+
+	class KsonBinFileBuilder
+	{
+	private:
+		struct PendingSection
+		{
+			SectionId id;
+			std::uint32_t index;
+			std::string data;
+		};
+
+		std::vector<PendingSection> m_sections;
+
+	public:
+		// Note: The returned reference is invalidated when another section is added
+		std::string& addSection(SectionId id, std::uint32_t index = 0)
+		{
+			m_sections.push_back({ .id = id, .index = index, .data = {} });
+			return m_sections.back().data;
+		}
+
+		template <typename T>
+		void addArraySection(SectionId id, std::uint32_t index, const std::vector<T>& values)
+		{
+			AppendArray(addSection(id, index), values);
+		}
+
+		void addGraphSection(SectionId id, std::uint32_t index, const Graph& graph)
+		{
+			std::vector<KsonBinGraphPoint> points;
+			points.reserve(graph.size());
+			for (const auto& [y, point] : graph)
+			{
+				points.push_back(ToKsonBinGraphPoint(y, point));
+			}
+			addArraySection(id, index, points);
+		}
+
+		void addIntervalSection(SectionId id, std::uint32_t index, const ByPulse<Interval>& lane)
+		{
+			std::vector<KsonBinInterval> notes;
+			notes.reserve(lane.size());
+			for (const auto& [y, note] : lane)
+			{
+				notes.push_back({ .y = y, .length = note.length });
+			}
+			addArraySection(id, index, notes);
+		}
+
+		[[nodiscard]]
+		std::string build() const
+		{
+			const std::size_t tableOffset = kKsonBinHeaderSize;
+			std::size_t offset = AlignUp(tableOffset + sizeof(SectionEntry) * m_sections.size());
+
+			std::vector<SectionEntry> table;
+			table.reserve(m_sections.size());
+			for (const auto& section : m_sections)
+			{
+				table.push_back({
+					.id = section.id,
+					.index = section.index,
+					.offset = offset,
+					.size = section.data.size(),
+				});
+				offset = AlignUp(offset + section.data.size());
+			}
+
+			std::string file(offset, '\0');
+			std::memcpy(file.data() + tableOffset, table.data(), sizeof(SectionEntry) * table.size());
+			for (std::size_t i = 0; i < m_sections.size(); ++i)
+			{
+				std::memcpy(file.data() + table[i].offset, m_sections[i].data.data(), m_sections[i].data.size());
+			}
+
+			const Header header = {
+				.magic = kMagic,
+				.version = kKsonBinFormatVersion,
+				.numSections = static_cast<std::uint32_t>(m_sections.size()),
+				.payloadSize = file.size() - kKsonBinHeaderSize,
+				.checksum = Checksum(std::span<const char>(file).subspan(kKsonBinHeaderSize)),
+			};
+			std::memcpy(file.data(), &header, sizeof(header));
+			return file;
+		}
+	};
+
+	std::string BuildKsonBinFile(const ChartData& chartData)
+	{
+		KsonBinFileBuilder builder;
+
+		// Beat
+		{
+			std::vector<KsonBinValue> bpm;
+			bpm.reserve(chartData.beat.bpm.size());
+			for (const auto& [y, v] : chartData.beat.bpm)
+			{
+				bpm.push_back({ .y = y, .v = v });
+			}
+			builder.addArraySection(SectionId::kBPM, 0, bpm);
+
+			std::vector<KsonBinTimeSig> timeSig;
+			timeSig.reserve(chartData.beat.timeSig.size());
+			for (const auto& [idx, v] : chartData.beat.timeSig)
+			{
+				timeSig.push_back({ .measureIdx = idx, .n = v.n, .d = v.d });
+			}
+			builder.addArraySection(SectionId::kTimeSig, 0, timeSig);
+
+			builder.addGraphSection(SectionId::kScrollSpeed, 0, chartData.beat.scrollSpeed);
+
+			std::vector<KsonBinInterval> stop;
+			stop.reserve(chartData.beat.stop.size());
+			for (const auto& [y, length] : chartData.beat.stop)
+			{
+				stop.push_back({ .y = y, .length = length });
+			}
+			builder.addArraySection(SectionId::kStop, 0, stop);
+		}
+
+		// Note
+		for (std::size_t i = 0; i < kNumBTLanesSZ; ++i)
+		{
+			builder.addIntervalSection(SectionId::kBT, static_cast<std::uint32_t>(i), chartData.note.bt[i]);
+		}
+		for (std::size_t i = 0; i < kNumFXLanesSZ; ++i)
+		{
+			builder.addIntervalSection(SectionId::kFX, static_cast<std::uint32_t>(i), chartData.note.fx[i]);
+		}
+		for (std::size_t i = 0; i < kNumLaserLanesSZ; ++i)
+		{
+			std::vector<KsonBinLaserSection> sections;
+			std::vector<KsonBinGraphPoint> points;
+			sections.reserve(chartData.note.laser[i].size());
+			for (const auto& [y, section] : chartData.note.laser[i])
+			{
+				sections.push_back({
+					.y = y,
+					.pointIdx = static_cast<std::uint32_t>(points.size()),
+					.numPoints = static_cast<std::uint32_t>(section.v.size()),
+					.w = section.w,
+				});
+				for (const auto& [ry, point] : section.v)
+				{
+					points.push_back(ToKsonBinGraphPoint(ry, point));
+				}
+			}
+			builder.addArraySection(SectionId::kLaserSections, static_cast<std::uint32_t>(i), sections);
+			builder.addArraySection(SectionId::kLaserPoints, static_cast<std::uint32_t>(i), points);
+		}
+
+		// Camera body graphs (in the order of KsonBinCamGraph)
+		{
+			const CamGraphs& body = chartData.camera.cam.body;
+			const std::array<const Graph*, kNumKsonBinCamGraphs> graphs = { &body.zoomBottom, &body.zoomSide, &body.zoomTop, &body.rotationDeg, &body.centerSplit };
+			for (std::size_t i = 0; i < graphs.size(); ++i)
+			{
+				builder.addGraphSection(SectionId::kCamGraph, static_cast<std::uint32_t>(i), *graphs[i]);
+			}
+		}
+
+		// Others
+		StringTable stringTable;
+#ifndef KSON_WITHOUT_JSON_DEPENDENCY
+		const std::string impl = chartData.impl.dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace);
+#else
+		const std::string impl;
+#endif
+		{
+			std::string& misc = builder.addSection(SectionId::kMisc);
+			MiscWriter writer(misc, stringTable);
+			TransferMisc(writer, const_cast<ChartData&>(chartData));
+			writer(impl);
+		}
+
+		// String table (added last because the other sections add strings to it)
+		{
+			std::vector<std::uint64_t> stringIndex;
+			std::string& stringData = builder.addSection(SectionId::kStringData);
+			stringIndex.reserve(stringTable.strings().size() * 2);
+			for (const std::string_view str : stringTable.strings())
+			{
+				stringIndex.push_back(stringData.size());
+				stringIndex.push_back(str.size());
+				stringData.append(str);
+			}
+			builder.addArraySection(SectionId::kStringIndex, 0, stringIndex);
+		}
+
+		return builder.build();
+	}
+
+	// Copies the content into a buffer aligned to 8 bytes
+	std::vector<std::uint64_t> ReadAllAligned(std::istream& stream, std::size_t* pSize)
+	{
+		const std::string content(std::istreambuf_iterator<char>(stream), {});
+		std::vector<std::uint64_t> buffer((content.size() + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+		if (!content.empty())
+		{
+			std::memcpy(buffer.data(), content.data(), content.size());
+		}
+		*pSize = content.size();
+		return buffer;
+	}
+}
+
+kson::KsonBinChartView::KsonBinChartView(std::span<const char> buffer)
+{
+	if constexpr (!kIsLittleEndian)
+	{
+		return;
+	}
+
+	if (buffer.size() < kKsonBinHeaderSize || reinterpret_cast<std::uintptr_t>(buffer.data()) % kSectionAlignment != 0)
+	{
+		return;
+	}
+
+	Header header;
+	std::memcpy(&header, buffer.data(), sizeof(header));
+	if (header.magic != kMagic || header.version != kKsonBinFormatVersion || header.payloadSize != buffer.size() - kKsonBinHeaderSize)
+	{
+		return;
+	}
+	if (header.checksum != Checksum(buffer.subspan(kKsonBinHeaderSize)))
+	{
+		return;
+	}
+	if (header.numSections > (buffer.size() - kKsonBinHeaderSize) / sizeof(SectionEntry))
+	{
+		return;
+	}
+
+	const auto assign = [&buffer]<typename T>(Section<T>& section, const SectionEntry& entry)
+	{
+		if (entry.size % sizeof(T) != 0)
+		{
+			return false;
+		}
+		section.pData = reinterpret_cast<const T*>(buffer.data() + entry.offset);
+		section.size = static_cast<std::size_t>(entry.size / sizeof(T));
+		return true;
+	};
+
+	const std::size_t dataOffset = kKsonBinHeaderSize + sizeof(SectionEntry) * header.numSections;
+	for (std::uint32_t i = 0; i < header.numSections; ++i)
+	{
+		SectionEntry entry;
+		std::memcpy(&entry, buffer.data() + kKsonBinHeaderSize + sizeof(SectionEntry) * i, sizeof(entry));
+		if (entry.offset % kSectionAlignment != 0 || entry.offset < dataOffset || entry.offset > buffer.size() || entry.size > buffer.size() - entry.offset)
+		{
+			return;
+		}
+
+		bool valid;
+		switch (entry.id)
+		{
+		case SectionId::kStringIndex: valid = entry.index == 0 && assign(m_stringIndex, entry); break;
+		case SectionId::kStringData: valid = entry.index == 0 && assign(m_stringData, entry); break;
+		case SectionId::kBPM: valid = entry.index == 0 && assign(m_bpm, entry); break;
+		case SectionId::kTimeSig: valid = entry.index == 0 && assign(m_timeSig, entry); break;
+		case SectionId::kScrollSpeed: valid = entry.index == 0 && assign(m_scrollSpeed, entry); break;
+		case SectionId::kStop: valid = entry.index == 0 && assign(m_stop, entry); break;
+		case SectionId::kBT: valid = entry.index < kNumBTLanesSZ && assign(m_bt[entry.index], entry); break;
+		case SectionId::kFX: valid = entry.index < kNumFXLanesSZ && assign(m_fx[entry.index], entry); break;
+		case SectionId::kLaserSections: valid = entry.index < kNumLaserLanesSZ && assign(m_laserSections[entry.index], entry); break;
+		case SectionId::kLaserPoints: valid = entry.index < kNumLaserLanesSZ && assign(m_laserPoints[entry.index], entry); break;
+		case SectionId::kCamGraph: valid = entry.index < kNumKsonBinCamGraphs && assign(m_camGraphs[entry.index], entry); break;
+		case SectionId::kMisc: valid = entry.index == 0 && assign(m_misc, entry); break;
+		default: valid = true; break; // Unknown sections are ignored
+		}
+		if (!valid)
+		{
+			return;
+		}
+	}
+
+	// Validate the indices so that the accessors never point outside the buffer
+	for (std::size_t lane = 0; lane < kNumLaserLanesSZ; ++lane)
+	{
+		const std::size_t numPoints = m_laserPoints[lane].size;
+		for (const auto& section : m_laserSections[lane].span())
+		{
+			if (section.pointIdx > numPoints || section.numPoints > numPoints - section.pointIdx)
+			{
+				return;
+			}
+		}
+	}
+	if (m_stringIndex.size % 2 != 0)
+	{
+		return;
+	}
+	for (std::size_t i = 0; i < m_stringIndex.size; i += 2)
+	{
+		const std::uint64_t offset = m_stringIndex.pData[i];
+		const std::uint64_t size = m_stringIndex.pData[i + 1];
+		if (offset > m_stringData.size || size > m_stringData.size - offset)
+		{
+			return;
+		}
+	}
+
+	m_error = ErrorType::None;
+}
+
+std::string_view kson::KsonBinChartView::string(std::size_t idx) const
+{
+	if (idx >= numStrings())
+	{
+		return {};
+	}
+	return { m_stringData.pData + m_stringIndex.pData[idx * 2], static_cast<std::size_t>(m_stringIndex.pData[idx * 2 + 1]) };
+}
+
+kson::ErrorType kson::SaveKsonBinChartData(std::ostream& stream, const ChartData& chartData)
+{
+	if constexpr (!kIsLittleEndian)
+	{
+		return ErrorType::UnknownError;
+	}
+
+	if (!stream.good())
+	{
+		return ErrorType::GeneralIOError;
+	}
+
+	const std::string file = BuildKsonBinFile(chartData);
+	stream.write(file.data(), static_cast<std::streamsize>(file.size()));
+
+	return stream.good() ? ErrorType::None : ErrorType::GeneralIOError;
+}
+
+kson::ErrorType kson::SaveKsonBinChartData(const std::string& filePath, const ChartData& chartData)
+{
+	std::ofstream ofs(U8Path(filePath), std::ios_base::binary);
+	if (!ofs.good())
+	{
+		return ErrorType::CouldNotOpenOutputFileStream;
+	}
+	return kson::SaveKsonBinChartData(ofs, chartData);
+}
+
+kson::ChartData kson::LoadKsonBinChartData(std::span<const char> buffer)
+{
+	const KsonBinChartView view(buffer);
+	if (view.error() != ErrorType::None)
+	{
+		return { .error = view.error() };
+	}
+
+	ChartData chartData;
+
+	for (const auto& v : view.bpm())
+	{
+		chartData.beat.bpm.emplace_hint(chartData.beat.bpm.end(), v.y, v.v);
+	}
+	for (const auto& v : view.timeSig())
+	{
+		chartData.beat.timeSig.emplace_hint(chartData.beat.timeSig.end(), v.measureIdx, TimeSig{ .n = v.n, .d = v.d });
+	}
+	for (const auto& point : view.scrollSpeed())
+	{
+		chartData.beat.scrollSpeed.emplace_hint(chartData.beat.scrollSpeed.end(), point.y, ToGraphPoint(point));
+	}
+	for (const auto& v : view.stop())
+	{
+		chartData.beat.stop.emplace_hint(chartData.beat.stop.end(), v.y, v.length);
+	}
+
+	for (std::size_t i = 0; i < kNumBTLanesSZ; ++i)
+	{
+		auto& lane = chartData.note.bt[i];
+		for (const auto& note : view.bt(i))
+		{
+			lane.emplace_hint(lane.end(), note.y, Interval{ .length = note.length });
+		}
+	}
+	for (std::size_t i = 0; i < kNumFXLanesSZ; ++i)
+	{
+		auto& lane = chartData.note.fx[i];
+		for (const auto& note : view.fx(i))
+		{
+			lane.emplace_hint(lane.end(), note.y, Interval{ .length = note.length });
+		}
+	}
+	for (std::size_t i = 0; i < kNumLaserLanesSZ; ++i)
+	{
+		auto& lane = chartData.note.laser[i];
+		for (const auto& section : view.laserSections(i))
+		{
+			LaserSection& laserSection = lane.emplace_hint(lane.end(), section.y, LaserSection{})->second;
+			laserSection.w = section.w;
+			for (const auto& point : view.laserPoints(i, section))
+			{
+				laserSection.v.emplace_hint(laserSection.v.end(), point.y, ToGraphPoint(point));
+			}
+		}
+	}
+
+	{
+		CamGraphs& body = chartData.camera.cam.body;
+		const std::array<Graph*, kNumKsonBinCamGraphs> graphs = { &body.zoomBottom, &body.zoomSide, &body.zoomTop, &body.rotationDeg, &body.centerSplit };
+		for (std::size_t i = 0; i < graphs.size(); ++i)
+		{
+			for (const auto& point : view.camGraph(static_cast<KsonBinCamGraph>(i)))
+			{
+				graphs[i]->emplace_hint(graphs[i]->end(), point.y, ToGraphPoint(point));
+			}
+		}
+	}
+
+	MiscReader reader(view.miscData(), view);
+	TransferMisc(reader, chartData);
+	std::string impl;
+	reader(impl);
+	if (!reader.succeeded())
+	{
+		return { .error = ErrorType::KsonBinParseError };
+	}
+#ifndef KSON_WITHOUT_JSON_DEPENDENCY
+	chartData.impl = nlohmann::json::parse(impl, nullptr, false);
+	if (chartData.impl.is_discarded())
+	{
+		return { .error = ErrorType::KsonBinParseError };
+	}
+#endif
+
+	return chartData;
+}
+
+kson::ChartData kson::LoadKsonBinChartData(std::istream& stream)
+{
+	if (!stream.good())
+	{
+		return { .error = ErrorType::GeneralIOError };
+	}
+
+	std::size_t size = 0;
+	const std::vector<std::uint64_t> buffer = ReadAllAligned(stream, &size);
+	return kson::LoadKsonBinChartData(std::span<const char>(reinterpret_cast<const char*>(buffer.data()), size));
+}
+
+kson::ChartData kson::LoadKsonBinChartData(const std::string& filePath)
+{
+	const auto fsPath = U8Path(filePath);
+	if (!std::filesystem::exists(fsPath))
+	{
+		return { .error = ErrorType::FileNotFound };
+	}
+
+	std::ifstream ifs(fsPath, std::ios_base::binary);
+	if (!ifs.good())
+	{
+		return { .error = ErrorType::CouldNotOpenInputFileStream };
+	}
+	return kson::LoadKsonBinChartData(ifs);
+}
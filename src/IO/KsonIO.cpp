@@ -3,8 +3,13 @@
 #include <filesystem>
 #include <fstream>
 #include <optional>
+#include <array>
+#include <string_view>
 #include <limits>
 #include <cmath>
+#include <algorithm>
+#include <cassert>
+#include <charconv>
 
 namespace
 {
@@ -18,64 +23,291 @@ namespace
 
 	// Note: Since to_json() overload makes it difficult to find minor bugs
 	//       (e.g., ByPulse<T> shouldn't be converted as std::map, Pulse and RelPulse shouldn't be the same),
-	//       we write our own conversion functions here.
+	//       we write our own serialization functions here.
 
-#ifdef __cpp_concepts
-	template <class T>
-	concept Serializable = requires (nlohmann::json & json, const T & d)
+	// Streams JSON tokens directly in the same format as nlohmann::json::dump(-1) without building a DOM
+	// Note: Keys must be written in ascending order because nlohmann::json objects are sorted by key.
+	//       Objects are opened lazily and omitted entirely if nothing is written to them, whereas arrays are always written.
+	class KsonJsonWriter
 	{
-		json = d;
+	private:
+		static constexpr std::size_t kInitialCapacity = 64 * 1024;
+
+		struct Scope
+		{
+			bool isArray = false;
+
+			bool hasKey = false;
+
+			std::string_view key;
+
+			bool hasElement = false;
+
+			std::string_view lastKey;
+		};
+
+		std::string m_buffer;
+
+		nlohmann::detail::serializer<nlohmann::json> m_serializer;
+
+		std::vector<Scope> m_scopes;
+
+		// Scopes after this index are pending objects whose opening tokens are not written yet
+		std::size_t m_numOpenScopes = 0U;
+
+		bool m_afterKey = false;
+
+		void writeString(std::string_view str)
+		{
+			const bool isPlain = std::all_of(str.begin(), str.end(), [](char c) { return c >= 0x20 && c <= 0x7E && c != '"' && c != '\\'; });
+			if (isPlain)
+			{
+				m_buffer.push_back('"');
+				m_buffer.append(str);
+				m_buffer.push_back('"');
+			}
+			else
+			{
+				// Leave escaping and invalid UTF-8 replacement to nlohmann::json so that the output stays identical
+				m_serializer.dump(nlohmann::json(nlohmann::json::string_t(str)), false, false, 0U);
+			}
+		}
+
+		void writeSeparator(Scope& parent)
+		{
+			if (parent.hasElement)
+			{
+				m_buffer.push_back(',');
+			}
+			parent.hasElement = true;
+		}
+
+		void writeKey(Scope& parent, std::string_view key)
+		{
+			assert(!parent.isArray);
+			assert(!parent.hasElement || parent.lastKey < key);
+			writeSeparator(parent);
+			parent.lastKey = key;
+			writeString(key);
+			m_buffer.push_back(':');
+		}
+
+		void openPendingScopes()
+		{
+			while (m_numOpenScopes < m_scopes.size())
+			{
+				if (m_numOpenScopes > 0U)
+				{
+					Scope& parent = m_scopes[m_numOpenScopes - 1U];
+					const Scope& scope = m_scopes[m_numOpenScopes];
+					if (scope.hasKey)
+					{
+						writeKey(parent, scope.key);
+					}
+					else
+					{
+						writeSeparator(parent);
+					}
+				}
+				m_buffer.push_back('{');
+				++m_numOpenScopes;
+			}
+		}
+
+		void beginValue()
+		{
+			if (m_afterKey)
+			{
+				m_afterKey = false;
+				return;
+			}
+
+			openPendingScopes();
+			if (!m_scopes.empty())
+			{
+				assert(m_scopes.back().isArray);
+				writeSeparator(m_scopes.back());
+			}
+		}
+
+	public:
+		KsonJsonWriter()
+			: m_serializer(nlohmann::detail::output_adapter<char>(m_buffer), ' ', nlohmann::detail::error_handler_t::replace)
+		{
+			m_buffer.reserve(kInitialCapacity);
+		}
+
+		void beginObject()
+		{
+			assert(!m_afterKey);
+			m_scopes.push_back({ .isArray = false });
+		}
+
+		void beginObject(std::string_view key)
+		{
+			assert(!m_afterKey);
+			m_scopes.push_back({ .isArray = false, .hasKey = true, .key = key });
+		}
+
+		// Returns false if the object was omitted because it was empty
+		bool endObject()
+		{
+			assert(!m_scopes.empty() && !m_scopes.back().isArray);
+			const bool isOpen = m_numOpenScopes == m_scopes.size();
+			if (isOpen)
+			{
+				m_buffer.push_back('}');
+				--m_numOpenScopes;
+			}
+			m_scopes.pop_back();
+			return isOpen;
+		}
+
+		void beginArray()
+		{
+			beginValue();
+			m_scopes.push_back({ .isArray = true });
+			m_buffer.push_back('[');
+			++m_numOpenScopes;
+		}
+
+		void beginArray(std::string_view key)
+		{
+			this->key(key);
+			beginArray();
+		}
+
+		void endArray()
+		{
+			assert(!m_scopes.empty() && m_scopes.back().isArray);
+			m_buffer.push_back(']');
+			--m_numOpenScopes;
+			m_scopes.pop_back();
+		}
+
+		void key(std::string_view key)
+		{
+			assert(!m_afterKey);
+			openPendingScopes();
+			writeKey(m_scopes.back(), key);
+			m_afterKey = true;
+		}
+
+		template <typename T>
+		void value(const T& v)
+		{
+			beginValue();
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				m_buffer.append(v ? "true" : "false");
+			}
+			else if constexpr (std::is_same_v<T, std::nullptr_t>)
+			{
+				m_buffer.append("null");
+			}
+			else if constexpr (std::is_integral_v<T>)
+			{
+				std::array<char, 24> buf;
+				const auto [ptr, ec] = std::to_chars(buf.data(), buf.data() + buf.size(), v);
+				m_buffer.append(buf.data(), ptr);
+			}
+			else if constexpr (std::is_floating_point_v<T>)
+			{
+				// Use the same shortest round-trip representation as nlohmann::json (e.g., "1.0", "null" for NaN)
+				m_serializer.dump(nlohmann::json(static_cast<double>(v)), false, false, 0U);
+			}
+			else if constexpr (std::is_same_v<T, nlohmann::json>)
+			{
+				m_serializer.dump(v, false, false, 0U);
+			}
+			else
+			{
+				writeString(std::string_view(v));
+			}
+		}
+
+		[[nodiscard]]
+		std::string_view view() const
+		{
+			assert(m_scopes.empty());
+			return m_buffer;
+		}
 	};
-#endif
 
-	void Write(nlohmann::json& json, const char* key, nlohmann::json&& value)
+	template <typename T>
+	std::vector<const typename std::unordered_map<std::string, T>::value_type*> SortedByKey(const std::unordered_map<std::string, T>& map)
 	{
-		if (!value.is_object() || !value.empty())
+		std::vector<const typename std::unordered_map<std::string, T>::value_type*> sorted;
+		sorted.reserve(map.size());
+		for (const auto& kvp : map)
 		{
-			json.emplace(key, std::move(value)); // Note: json becomes object if it is null
+			sorted.push_back(&kvp);
 		}
+		std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+		return sorted;
+	}
+
+	template <typename Lanes>
+	bool AllLanesEmpty(const Lanes& lanes)
+	{
+		return std::all_of(lanes.begin(), lanes.end(), [](const auto& lane) { return lane.empty(); });
 	}
 
-#ifdef __cpp_concepts
-	template <Serializable T>
-#else
 	template <typename T>
-#endif
-	void Write(nlohmann::json& json, const char* key, const T& value)
+	void Write(KsonJsonWriter& writer, std::string_view key, const T& value)
 	{
-		if constexpr (
-			std::is_same_v<T, std::string> ||
-			std::is_integral_v<T>)
+		writer.key(key);
+		if constexpr (std::is_floating_point_v<T>)
 		{
-			json.emplace(key, value);
+			writer.value(RemoveFloatingPointError(value));
 		}
-		else if constexpr (std::is_floating_point_v<T>)
+		else
 		{
-			json.emplace(key, RemoveFloatingPointError(value));
+			writer.value(value);
 		}
-		else if constexpr (std::is_same_v<T, nlohmann::json>)
+	}
+
+	void Write(KsonJsonWriter& writer, std::string_view key, const nlohmann::json& value)
+	{
+		if (!value.is_object() || !value.empty())
 		{
-			if (!value.is_object() || !value.empty())
-			{
-				json.emplace(key, value);
-			}
+			writer.key(key);
+			writer.value(value);
 		}
-		else
+	}
+
+	void Write(KsonJsonWriter& writer, std::string_view key, const std::vector<std::string>& value)
+	{
+		writer.beginArray(key);
+		for (const auto& str : value)
 		{
-			nlohmann::json valueJSON = value;
-			if (!valueJSON.is_object() || !valueJSON.empty())
-			{
-				json.emplace(key, std::move(valueJSON));
-			}
+			writer.value(str);
+		}
+		writer.endArray();
+	}
+
+	void Write(KsonJsonWriter& writer, std::string_view key, const Dict<std::string>& value)
+	{
+		writer.beginObject(key);
+		for (const auto& [k, v] : value)
+		{
+			Write(writer, k, v);
+		}
+		writer.endObject();
+	}
+
+	void Write(KsonJsonWriter& writer, std::string_view key, const std::unordered_map<std::string, std::string>& value)
+	{
+		writer.beginObject(key);
+		for (const auto* pKVP : SortedByKey(value))
+		{
+			Write(writer, pKVP->first, pKVP->second);
 		}
+		writer.endObject();
 	}
 
-#ifdef __cpp_concepts
-	template <Serializable T, typename U>
-#else
 	template <typename T, typename U>
-#endif
-	void Write(nlohmann::json& json, const char* key, const T& value, const U& defaultValue)
+	void Write(KsonJsonWriter& writer, std::string_view key, const T& value, const U& defaultValue)
 	{
 		if constexpr (std::is_floating_point_v<T>)
 		{
@@ -83,166 +315,144 @@ namespace
 
 			if (!AlmostEquals(value, defaultValue))
 			{
-				Write(json, key, value);
+				Write(writer, key, value);
 			}
 		}
 		else
 		{
 			if (value != defaultValue)
 			{
-				Write(json, key, value);
+				Write(writer, key, value);
 			}
 		}
 	}
 
-#ifdef __cpp_concepts
-	template <Serializable T>
-#else
 	template <typename T>
-#endif
-	void WriteByPulseElement(nlohmann::json& arrayJSON, Pulse y, const T& value) // Note: y could be ry
+	void WriteByPulseElement(KsonJsonWriter& writer, Pulse y, const T& value) // Note: y could be ry
 	{
-		if constexpr (
-			std::is_same_v<T, std::string> ||
-			std::is_integral_v<T>)
+		static_assert(std::is_same_v<T, std::string> || std::is_arithmetic_v<T>);
+
+		writer.beginArray();
+		writer.value(y);
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			writer.value(RemoveFloatingPointError(value));
+		}
+		else
 		{
-			arrayJSON.push_back(nlohmann::json::array({ y, value }));
+			writer.value(value);
 		}
-		else if constexpr (std::is_floating_point_v<T>)
+		writer.endArray();
+	}
+
+	void WriteByPulseElement(KsonJsonWriter& writer, Pulse y, const AudioEffectParams& value)
+	{
+		// Skip empty objects
+		if (value.empty())
 		{
-			arrayJSON.push_back(nlohmann::json::array({ y, RemoveFloatingPointError(value) }));
+			writer.value(y);
+			return;
 		}
-		else if constexpr (std::is_same_v<T, nlohmann::json>)
+
+		writer.beginArray();
+		writer.value(y);
+		writer.beginObject();
+		for (const auto& [k, v] : value)
 		{
-			if (value.is_object() && value.empty())
-			{
-				arrayJSON.push_back(y);
-			}
-			else
-			{
-				arrayJSON.push_back(nlohmann::json::array({ y, value }));
-			}
+			Write(writer, k, v);
 		}
-		else
+		writer.endObject();
+		writer.endArray();
+	}
+
+	void WriteByPulseElement(KsonJsonWriter& writer, Pulse y, const KeySoundInvokeFX& value)
+	{
+		// Skip empty objects
+		if (AlmostEquals(value.vol, 1.0))
 		{
-			nlohmann::json valueJSON = value;
-			if (valueJSON.is_object() && valueJSON.empty())
-			{
-				arrayJSON.push_back(y);
-			}
-			else
-			{
-				arrayJSON.push_back(nlohmann::json::array({ y, std::move(valueJSON) }));
-			}
+			writer.value(y);
+			return;
 		}
+
+		writer.beginArray();
+		writer.value(y);
+		writer.beginObject();
+		Write(writer, "vol", value.vol);
+		writer.endObject();
+		writer.endArray();
 	}
 
-#ifdef __cpp_concepts
-	template <Serializable T, typename U>
-#else
 	template <typename T, typename U>
-#endif
-	void WriteByPulseElement(nlohmann::json& arrayJSON, Pulse y, const T& value, const U& defaultValue) // Note: y could be ry
+	void WriteByPulseElement(KsonJsonWriter& writer, Pulse y, const T& value, const U& defaultValue) // Note: y could be ry
 	{
-		if constexpr (
-			std::is_same_v<T, std::string> ||
-			std::is_integral_v<T>)
+		bool isDefault;
+		if constexpr (std::is_floating_point_v<T>)
 		{
-			if (value == defaultValue)
-			{
-				arrayJSON.push_back(y);
-			}
-			else
-			{
-				arrayJSON.push_back(nlohmann::json::array({ y, value }));
-			}
+			static_assert(std::is_same_v<T, U>);
+			isDefault = AlmostEquals(value, defaultValue);
+		}
+		else
+		{
+			isDefault = value == defaultValue;
 		}
-		else if constexpr (std::is_floating_point_v<T>)
+
+		if (isDefault)
 		{
-			static_assert(std::is_same_v<T, U>);
-			
-			if (AlmostEquals(value, defaultValue))
-			{
-				arrayJSON.push_back(y);
-			}
-			else
-			{
-				arrayJSON.push_back(nlohmann::json::array({ y, RemoveFloatingPointError(value) }));
-			}
+			writer.value(y);
 		}
 		else
 		{
-			if (value == defaultValue)
-			{
-				arrayJSON.push_back(y);
-			}
-			else
-			{
-				// Pass to a no-default-value version of WriteByPulseElement in order to skip empty objects and empty arrays in addition to the defaults
-				WriteByPulseElement(arrayJSON, y, value);
-			}
+			WriteByPulseElement(writer, y, value);
 		}
 	}
 
-	void WriteGraphPoint(nlohmann::json& graphJSON, Pulse y, const GraphPoint& point) // Note: y could be ry
+	void WriteGraphPoint(KsonJsonWriter& writer, Pulse y, const GraphPoint& point) // Note: y could be ry
 	{
 		const bool hasCurve = !point.curve.isLinear();
 		const bool hasGraphValue = !AlmostEquals(point.v.v, point.v.vf);
 
-		if (!hasCurve)
+		// [y, v], [y, [v, vf]], [y, v, [a, b]] or [y, [v, vf], [a, b]]
+		writer.beginArray();
+		writer.value(y);
+		if (hasGraphValue)
 		{
-			// No curve: [y, v] or [y, [v, vf]]
-			if (hasGraphValue)
-			{
-				graphJSON.push_back(nlohmann::json::array({ y, nlohmann::json::array({ RemoveFloatingPointError(point.v.v), RemoveFloatingPointError(point.v.vf) }) }));
-			}
-			else
-			{
-				graphJSON.push_back(nlohmann::json::array({ y, RemoveFloatingPointError(point.v.v) }));
-			}
+			writer.beginArray();
+			writer.value(RemoveFloatingPointError(point.v.v));
+			writer.value(RemoveFloatingPointError(point.v.vf));
+			writer.endArray();
 		}
 		else
 		{
-			// With curve: [y, v, [a, b]] or [y, [v, vf], [a, b]]
-			nlohmann::json curveArray = nlohmann::json::array({ RemoveFloatingPointError(point.curve.a), RemoveFloatingPointError(point.curve.b) });
-
-			if (hasGraphValue)
-			{
-				graphJSON.push_back(nlohmann::json::array({ y, nlohmann::json::array({ RemoveFloatingPointError(point.v.v), RemoveFloatingPointError(point.v.vf) }), curveArray }));
-			}
-			else
-			{
-				graphJSON.push_back(nlohmann::json::array({ y, RemoveFloatingPointError(point.v.v), curveArray }));
-			}
+			writer.value(RemoveFloatingPointError(point.v.v));
+		}
+		if (hasCurve)
+		{
+			writer.beginArray();
+			writer.value(RemoveFloatingPointError(point.curve.a));
+			writer.value(RemoveFloatingPointError(point.curve.b));
+			writer.endArray();
 		}
+		writer.endArray();
 	}
 
-#ifdef __cpp_concepts
-	template <Serializable T>
-#else
 	template <typename T>
-#endif
-	void WriteByPulse(nlohmann::json& json, const char* key, const ByPulse<T>& byPulse)
+	void WriteByPulse(KsonJsonWriter& writer, std::string_view key, const ByPulse<T>& byPulse)
 	{
 		if (byPulse.empty())
 		{
 			return;
 		}
 
-		nlohmann::json& j = json[key];
-		j = nlohmann::json::array();
+		writer.beginArray(key);
 		for (const auto& [y, v] : byPulse)
 		{
-			WriteByPulseElement(j, y, v);
+			WriteByPulseElement(writer, y, v);
 		}
+		writer.endArray();
 	}
 
-#ifdef __cpp_concepts
-	template <Serializable T>
-#else
 	template <typename T>
-#endif
-	void WriteByPulse(nlohmann::json& json, const char* key, const ByPulse<T>& byPulse, const T& defaultValue)
+	void WriteByPulse(KsonJsonWriter& writer, std::string_view key, const ByPulse<T>& byPulse, const T& defaultValue)
 	{
 		bool allDefaultOrEmpty = true;
 		for (const auto& [y, v] : byPulse)
@@ -269,30 +479,26 @@ namespace
 			return;
 		}
 
-		WriteByPulse(json, key, byPulse);
+		WriteByPulse(writer, key, byPulse);
 	}
 
-#ifdef __cpp_concepts
-	template <Serializable T>
-#else
 	template <typename T>
-#endif
-	void WriteByPulseMulti(nlohmann::json& json, const char* key, const ByPulseMulti<T>& byPulse)
+	void WriteByPulseMulti(KsonJsonWriter& writer, std::string_view key, const ByPulseMulti<T>& byPulse)
 	{
 		if (byPulse.empty())
 		{
 			return;
 		}
 
-		nlohmann::json& j = json[key];
-		j = nlohmann::json::array();
+		writer.beginArray(key);
 		for (const auto& [y, v] : byPulse)
 		{
-			WriteByPulseElement(j, y, v);
+			WriteByPulseElement(writer, y, v);
 		}
+		writer.endArray();
 	}
 
-	void WriteTimeSigByMeasureIdx(nlohmann::json& json, const char* key, const ByMeasureIdx<TimeSig>& byMeasureIdx)
+	void WriteTimeSigByMeasureIdx(KsonJsonWriter& writer, std::string_view key, const ByMeasureIdx<TimeSig>& byMeasureIdx)
 	{
 		if (byMeasureIdx.empty())
 		{
@@ -308,108 +514,97 @@ namespace
 			return;
 		}
 
-		nlohmann::json& j = json[key];
-		j = nlohmann::json::array();
+		writer.beginArray(key);
 		for (const auto& [idx, timeSig] : byMeasureIdx)
 		{
-			j.push_back(nlohmann::json::array({
-				idx,
-				nlohmann::json::array({ timeSig.n, timeSig.d }),
-			}));
+			writer.beginArray();
+			writer.value(idx);
+			writer.beginArray();
+			writer.value(timeSig.n);
+			writer.value(timeSig.d);
+			writer.endArray();
+			writer.endArray();
 		}
+		writer.endArray();
 	}
 
 	template <std::size_t N>
-	void WriteButtonLanes(nlohmann::json& json, const char* key, const std::array<ByPulse<Interval>, N>& lanes)
+	void WriteButtonLanes(KsonJsonWriter& writer, std::string_view key, const std::array<ByPulse<Interval>, N>& lanes)
 	{
 		// Skip if empty
-		bool allEmpty = true;
-		for (std::size_t i = 0U; i < N; ++i)
-		{
-			if (!lanes[i].empty())
-			{
-				allEmpty = false;
-				break;
-			}
-		}
-		if (allEmpty)
+		if (AllLanesEmpty(lanes))
 		{
 			return;
 		}
 
-		nlohmann::json& j = json[key];
-		j = nlohmann::json::array();
-		for (std::size_t i = 0U; i < N; ++i)
+		writer.beginArray(key);
+		for (const auto& lane : lanes)
 		{
-			nlohmann::json& a = j.emplace_back(nlohmann::json::array());
-			for (const auto& [y, interval] : lanes[i])
+			writer.beginArray();
+			for (const auto& [y, interval] : lane)
 			{
-				WriteByPulseElement(a, y, interval.length, 0);
+				WriteByPulseElement(writer, y, interval.length, 0);
 			}
+			writer.endArray();
 		}
+		writer.endArray();
 	}
 
-	void WriteLaserLanes(nlohmann::json& json, const char* key, const LaserLane<LaserSection>& lanes)
+	void WriteLaserLanes(KsonJsonWriter& writer, std::string_view key, const LaserLane<LaserSection>& lanes)
 	{
 		// Skip if empty
-		bool allEmpty = true;
-		for (std::size_t i = 0U; i < kNumLaserLanesSZ; ++i)
-		{
-			if (!lanes[i].empty())
-			{
-				allEmpty = false;
-				break;
-			}
-		}
-		if (allEmpty)
+		if (AllLanesEmpty(lanes))
 		{
 			return;
 		}
 
-		nlohmann::json& j = json[key];
-		for (std::size_t i = 0U; i < kNumLaserLanesSZ; ++i)
+		writer.beginArray(key);
+		for (const auto& lane : lanes)
 		{
-			nlohmann::json& laneJSON = j.emplace_back(nlohmann::json::array());
-			for (const auto& [y, laserSection] : lanes[i])
+			writer.beginArray();
+			for (const auto& [y, laserSection] : lane)
 			{
 				if (laserSection.v.empty())
 				{
 					continue;
 				}
 
-				nlohmann::json a = nlohmann::json::array();
+				// [y, [points]] or [y, [points], w]
+				writer.beginArray();
+				writer.value(y);
+				writer.beginArray();
 				for (const auto& [ry, v] : laserSection.v)
 				{
-					WriteGraphPoint(a, ry, v);
-				}
-				if (laserSection.w == kLaserXScale1x)
-				{
-					laneJSON.push_back(nlohmann::json::array({ y, std::move(a) }));
+					WriteGraphPoint(writer, ry, v);
 				}
-				else
+				writer.endArray();
+				if (laserSection.w != kLaserXScale1x)
 				{
-					laneJSON.push_back(nlohmann::json::array({ y, std::move(a), laserSection.w }));
+					writer.value(laserSection.w);
 				}
+				writer.endArray();
 			}
+			writer.endArray();
 		}
+		writer.endArray();
 	}
 
-	void WriteGraph(nlohmann::json& json, const char* key, const Graph& graph)
+	void WriteGraph(KsonJsonWriter& writer, std::string_view key, const Graph& graph)
 	{
 		if (graph.empty())
 		{
 			return;
 		}
 
-		nlohmann::json& j = json[key];
-		j = nlohmann::json::array();
+		writer.beginArray(key);
 		for (const auto& [y, v] : graph)
 		{
-			WriteGraphPoint(j, y, v);
+			WriteGraphPoint(writer, y, v);
 		}
+		writer.endArray();
 	}
 
-	void WriteGraph(nlohmann::json& json, const char* key, const Graph& graph, double defaultValue)
+	void WriteGraph(KsonJsonWriter& writer, std::string_view key, const Graph& graph, double defaultValue)
 	{
 		bool allDefaultOrEmpty = true;
 		for (const auto& [y, point] : graph)
@@ -425,35 +620,39 @@ namespace
 			return;
 		}
 
-		WriteGraph(json, key, graph);
+		WriteGraph(writer, key, graph);
 	}
 
-	void WriteAudioEffectDef(nlohmann::json& json, const char* key, const std::vector<AudioEffectDefKVP>& def)
+	void WriteAudioEffectDef(KsonJsonWriter& writer, std::string_view key, const std::vector<AudioEffectDefKVP>& def)
 	{
 		if (def.empty())
 		{
 			return;
 		}
 
-		nlohmann::json& j = json[key];
+		writer.beginArray(key);
 		for (const auto& kvp : def)
 		{
-			nlohmann::json defJSON = {
-				{ "type", AudioEffectTypeToStr(kvp.v.type) },
-			};
-			Write(defJSON, "v", kvp.v.v);
-			j.push_back(nlohmann::json::array({ kvp.name, std::move(defJSON) }));
+			writer.beginArray();
+			writer.value(kvp.name);
+			writer.beginObject();
+			Write(writer, "type", AudioEffectTypeToStr(kvp.v.type));
+			Write(writer, "v", kvp.v.v);
+			writer.endObject();
+			writer.endArray();
 		}
+		writer.endArray();
 	}
 
-	void WriteAudioEffectParamChange(nlohmann::json& json, const char* key, const Dict<Dict<ByPulse<std::string>>>& paramChange)
+	void WriteAudioEffectParamChange(KsonJsonWriter& writer, std::string_view key, const Dict<Dict<ByPulse<std::string>>>& paramChange)
 	{
 		if (paramChange.empty())
 		{
 			return;
 		}
 
-		nlohmann::json& j1 = json[key];
+		// Note: Objects left without any entries are written as null rather than omitted for compatibility with the previous DOM-based output
+		writer.beginObject(key);
 		for (const auto& [audioEffectName, params] : paramChange)
 		{
 			if (params.empty())
@@ -461,182 +660,243 @@ namespace
 				continue;
 			}
 
-			nlohmann::json& j2 = j1[audioEffectName];
+			writer.beginObject(audioEffectName);
 			for (const auto& [paramName, byPulse] : params)
 			{
-				WriteByPulse(j2, paramName.c_str(), byPulse);
+				WriteByPulse(writer, paramName, byPulse);
+			}
+			if (!writer.endObject())
+			{
+				Write(writer, audioEffectName, nullptr);
 			}
 		}
+		if (!writer.endObject())
+		{
+			Write(writer, key, nullptr);
+		}
 	}
 
-	void WriteCamPatternInvokeSpinByPulse(nlohmann::json& json, const char* key, const ByPulse<CamPatternInvokeSpin>& byPulse)
+	void WriteCamPatternInvokeSpinByPulse(KsonJsonWriter& writer, std::string_view key, const ByPulse<CamPatternInvokeSpin>& byPulse)
 	{
 		if (byPulse.empty())
 		{
 			return;
 		}
 
-		nlohmann::json& j = json[key];
-		j = nlohmann::json::array();
+		writer.beginArray(key);
 		for (const auto& [y, invoke] : byPulse)
 		{
-			j.push_back(nlohmann::json::array({ y, invoke.d, invoke.length }));
+			writer.beginArray();
+			writer.value(y);
+			writer.value(invoke.d);
+			writer.value(invoke.length);
+			writer.endArray();
 		}
+		writer.endArray();
 	}
 
-	void WriteCamPatternInvokeSwingByPulse(nlohmann::json& json, const char* key, const ByPulse<CamPatternInvokeSwing>& byPulse)
+	void WriteCamPatternInvokeSwingByPulse(KsonJsonWriter& writer, std::string_view key, const ByPulse<CamPatternInvokeSwing>& byPulse)
 	{
 		if (byPulse.empty())
 		{
 			return;
 		}
 
-		nlohmann::json& j = json[key];
-		j = nlohmann::json::array();
+		writer.beginArray(key);
 		for (const auto& [y, invoke] : byPulse)
 		{
-			nlohmann::json vJSON = nlohmann::json::object();
-			{
-				Write(vJSON, "scale", invoke.v.scale, 250.0);
-				Write(vJSON, "repeat", invoke.v.repeat, 3);
-				Write(vJSON, "decay_order", invoke.v.decayOrder, 2);
-			}
-			if (vJSON.empty())
-			{
-				j.push_back(nlohmann::json::array({ y, invoke.d, invoke.length }));
-			}
-			else
+			// [y, d, length] or [y, d, length, v]
+			writer.beginArray();
+			writer.value(y);
+			writer.value(invoke.d);
+			writer.value(invoke.length);
+			writer.beginObject();
 			{
-				j.push_back(nlohmann::json::array({ y, invoke.d, invoke.length, std::move(vJSON) }));
+				Write(writer, "decay_order", invoke.v.decayOrder, 2);
+				Write(writer, "repeat", invoke.v.repeat, 3);
+				Write(writer, "scale", invoke.v.scale, 250.0);
 			}
+			writer.endObject();
+			writer.endArray();
 		}
+		writer.endArray();
 	}
 
-	nlohmann::json ToJSON(const MetaInfo& d)
+	void Write(KsonJsonWriter& writer, std::string_view key, const MetaInfo& d)
 	{
-		nlohmann::json j = nlohmann::json::object();
-		Write(j, "title", d.title);
-		Write(j, "title_translit", d.titleTranslit, "");
-		Write(j, "title_img_filename", d.titleImgFilename, "");
-		Write(j, "artist", d.artist);
-		Write(j, "artist_translit", d.artistTranslit, "");
-		Write(j, "artist_img_filename", d.artistImgFilename, "");
-		Write(j, "chart_author", d.chartAuthor);
+		writer.beginObject(key);
+		Write(writer, "artist", d.artist);
+		Write(writer, "artist_img_filename", d.artistImgFilename, "");
+		Write(writer, "artist_translit", d.artistTranslit, "");
+		Write(writer, "chart_author", d.chartAuthor);
 		if (d.difficulty.name.empty())
 		{
-			Write(j, "difficulty", d.difficulty.idx);
+			Write(writer, "difficulty", d.difficulty.idx);
 		}
 		else
 		{
-			Write(j, "difficulty", d.difficulty.name);
+			Write(writer, "difficulty", d.difficulty.name);
 		}
-		Write(j, "level", d.level);
-		Write(j, "disp_bpm", d.dispBPM);
-		Write(j, "std_bpm", d.stdBPM, 0.0);
-		Write(j, "jacket_filename", d.jacketFilename, "");
-		Write(j, "jacket_author", d.jacketAuthor, "");
-		Write(j, "icon_filename", d.iconFilename, "");
-		Write(j, "information", d.information, "");
-		return j;
+		Write(writer, "disp_bpm", d.dispBPM);
+		Write(writer, "icon_filename", d.iconFilename, "");
+		Write(writer, "information", d.information, "");
+		Write(writer, "jacket_author", d.jacketAuthor, "");
+		Write(writer, "jacket_filename", d.jacketFilename, "");
+		Write(writer, "level", d.level);
+		Write(writer, "std_bpm", d.stdBPM, 0.0);
+		Write(writer, "title", d.title);
+		Write(writer, "title_img_filename", d.titleImgFilename, "");
+		Write(writer, "title_translit", d.titleTranslit, "");
+		writer.endObject();
 	}
 
-	nlohmann::json ToJSON(const BeatInfo& d)
+	void Write(KsonJsonWriter& writer, std::string_view key, const BeatInfo& d)
 	{
-		nlohmann::json j = nlohmann::json::object();
-		WriteByPulse(j, "bpm", d.bpm);
-		WriteTimeSigByMeasureIdx(j, "time_sig", d.timeSig);
-		WriteGraph(j, "scroll_speed", d.scrollSpeed, 1.0);
-		WriteByPulse(j, "stop", d.stop);
-		return j;
+		writer.beginObject(key);
+		WriteByPulse(writer, "bpm", d.bpm);
+		WriteGraph(writer, "scroll_speed", d.scrollSpeed, 1.0);
+		WriteByPulse(writer, "stop", d.stop);
+		WriteTimeSigByMeasureIdx(writer, "time_sig", d.timeSig);
+		writer.endObject();
 	}
 
-	nlohmann::json ToJSON(const GaugeInfo& d)
+	void Write(KsonJsonWriter& writer, std::string_view key, const GaugeInfo& d)
 	{
-		nlohmann::json j = nlohmann::json::object();
-		Write(j, "total", d.total, 0);
-		return j;
+		writer.beginObject(key);
+		Write(writer, "total", d.total, 0);
+		writer.endObject();
 	}
 
-	nlohmann::json ToJSON(const NoteInfo& d)
+	void Write(KsonJsonWriter& writer, std::string_view key, const NoteInfo& d)
 	{
-		nlohmann::json j = nlohmann::json::object();
-		WriteButtonLanes(j, "bt", d.bt);
-		WriteButtonLanes(j, "fx", d.fx);
-		WriteLaserLanes(j, "laser", d.laser);
-		return j;
+		writer.beginObject(key);
+		WriteButtonLanes(writer, "bt", d.bt);
+		WriteButtonLanes(writer, "fx", d.fx);
+		WriteLaserLanes(writer, "laser", d.laser);
+		writer.endObject();
 	}
 
-	nlohmann::json ToJSON(const AudioInfo& d)
+	void Write(KsonJsonWriter& writer, std::string_view key, const AudioInfo& d)
 	{
-		nlohmann::json j = nlohmann::json::object();
+		writer.beginObject(key);
+		writer.beginObject("audio_effect");
+		{
+			writer.beginObject("fx");
+			WriteAudioEffectDef(writer, "def", d.audioEffect.fx.def);
+			{
+				writer.beginObject("long_event");
+				for (const auto& [audioEffectName, lanes] : d.audioEffect.fx.longEvent)
+				{
+					if (AllLanesEmpty(lanes))
+					{
+						continue;
+					}
+
+					writer.beginArray(audioEffectName);
+					for (const auto& lane : lanes)
+					{
+						writer.beginArray();
+						for (const auto& [y, v] : lane)
+						{
+							WriteByPulseElement(writer, y, v);
+						}
+						writer.endArray();
+					}
+					writer.endArray();
+				}
+				writer.endObject();
+			}
+			WriteAudioEffectParamChange(writer, "param_change", d.audioEffect.fx.paramChange);
+			writer.endObject();
+		}
 		{
-			nlohmann::json bgmJSON = nlohmann::json::object();
-			Write(bgmJSON, "filename", d.bgm.filename, "");
-			Write(bgmJSON, "vol", d.bgm.vol, 1.0);
-			Write(bgmJSON, "offset", d.bgm.offset, 0);
+			writer.beginObject("laser");
+			WriteAudioEffectDef(writer, "def", d.audioEffect.laser.def);
+			{
+				writer.beginObject("legacy");
+				WriteByPulse(writer, "filter_gain", d.audioEffect.laser.legacy.filterGain, 0.5);
+				writer.endObject();
+			}
+			WriteAudioEffectParamChange(writer, "param_change", d.audioEffect.laser.paramChange);
+			Write(writer, "peaking_filter_delay", d.audioEffect.laser.peakingFilterDelay, 0);
 			{
-				nlohmann::json previewJSON = nlohmann::json::object();
-				Write(previewJSON, "offset", d.bgm.preview.offset);
-				Write(previewJSON, "duration", d.bgm.preview.duration);
-				Write(bgmJSON, "preview", std::move(previewJSON));
+				writer.beginObject("pulse_event");
+				for (const auto& [audioEffectName, pulseSet] : d.audioEffect.laser.pulseEvent)
+				{
+					if (pulseSet.empty())
+					{
+						continue;
+					}
+
+					writer.beginArray(audioEffectName);
+					for (const Pulse& pulse : pulseSet)
+					{
+						writer.value(pulse);
+					}
+					writer.endArray();
+				}
+				writer.endObject();
 			}
+			writer.endObject();
+		}
+		writer.endObject();
+		writer.beginObject("bgm");
+		{
+			Write(writer, "filename", d.bgm.filename, "");
 			{
-				nlohmann::json legacyJSON = nlohmann::json::object();
+				writer.beginObject("legacy");
 				if (!d.bgm.legacy.empty())
 				{
-					Write(legacyJSON, "fp_filenames", d.bgm.legacy.toStrArray());
+					Write(writer, "fp_filenames", d.bgm.legacy.toStrArray());
 				}
-				Write(bgmJSON, "legacy", std::move(legacyJSON));
+				writer.endObject();
+			}
+			Write(writer, "offset", d.bgm.offset, 0);
+			{
+				writer.beginObject("preview");
+				Write(writer, "duration", d.bgm.preview.duration);
+				Write(writer, "offset", d.bgm.preview.offset);
+				writer.endObject();
 			}
-			Write(j, "bgm", std::move(bgmJSON));
+			Write(writer, "vol", d.bgm.vol, 1.0);
 		}
+		writer.endObject();
+		writer.beginObject("key_sound");
 		{
-			nlohmann::json keySoundJSON = nlohmann::json::object();
 			{
-				nlohmann::json fxJSON = nlohmann::json::object();
+				writer.beginObject("fx");
+				writer.beginObject("chip_event");
+				for (const auto& [filename, lanes] : d.keySound.fx.chipEvent)
 				{
-					nlohmann::json chipEventJSON = nlohmann::json::object();
-					for (const auto& [filename, lanes] : d.keySound.fx.chipEvent)
+					if (AllLanesEmpty(lanes))
 					{
-						bool isEmpty = true;
-						for (const auto& lane : lanes)
-						{
-							if (!lane.empty())
-							{
-								isEmpty = false;
-								break;
-							}
-						}
-						if (isEmpty)
-						{
-							continue;
-						}
+						continue;
+					}
 
-						nlohmann::json lanesJSON = nlohmann::json::array();
-						for (const auto& lane : lanes)
+					writer.beginArray(filename);
+					for (const auto& lane : lanes)
+					{
+						writer.beginArray();
+						for (const auto& [y, v] : lane)
 						{
-							nlohmann::json laneJSON = nlohmann::json::array();
-							for (const auto& [y, v] : lane)
-							{
-								nlohmann::json vJSON = nlohmann::json::object();
-								{
-									Write(vJSON, "vol", v.vol, 1.0);
-								}
-								WriteByPulseElement(laneJSON, y, vJSON);
-							}
-							lanesJSON.push_back(std::move(laneJSON));
+							WriteByPulseElement(writer, y, v);
 						}
-						chipEventJSON.emplace(filename, std::move(lanesJSON));
+						writer.endArray();
 					}
-					Write(fxJSON, "chip_event", std::move(chipEventJSON));
+					writer.endArray();
 				}
-				Write(keySoundJSON, "fx", std::move(fxJSON));
+				writer.endObject();
+				writer.endObject();
 			}
 			{
-				nlohmann::json laserJSON = nlohmann::json::object();
-				WriteByPulse(laserJSON, "vol", d.keySound.laser.vol, 0.5);
+				writer.beginObject("laser");
+				{
+					writer.beginObject("legacy");
+					Write(writer, "vol_auto", d.keySound.laser.legacy.volAuto, false);
+					writer.endObject();
+				}
 				{
-					nlohmann::json slamEventJSON = nlohmann::json::object();
+					writer.beginObject("slam_event");
 					for (const auto& [filename, pulseSet] : d.keySound.laser.slamEvent)
 					{
 						if (pulseSet.empty())
@@ -644,96 +904,21 @@ namespace
 							continue;
 						}
 
-						nlohmann::json& pulseSetJSON = slamEventJSON[filename];
-						pulseSetJSON = nlohmann::json::array();
+						writer.beginArray(filename);
 						for (const auto& y : pulseSet)
 						{
-							pulseSetJSON.push_back(y);
+							writer.value(y);
 						}
+						writer.endArray();
 					}
-					Write(laserJSON, "slam_event", std::move(slamEventJSON));
+					writer.endObject();
 				}
-				{
-					nlohmann::json legacy = nlohmann::json::object();
-					Write(legacy, "vol_auto", d.keySound.laser.legacy.volAuto, false);
-					Write(laserJSON, "legacy", std::move(legacy));
-				}
-				Write(keySoundJSON, "laser", std::move(laserJSON));
-			}
-			Write(j, "key_sound", std::move(keySoundJSON));
-		}
-		{
-			nlohmann::json audioEffectJSON = nlohmann::json::object();
-			{
-				nlohmann::json fxJSON = nlohmann::json::object();
-				WriteAudioEffectDef(fxJSON, "def", d.audioEffect.fx.def);
-				WriteAudioEffectParamChange(fxJSON, "param_change", d.audioEffect.fx.paramChange);
-				{
-					nlohmann::json longEventJSON = nlohmann::json::object();
-					for (const auto& [audioEffectName, lanes] : d.audioEffect.fx.longEvent)
-					{
-						bool isEmpty = true;
-						for (const auto& lane : lanes)
-						{
-							if (!lane.empty())
-							{
-								isEmpty = false;
-								break;
-							}
-						}
-						if (isEmpty)
-						{
-							continue;
-						}
-
-						nlohmann::json& lanesJSON = longEventJSON[audioEffectName];
-						for (const auto& lane : lanes)
-						{
-							nlohmann::json& laneJSON = lanesJSON.emplace_back(nlohmann::json::array());
-							for (const auto& [y, v] : lane)
-							{
-								WriteByPulseElement(laneJSON, y, v);
-							}
-						}
-					}
-					Write(fxJSON, "long_event", std::move(longEventJSON));
-				}
-				Write(audioEffectJSON, "fx", std::move(fxJSON));
-			}
-			{
-				nlohmann::json laserJSON = nlohmann::json::object();
-				WriteAudioEffectDef(laserJSON, "def", d.audioEffect.laser.def);
-				WriteAudioEffectParamChange(laserJSON, "param_change", d.audioEffect.laser.paramChange);
-				{
-					nlohmann::json pulseEvent = nlohmann::json::object();
-					for (const auto& [audioEffectName, pulseSet] : d.audioEffect.laser.pulseEvent)
-					{
-						if (pulseSet.empty())
-						{
-							continue;
-						}
-
-						nlohmann::json pulseSetJSON = nlohmann::json::array();
-						for (const Pulse& pulse : pulseSet)
-						{
-							pulseSetJSON.push_back(pulse);
-						}
-						pulseEvent.emplace(audioEffectName, std::move(pulseSetJSON));
-					}
-					Write(laserJSON, "pulse_event", std::move(pulseEvent));
-				}
-				Write(laserJSON, "peaking_filter_delay", d.audioEffect.laser.peakingFilterDelay, 0);
-				{
-					nlohmann::json legacyJSON = nlohmann::json::object();
-					WriteByPulse(legacyJSON, "filter_gain", d.audioEffect.laser.legacy.filterGain, 0.5);
-					Write(laserJSON, "legacy", std::move(legacyJSON));
-				}
-				Write(audioEffectJSON, "laser", std::move(laserJSON));
+				WriteByPulse(writer, "vol", d.keySound.laser.vol, 0.5);
+				writer.endObject();
 			}
-			Write(j, "audio_effect", std::move(audioEffectJSON));
 		}
-
-		return j;
+		writer.endObject();
+		writer.endObject();
 	}
 
 	const char* AutoTiltTypeToString(AutoTiltType type)
@@ -751,15 +936,15 @@ namespace
 		}
 	}
 
-	void WriteTiltValue(nlohmann::json& arrayJSON, Pulse pulse, const TiltValue& tiltValue)
+	void WriteTiltValue(KsonJsonWriter& writer, Pulse pulse, const TiltValue& tiltValue)
 	{
-		nlohmann::json entry = nlohmann::json::array();
-		entry.push_back(pulse);
+		writer.beginArray();
+		writer.value(pulse);
 
 		if (std::holds_alternative<AutoTiltType>(tiltValue))
 		{
 			// Auto tilt type: [pulse, "string"]
-			entry.push_back(AutoTiltTypeToString(std::get<AutoTiltType>(tiltValue)));
+			writer.value(AutoTiltTypeToString(std::get<AutoTiltType>(tiltValue)));
 		}
 		else if (std::holds_alternative<TiltGraphPoint>(tiltValue))
 		{
@@ -783,58 +968,60 @@ namespace
 				// Ignore curve when vf is AutoTiltType
 				if (std::holds_alternative<AutoTiltType>(point.v.vf))
 				{
-					nlohmann::json graphValue = nlohmann::json::array();
-					graphValue.push_back(RemoveFloatingPointError(point.v.v));
-					graphValue.push_back(AutoTiltTypeToString(std::get<AutoTiltType>(point.v.vf)));
-					entry.push_back(std::move(graphValue));
+					writer.beginArray();
+					writer.value(RemoveFloatingPointError(point.v.v));
+					writer.value(AutoTiltTypeToString(std::get<AutoTiltType>(point.v.vf)));
+					writer.endArray();
 				}
 				else
 				{
-					nlohmann::json graphValue = nlohmann::json::array();
-					graphValue.push_back(RemoveFloatingPointError(point.v.v));
-					graphValue.push_back(RemoveFloatingPointError(std::get<double>(point.v.vf)));
-					nlohmann::json curveValue = nlohmann::json::array({
-						RemoveFloatingPointError(point.curve.a),
-						RemoveFloatingPointError(point.curve.b)
-					});
-					entry.push_back(nlohmann::json::array({ std::move(graphValue), std::move(curveValue) }));
+					// With curve and graph value: [pulse, [[v, vf], [a, b]]]
+					writer.beginArray();
+					writer.beginArray();
+					writer.value(RemoveFloatingPointError(point.v.v));
+					writer.value(RemoveFloatingPointError(std::get<double>(point.v.vf)));
+					writer.endArray();
+					writer.beginArray();
+					writer.value(RemoveFloatingPointError(point.curve.a));
+					writer.value(RemoveFloatingPointError(point.curve.b));
+					writer.endArray();
+					writer.endArray();
 				}
 			}
 			else if (hasCurve)
 			{
 				// With curve only: [pulse, [v, [a, b]]]
-				nlohmann::json curveValue = nlohmann::json::array({
-					RemoveFloatingPointError(point.curve.a),
-					RemoveFloatingPointError(point.curve.b)
-				});
-				entry.push_back(nlohmann::json::array({
-					RemoveFloatingPointError(point.v.v),
-					curveValue
-				}));
+				writer.beginArray();
+				writer.value(RemoveFloatingPointError(point.v.v));
+				writer.beginArray();
+				writer.value(RemoveFloatingPointError(point.curve.a));
+				writer.value(RemoveFloatingPointError(point.curve.b));
+				writer.endArray();
+				writer.endArray();
 			}
 			else if (hasGraphValue)
 			{
 				// GraphValue without curve: [pulse, [v, vf]]
-				nlohmann::json graphValue = nlohmann::json::array();
-				graphValue.push_back(RemoveFloatingPointError(point.v.v));
+				writer.beginArray();
+				writer.value(RemoveFloatingPointError(point.v.v));
 				if (std::holds_alternative<double>(point.v.vf))
 				{
-					graphValue.push_back(RemoveFloatingPointError(std::get<double>(point.v.vf)));
+					writer.value(RemoveFloatingPointError(std::get<double>(point.v.vf)));
 				}
 				else
 				{
-					graphValue.push_back(AutoTiltTypeToString(std::get<AutoTiltType>(point.v.vf)));
+					writer.value(AutoTiltTypeToString(std::get<AutoTiltType>(point.v.vf)));
 				}
-				entry.push_back(graphValue);
+				writer.endArray();
 			}
 			else
 			{
 				// Simple value: [pulse, double]
-				entry.push_back(RemoveFloatingPointError(point.v.v));
+				writer.value(RemoveFloatingPointError(point.v.v));
 			}
 		}
 
-		arrayJSON.push_back(entry);
+		writer.endArray();
 	}
 
 	bool IsTiltDefaultOnly(const ByPulse<TiltValue>& tilt)
@@ -850,123 +1037,118 @@ namespace
 			std::get<AutoTiltType>(tilt.at(0)) == AutoTiltType::kNormal;
 	}
 
-	nlohmann::json ToJSON(const CameraInfo& d)
+	void Write(KsonJsonWriter& writer, std::string_view key, const CameraInfo& d)
 	{
-		nlohmann::json j = nlohmann::json::object();
-		if (!IsTiltDefaultOnly(d.tilt))
+		writer.beginObject(key);
 		{
-			nlohmann::json tiltJSON = nlohmann::json::array();
-			for (const auto& [pulse, tiltValue] : d.tilt)
+			writer.beginObject("cam");
 			{
-				WriteTiltValue(tiltJSON, pulse, tiltValue);
+				writer.beginObject("body");
+				WriteGraph(writer, "center_split", d.cam.body.centerSplit, 0.0);
+				WriteGraph(writer, "rotation_deg", d.cam.body.rotationDeg, 0.0);
+				WriteGraph(writer, "zoom_bottom", d.cam.body.zoomBottom, 0.0);
+				WriteGraph(writer, "zoom_side", d.cam.body.zoomSide, 0.0);
+				WriteGraph(writer, "zoom_top", d.cam.body.zoomTop, 0.0);
+				writer.endObject();
 			}
-			Write(j, "tilt", std::move(tiltJSON));
-		}
-		{
-			nlohmann::json camJSON = nlohmann::json::object();
 			{
-				nlohmann::json bodyJSON = nlohmann::json::object();
-				WriteGraph(bodyJSON, "zoom_bottom", d.cam.body.zoomBottom, 0.0);
-				WriteGraph(bodyJSON, "zoom_side", d.cam.body.zoomSide, 0.0);
-				WriteGraph(bodyJSON, "zoom_top", d.cam.body.zoomTop, 0.0);
-				WriteGraph(bodyJSON, "rotation_deg", d.cam.body.rotationDeg, 0.0);
-				WriteGraph(bodyJSON, "center_split", d.cam.body.centerSplit, 0.0);
-				Write(camJSON, "body", bodyJSON);
+				writer.beginObject("pattern");
+				writer.beginObject("laser");
+				writer.beginObject("slam_event");
+				WriteCamPatternInvokeSpinByPulse(writer, "half_spin", d.cam.pattern.laser.slamEvent.halfSpin);
+				WriteCamPatternInvokeSpinByPulse(writer, "spin", d.cam.pattern.laser.slamEvent.spin);
+				WriteCamPatternInvokeSwingByPulse(writer, "swing", d.cam.pattern.laser.slamEvent.swing);
+				writer.endObject();
+				writer.endObject();
+				writer.endObject();
 			}
+			writer.endObject();
+		}
+		if (!IsTiltDefaultOnly(d.tilt))
+		{
+			writer.beginArray("tilt");
+			for (const auto& [pulse, tiltValue] : d.tilt)
 			{
-				nlohmann::json patternJSON = nlohmann::json::object();
-				{
-					nlohmann::json laserJSON = nlohmann::json::object();
-					{
-						nlohmann::json slamEventJSON = nlohmann::json::object();
-						WriteCamPatternInvokeSpinByPulse(slamEventJSON, "spin", d.cam.pattern.laser.slamEvent.spin);
-						WriteCamPatternInvokeSpinByPulse(slamEventJSON, "half_spin", d.cam.pattern.laser.slamEvent.halfSpin);
-						WriteCamPatternInvokeSwingByPulse(slamEventJSON, "swing", d.cam.pattern.laser.slamEvent.swing);
-						Write(laserJSON, "slam_event", std::move(slamEventJSON));
-					}
-					Write(patternJSON, "laser", std::move(laserJSON));
-				}
-				Write(camJSON, "pattern", std::move(patternJSON));
+				WriteTiltValue(writer, pulse, tiltValue);
 			}
-			Write(j, "cam", std::move(camJSON));
+			writer.endArray();
 		}
-		return j;
+		writer.endObject();
 	}
 
-	nlohmann::json ToJSON(const BGInfo& d)
+	void Write(KsonJsonWriter& writer, std::string_view key, const BGInfo& d)
 	{
-		nlohmann::json j = nlohmann::json::object();
+		writer.beginObject(key);
 		{
-			Write(j, "filename", d.filename, "");
-			nlohmann::json legacyJSON = nlohmann::json::object();
+			Write(writer, "filename", d.filename, "");
+			writer.beginObject("legacy");
 			{
-				nlohmann::json bgJSON = nlohmann::json::array();
-				if (!d.legacy.bg[0].filename.empty())
-				{
-					bgJSON.push_back({
-						{ "filename", d.legacy.bg[0].filename },
-					});
-				}
-				if (!d.legacy.bg[1].filename.empty() && d.legacy.bg[0].filename != d.legacy.bg[1].filename)
+				writer.beginArray("bg");
+				for (std::size_t i = 0U; i < d.legacy.bg.size(); ++i)
 				{
-					bgJSON.push_back({
-						{ "filename", d.legacy.bg[1].filename },
-					});
+					const std::string& filename = d.legacy.bg[i].filename;
+					if (filename.empty() || (i > 0U && filename == d.legacy.bg[0].filename))
+					{
+						continue;
+					}
+
+					writer.beginObject();
+					Write(writer, "filename", filename);
+					writer.endObject();
 				}
-				Write(legacyJSON, "bg", std::move(bgJSON));
+				writer.endArray();
 			}
 			{
-				nlohmann::json layerJSON = nlohmann::json::object();
-				Write(layerJSON, "filename", d.legacy.layer.filename, "");
-				Write(layerJSON, "duration", d.legacy.layer.duration, 0);
+				writer.beginObject("layer");
+				Write(writer, "duration", d.legacy.layer.duration, 0);
+				Write(writer, "filename", d.legacy.layer.filename, "");
 				{
-					nlohmann::json rotationJSON = nlohmann::json::object();
-					Write(rotationJSON, "tilt", d.legacy.layer.rotation.tilt, true);
-					Write(rotationJSON, "spin", d.legacy.layer.rotation.spin, true);
-					Write(layerJSON, "rotation", std::move(rotationJSON));
+					writer.beginObject("rotation");
+					Write(writer, "spin", d.legacy.layer.rotation.spin, true);
+					Write(writer, "tilt", d.legacy.layer.rotation.tilt, true);
+					writer.endObject();
 				}
-				Write(legacyJSON, "layer", std::move(layerJSON));
+				writer.endObject();
 			}
 			{
-				nlohmann::json movieJSON = nlohmann::json::object();
-				Write(movieJSON, "filename", d.legacy.movie.filename, "");
-				Write(movieJSON, "offset", d.legacy.movie.offset, 0);
-				Write(legacyJSON, "movie", std::move(movieJSON));
+				writer.beginObject("movie");
+				Write(writer, "filename", d.legacy.movie.filename, "");
+				Write(writer, "offset", d.legacy.movie.offset, 0);
+				writer.endObject();
 			}
-			Write(j, "legacy", std::move(legacyJSON));
+			writer.endObject();
 		}
-		return j;
+		writer.endObject();
 	}
 
-	nlohmann::json ToJSON(const EditorInfo& d)
+	void Write(KsonJsonWriter& writer, std::string_view key, const EditorInfo& d)
 	{
-
-		nlohmann::json j = nlohmann::json::object();
-		Write(j, "app_name", d.appName, "");
-		Write(j, "app_version", d.appVersion, "");
-		WriteByPulseMulti(j, "comment", d.comment);
-		return j;
+		writer.beginObject(key);
+		Write(writer, "app_name", d.appName, "");
+		Write(writer, "app_version", d.appVersion, "");
+		WriteByPulseMulti(writer, "comment", d.comment);
+		writer.endObject();
 	}
 
-	nlohmann::json ToJSON(const CompatInfo& d)
+	void Write(KsonJsonWriter& writer, std::string_view key, const CompatInfo& d)
 	{
-		nlohmann::json j = nlohmann::json::object();
-		Write(j, "ksh_version", d.kshVersion, "");
+		writer.beginObject(key);
 		{
-			nlohmann::json kshUnknownJSON = nlohmann::json::object();
-			Write(kshUnknownJSON, "meta", d.kshUnknown.meta);
+			writer.beginObject("ksh_unknown");
+			WriteByPulseMulti(writer, "line", d.kshUnknown.line);
+			Write(writer, "meta", d.kshUnknown.meta);
 			{
-				nlohmann::json optionJSON = nlohmann::json::object();
-				for (const auto& [key, value] : d.kshUnknown.option)
+				writer.beginObject("option");
+				for (const auto* pKVP : SortedByKey(d.kshUnknown.option))
 				{
-					WriteByPulseMulti(optionJSON, key.c_str(), value);
+					WriteByPulseMulti(writer, pKVP->first, pKVP->second);
 				}
-				Write(kshUnknownJSON, "option", std::move(optionJSON));
+				writer.endObject();
 			}
-			WriteByPulseMulti(kshUnknownJSON, "line", d.kshUnknown.line);
-			Write(j, "ksh_unknown", std::move(kshUnknownJSON));
+			writer.endObject();
 		}
-		return j;
+		Write(writer, "ksh_version", d.kshVersion, "");
+		writer.endObject();
 	}
 
 	// ==================== Reading/Loading Implementation ====================
@@ -1603,7 +1785,7 @@ namespace
 			{
 				if (pulses.is_array())
 				{
-					std::set<Pulse> pulseSet;
+					PulseSet pulseSet;
 					for (const auto& pulse : pulses)
 					{
 						if (pulse.is_number_integer())
@@ -1708,7 +1890,7 @@ namespace
 			{
 				if (pulses.is_array())
 				{
-					std::set<Pulse> pulseSet;
+					PulseSet pulseSet;
 					for (const auto& pulse : pulses)
 					{
 						if (pulse.is_number_integer())
@@ -2103,20 +2285,24 @@ kson::ErrorType kson::SaveKsonChartData(std::ostream& stream, const ChartData& c
 
 	try
 	{
-		nlohmann::json json = nlohmann::json::object();
-		Write(json, "format_version", kKsonFormatVersion);
-		Write(json, "meta", ToJSON(chartData.meta));
-		Write(json, "beat", ToJSON(chartData.beat));
-		Write(json, "gauge", ToJSON(chartData.gauge));
-		Write(json, "note", ToJSON(chartData.note));
-		Write(json, "audio", ToJSON(chartData.audio));
-		Write(json, "camera", ToJSON(chartData.camera));
-		Write(json, "bg", ToJSON(chartData.bg));
-		Write(json, "editor", ToJSON(chartData.editor));
-		Write(json, "compat", ToJSON(chartData.compat));
-		Write(json, "impl", chartData.impl);
-
-		stream << json.dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace);
+		// Note: Keys are written in ascending order as nlohmann::json::dump() does
+		KsonJsonWriter writer;
+		writer.beginObject();
+		Write(writer, "audio", chartData.audio);
+		Write(writer, "beat", chartData.beat);
+		Write(writer, "bg", chartData.bg);
+		Write(writer, "camera", chartData.camera);
+		Write(writer, "compat", chartData.compat);
+		Write(writer, "editor", chartData.editor);
+		Write(writer, "format_version", kKsonFormatVersion);
+		Write(writer, "gauge", chartData.gauge);
+		Write(writer, "impl", chartData.impl);
+		Write(writer, "meta", chartData.meta);
+		Write(writer, "note", chartData.note);
+		writer.endObject();
+
+		const std::string_view json = writer.view();
+		stream.write(json.data(), static_cast<std::streamsize>(json.size()));
 
 		return stream.good() ? ErrorType::None : ErrorType::GeneralIOError;
 	}
@@ -2138,34 +2324,12 @@ kson::ErrorType kson::SaveKsonChartData(const std::string& filePath, const Chart
 
 namespace
 {
-	bool ValidateAndParseKsonJson(
-		std::istream& stream,
-		nlohmann::json* pOutJson,
+	bool ValidateFormatVersion(
+		const nlohmann::json* pFormatVersion,
 		ErrorType* pOutError,
 		KsonLoadingDiag* pKsonDiag)
 	{
-		if (!stream.good())
-		{
-			*pOutError = ErrorType::GeneralIOError;
-			return false;
-		}
-
-		try
-		{
-			stream >> *pOutJson;
-		}
-		catch (const nlohmann::json::parse_error& e)
-		{
-			*pOutError = ErrorType::KsonParseError;
-			pKsonDiag->warnings.push_back({
-				.type = KsonLoadingWarningType::JsonParseError,
-				.scope = WarningScope::PlayerAndEditor,
-				.message = "JSON parse error: " + std::string(e.what()),
-			});
-			return false;
-		}
-
-		if (!pOutJson->contains("format_version"))
+		if (pFormatVersion == nullptr)
 		{
 			*pOutError = ErrorType::KsonParseError;
 			pKsonDiag->warnings.push_back({
@@ -2176,7 +2340,7 @@ namespace
 			return false;
 		}
 
-		if (!(*pOutJson)["format_version"].is_number_integer())
+		if (!pFormatVersion->is_number_integer())
 		{
 			*pOutError = ErrorType::KsonParseError;
 			pKsonDiag->warnings.push_back({
@@ -2187,7 +2351,7 @@ namespace
 			return false;
 		}
 
-		const std::int32_t formatVersion = (*pOutJson)["format_version"].get<std::int32_t>();
+		const std::int32_t formatVersion = pFormatVersion->get<std::int32_t>();
 		if (formatVersion > kKsonFormatVersion)
 		{
 			std::ostringstream oss;
@@ -2201,95 +2365,959 @@ namespace
 
 		return true;
 	}
-}
 
-kson::ChartData kson::LoadKsonChartData(std::istream& stream, KsonLoadingDiag* pKsonDiag)
-{
-	KsonLoadingDiag localDiag;
-	if (!pKsonDiag)
+	// Error caught while loading a section
+	struct KsonSectionError
 	{
-		pKsonDiag = &localDiag;
+		ErrorType error;
+		KsonLoadingWarning warning;
+	};
+
+	// Note: This must be called inside a catch block
+	KsonSectionError CurrentExceptionToSectionError()
+	{
+		try
+		{
+			throw;
+		}
+		catch (const nlohmann::json::parse_error& e)
+		{
+			return {
+				.error = ErrorType::KsonParseError,
+				.warning = {
+					.type = KsonLoadingWarningType::JsonParseError,
+					.scope = WarningScope::PlayerAndEditor,
+					.message = "JSON parse error: " + std::string(e.what()),
+				},
+			};
+		}
+		catch (const nlohmann::json::type_error& e)
+		{
+			return {
+				.error = ErrorType::KsonParseError,
+				.warning = {
+					.type = KsonLoadingWarningType::JsonTypeError,
+					.scope = WarningScope::PlayerAndEditor,
+					.message = "JSON type error: " + std::string(e.what()),
+				},
+			};
+		}
+		catch (const std::exception& e)
+		{
+			return {
+				.error = ErrorType::UnknownError,
+				.warning = {
+					.type = KsonLoadingWarningType::UnexpectedError,
+					.scope = WarningScope::PlayerAndEditor,
+					.message = "Unexpected error: " + std::string(e.what()),
+				},
+			};
+		}
 	}
 
-	ChartData chartData;
+	// Builds a JSON value from SAX events in the same way as nlohmann::json's DOM parser
+	class JsonValueBuilder
+	{
+	private:
+		nlohmann::json m_root;
 
-	try
+		std::vector<nlohmann::json*> m_refStack;
+
+		nlohmann::json* m_pObjectElement = nullptr;
+
+		template <typename Value>
+		nlohmann::json* handleValue(Value&& value)
+		{
+			if (m_refStack.empty())
+			{
+				m_root = nlohmann::json(std::forward<Value>(value));
+				return &m_root;
+			}
+
+			if (m_refStack.back()->is_array())
+			{
+				return &m_refStack.back()->emplace_back(std::forward<Value>(value));
+			}
+
+			*m_pObjectElement = nlohmann::json(std::forward<Value>(value));
+			return m_pObjectElement;
+		}
+
+	public:
+		template <typename Value>
+		void value(Value&& value)
+		{
+			handleValue(std::forward<Value>(value));
+		}
+
+		void startObject()
+		{
+			m_refStack.push_back(handleValue(nlohmann::json::value_t::object));
+		}
+
+		void startArray()
+		{
+			m_refStack.push_back(handleValue(nlohmann::json::value_t::array));
+		}
+
+		void key(const std::string& key)
+		{
+			m_pObjectElement = &(*m_refStack.back())[key];
+		}
+
+		void endContainer()
+		{
+			m_refStack.pop_back();
+		}
+
+		[[nodiscard]]
+		bool isComplete() const
+		{
+			return m_refStack.empty();
+		}
+
+		[[nodiscard]]
+		nlohmann::json release()
+		{
+			m_pObjectElement = nullptr;
+			return std::move(m_root);
+		}
+	};
+
+	// Sections of ChartData in the order of loading in the DOM-based loader
+	// Note: Warnings and errors are reported in this order regardless of the key order in the file
+	enum KsonSectionIdx : std::size_t
+	{
+		kKsonSectionIdxMeta = 0,
+		kKsonSectionIdxBeat,
+		kKsonSectionIdxGauge,
+		kKsonSectionIdxNoteBT,
+		kKsonSectionIdxNoteFX,
+		kKsonSectionIdxNoteLaser,
+		kKsonSectionIdxAudio,
+		kKsonSectionIdxCamera,
+		kKsonSectionIdxBG,
+		kKsonSectionIdxEditor,
+		kKsonSectionIdxCompat,
+
+		kNumKsonSections,
+	};
+
+	enum class JsonSaxEvent
+	{
+		kValue,
+		kStartObject,
+		kStartArray,
+		kEndObject,
+		kEndArray,
+		kKey,
+	};
+
+	// Implements the nlohmann::json SAX interface by forwarding every callback to Derived::onEvent
+	// Note: onEvent receives a function that applies the event to a JsonValueBuilder, so that the derived class can capture the value.
+	//       It also receives the key string for JsonSaxEvent::kKey.
+	template <typename Derived>
+	class JsonSaxForwarder
 	{
-		nlohmann::json j;
-		if (!ValidateAndParseKsonJson(stream, &j, &chartData.error, pKsonDiag))
+	private:
+		template <typename Forward>
+		bool forwardEvent(JsonSaxEvent event, Forward forward, const std::string* pKey = nullptr)
+		{
+			return static_cast<Derived*>(this)->onEvent(event, forward, pKey);
+		}
+
+	public:
+		bool null()
+		{
+			return forwardEvent(JsonSaxEvent::kValue, [](JsonValueBuilder& b) { b.value(nullptr); });
+		}
+
+		bool boolean(bool value)
+		{
+			return forwardEvent(JsonSaxEvent::kValue, [value](JsonValueBuilder& b) { b.value(value); });
+		}
+
+		bool number_integer(nlohmann::json::number_integer_t value)
+		{
+			return forwardEvent(JsonSaxEvent::kValue, [value](JsonValueBuilder& b) { b.value(value); });
+		}
+
+		bool number_unsigned(nlohmann::json::number_unsigned_t value)
 		{
-			return chartData;
+			return forwardEvent(JsonSaxEvent::kValue, [value](JsonValueBuilder& b) { b.value(value); });
 		}
 
-		if (j.contains("meta"))
+		bool number_float(nlohmann::json::number_float_t value, const nlohmann::json::string_t&)
 		{
-			chartData.meta = ParseMetaInfo(j["meta"], pKsonDiag);
+			return forwardEvent(JsonSaxEvent::kValue, [value](JsonValueBuilder& b) { b.value(value); });
 		}
 
-		if (j.contains("beat"))
+		bool string(nlohmann::json::string_t& value)
 		{
-			chartData.beat = ParseBeatInfo(j["beat"], pKsonDiag);
+			return forwardEvent(JsonSaxEvent::kValue, [&value](JsonValueBuilder& b) { b.value(std::move(value)); });
 		}
 
-		if (j.contains("gauge"))
+		bool binary(nlohmann::json::binary_t& value)
 		{
-			chartData.gauge = ParseGaugeInfo(j["gauge"], pKsonDiag);
+			return forwardEvent(JsonSaxEvent::kValue, [&value](JsonValueBuilder& b) { b.value(std::move(value)); });
 		}
 
-		if (j.contains("note"))
+		bool start_object(std::size_t)
 		{
-			chartData.note = ParseNoteInfo(j["note"], pKsonDiag);
+			return forwardEvent(JsonSaxEvent::kStartObject, [](JsonValueBuilder& b) { b.startObject(); });
 		}
 
-		if (j.contains("audio"))
+		bool key(nlohmann::json::string_t& key)
 		{
-			chartData.audio = ParseAudioInfo(j["audio"], pKsonDiag);
+			return forwardEvent(JsonSaxEvent::kKey, [&key](JsonValueBuilder& b) { b.key(key); }, &key);
 		}
 
-		if (j.contains("camera"))
+		bool end_object()
 		{
-			chartData.camera = ParseCameraInfo(j["camera"], pKsonDiag);
+			return forwardEvent(JsonSaxEvent::kEndObject, [](JsonValueBuilder& b) { b.endContainer(); });
 		}
 
-		if (j.contains("bg"))
+		bool start_array(std::size_t)
 		{
-			chartData.bg = ParseBGInfo(j["bg"], pKsonDiag);
+			return forwardEvent(JsonSaxEvent::kStartArray, [](JsonValueBuilder& b) { b.startArray(); });
 		}
 
-		if (j.contains("editor"))
+		bool end_array()
 		{
-			chartData.editor = ParseEditorInfo(j["editor"], pKsonDiag);
+			return forwardEvent(JsonSaxEvent::kEndArray, [](JsonValueBuilder& b) { b.endContainer(); });
 		}
 
-		if (j.contains("compat"))
+		template <class Exception>
+		bool parse_error(std::size_t, const std::string&, const Exception& ex)
 		{
-			chartData.compat = ParseCompatInfo(j["compat"], pKsonDiag);
+			throw ex;
 		}
+	};
+
+	// SAX handler that fills ChartData while parsing
+	// Note: Only one top-level section (or one note lane for "note") is held as a JSON value at a time,
+	//       so the whole document is never materialized as a DOM.
+	class KsonSaxLoader : public JsonSaxForwarder<KsonSaxLoader>
+	{
+	private:
+		friend JsonSaxForwarder<KsonSaxLoader>;
+
+		using Event = JsonSaxEvent;
+
+		enum class Position
+		{
+			kBeforeRoot,
+			kRoot,
+			kNote,
+			kNoteLanes,
+			kAudio,
+			kAfterRoot,
+		};
+
+		ChartData* m_pChartData;
+
+		ChartLoadingOptions m_options;
+
+		Position m_position = Position::kBeforeRoot;
+
+		bool m_isRootObject = false;
+
+		std::string m_topKey;
+
+		std::string m_noteKey;
+
+		std::size_t m_laneIdx = 0;
 
-		if (j.contains("impl"))
+		std::size_t m_capturedLaneIdx = 0;
+
+		std::string m_audioKey;
+
+		nlohmann::json m_audio; // "audio" without "audio_effect" if audio effects are not loaded
+
+		JsonValueBuilder m_builder;
+
+		bool m_isCapturing = false;
+
+		std::size_t m_skipDepth = 0;
+
+		std::optional<nlohmann::json> m_formatVersion;
+
+		std::array<KsonLoadingDiag, kNumKsonSections> m_sectionDiags;
+
+		std::array<std::optional<KsonSectionError>, kNumKsonSections> m_sectionErrors;
+
+		static std::optional<KsonSectionIdx> NoteLaneSectionIdx(std::string_view key)
 		{
-			chartData.impl = j["impl"];
+			if (key == "bt")
+			{
+				return kKsonSectionIdxNoteBT;
+			}
+			if (key == "fx")
+			{
+				return kKsonSectionIdxNoteFX;
+			}
+			if (key == "laser")
+			{
+				return kKsonSectionIdxNoteLaser;
+			}
+			return std::nullopt;
 		}
 
-		chartData.error = ErrorType::None;
+		static std::optional<KsonSectionIdx> TopLevelSectionIdx(std::string_view key)
+		{
+			if (key == "meta")
+			{
+				return kKsonSectionIdxMeta;
+			}
+			if (key == "beat")
+			{
+				return kKsonSectionIdxBeat;
+			}
+			if (key == "gauge")
+			{
+				return kKsonSectionIdxGauge;
+			}
+			if (key == "note")
+			{
+				return kKsonSectionIdxNoteBT;
+			}
+			if (key == "audio")
+			{
+				return kKsonSectionIdxAudio;
+			}
+			if (key == "camera")
+			{
+				return kKsonSectionIdxCamera;
+			}
+			if (key == "bg")
+			{
+				return kKsonSectionIdxBG;
+			}
+			if (key == "editor")
+			{
+				return kKsonSectionIdxEditor;
+			}
+			if (key == "compat")
+			{
+				return kKsonSectionIdxCompat;
+			}
+			return std::nullopt;
+		}
+
+		bool isSectionLoaded(KsonSectionIdx sectionIdx) const
+		{
+			switch (sectionIdx)
+			{
+			case kKsonSectionIdxBeat: return m_options.beat;
+			case kKsonSectionIdxNoteBT:
+			case kKsonSectionIdxNoteFX:
+			case kKsonSectionIdxNoteLaser: return m_options.note;
+			case kKsonSectionIdxCamera: return m_options.camera;
+			case kKsonSectionIdxBG: return m_options.bg;
+			case kKsonSectionIdxEditor: return m_options.editor;
+			case kKsonSectionIdxCompat: return m_options.compat;
+			default: return true;
+			}
+		}
+
+		void resetSection(KsonSectionIdx sectionIdx)
+		{
+			m_sectionDiags[sectionIdx].warnings.clear();
+			m_sectionErrors[sectionIdx].reset();
+
+			ChartData& chartData = *m_pChartData;
+			switch (sectionIdx)
+			{
+			case kKsonSectionIdxMeta: chartData.meta = MetaInfo{}; break;
+			case kKsonSectionIdxBeat: chartData.beat = BeatInfo{}; break;
+			case kKsonSectionIdxGauge: chartData.gauge = GaugeInfo{}; break;
+			case kKsonSectionIdxNoteBT: chartData.note.bt = {}; break;
+			case kKsonSectionIdxNoteFX: chartData.note.fx = {}; break;
+			case kKsonSectionIdxNoteLaser: chartData.note.laser = {}; break;
+			case kKsonSectionIdxAudio: chartData.audio = AudioInfo{}; break;
+			case kKsonSectionIdxCamera: chartData.camera = CameraInfo{}; break;
+			case kKsonSectionIdxBG: chartData.bg = BGInfo{}; break;
+			case kKsonSectionIdxEditor: chartData.editor = EditorInfo{}; break;
+			case kKsonSectionIdxCompat: chartData.compat = CompatInfo{}; break;
+			default: assert(false); break;
+			}
+		}
+
+		template <typename Func>
+		void loadSection(KsonSectionIdx sectionIdx, Func func)
+		{
+			try
+			{
+				func(&m_sectionDiags[sectionIdx]);
+			}
+			catch (const std::exception&)
+			{
+				m_sectionErrors[sectionIdx] = CurrentExceptionToSectionError();
+			}
+		}
+
+		void onTopLevelValue(nlohmann::json&& j)
+		{
+			ChartData& chartData = *m_pChartData;
+			if (m_topKey == "format_version")
+			{
+				m_formatVersion = std::move(j);
+				return;
+			}
+
+			if (m_topKey == "impl")
+			{
+				chartData.impl = std::move(j);
+				return;
+			}
+
+			const auto sectionIdx = TopLevelSectionIdx(m_topKey);
+			assert(sectionIdx.has_value());
+			if (*sectionIdx == kKsonSectionIdxNoteBT)
+			{
+				// "note" which is not an object
+				resetSection(kKsonSectionIdxNoteBT);
+				resetSection(kKsonSectionIdxNoteFX);
+				resetSection(kKsonSectionIdxNoteLaser);
+				loadSection(kKsonSectionIdxNoteBT, [&](KsonLoadingDiag* pDiag) { chartData.note = ParseNoteInfo(j, pDiag); });
+				return;
+			}
+
+			resetSection(*sectionIdx);
+			loadSection(*sectionIdx, [&](KsonLoadingDiag* pDiag)
+			{
+				switch (*sectionIdx)
+				{
+				case kKsonSectionIdxMeta: chartData.meta = ParseMetaInfo(j, pDiag); break;
+				case kKsonSectionIdxBeat: chartData.beat = ParseBeatInfo(j, pDiag); break;
+				case kKsonSectionIdxGauge: chartData.gauge = ParseGaugeInfo(j, pDiag); break;
+				case kKsonSectionIdxAudio:
+					chartData.audio = ParseAudioInfo(j, pDiag);
+					if (!m_options.note)
+					{
+						// Events attached to notes are not loaded without notes, as in the KSH loader
+						chartData.audio.keySound.fx.chipEvent.clear();
+						chartData.audio.keySound.laser.slamEvent.clear();
+						chartData.audio.audioEffect.fx.longEvent.clear();
+					}
+					break;
+				case kKsonSectionIdxCamera: chartData.camera = ParseCameraInfo(j, pDiag); break;
+				case kKsonSectionIdxBG: chartData.bg = ParseBGInfo(j, pDiag); break;
+				case kKsonSectionIdxEditor: chartData.editor = ParseEditorInfo(j, pDiag); break;
+				case kKsonSectionIdxCompat: chartData.compat = ParseCompatInfo(j, pDiag); break;
+				default: assert(false); break;
+				}
+			});
+		}
+
+		void onNoteLane(nlohmann::json&& j)
+		{
+			const auto sectionIdx = NoteLaneSectionIdx(m_noteKey);
+			assert(sectionIdx.has_value());
+
+			// Same as ParseNoteInfo, lanes after an error are not loaded
+			if (m_sectionErrors[*sectionIdx].has_value())
+			{
+				return;
+			}
+
+			NoteInfo& note = m_pChartData->note;
+			const std::size_t laneIdx = m_capturedLaneIdx;
+			loadSection(*sectionIdx, [&](KsonLoadingDiag* pDiag)
+			{
+				switch (*sectionIdx)
+				{
+				case kKsonSectionIdxNoteBT: ParseLaneNotes(j, note.bt[laneIdx], pDiag); break;
+				case kKsonSectionIdxNoteFX: ParseLaneNotes(j, note.fx[laneIdx], pDiag); break;
+				case kKsonSectionIdxNoteLaser: ParseLaserSection(j, note.laser[laneIdx], pDiag); break;
+				default: assert(false); break;
+				}
+			});
+		}
+
+		void onCaptured(nlohmann::json&& j)
+		{
+			if (m_position == Position::kNoteLanes)
+			{
+				onNoteLane(std::move(j));
+			}
+			else if (m_position == Position::kAudio)
+			{
+				m_audio[m_audioKey] = std::move(j);
+			}
+			else
+			{
+				onTopLevelValue(std::move(j));
+			}
+		}
+
+		std::size_t numLanes(std::string_view noteKey) const
+		{
+			const NoteInfo& note = m_pChartData->note;
+			if (noteKey == "bt")
+			{
+				return note.bt.size();
+			}
+			if (noteKey == "fx")
+			{
+				return note.fx.size();
+			}
+			return note.laser.size();
+		}
+
+		template <typename Forward>
+		void captureValue(Forward forward)
+		{
+			m_isCapturing = true;
+			m_builder = JsonValueBuilder{};
+			forward(m_builder);
+			if (m_builder.isComplete())
+			{
+				m_isCapturing = false;
+				onCaptured(m_builder.release());
+			}
+		}
+
+		void skipValue(Event event)
+		{
+			if (event == Event::kStartObject || event == Event::kStartArray)
+			{
+				m_skipDepth = 1;
+			}
+		}
+
+		template <typename Forward>
+		bool onEvent(Event event, Forward forward, const std::string* pKey = nullptr)
+		{
+			if (m_isCapturing)
+			{
+				forward(m_builder);
+				if (m_builder.isComplete())
+				{
+					m_isCapturing = false;
+					onCaptured(m_builder.release());
+				}
+				return true;
+			}
+
+			if (m_skipDepth > 0)
+			{
+				if (event == Event::kStartObject || event == Event::kStartArray)
+				{
+					++m_skipDepth;
+				}
+				else if (event == Event::kEndObject || event == Event::kEndArray)
+				{
+					--m_skipDepth;
+				}
+				return true;
+			}
+
+			switch (m_position)
+			{
+			case Position::kBeforeRoot:
+				if (event == Event::kStartObject)
+				{
+					m_isRootObject = true;
+					m_position = Position::kRoot;
+				}
+				else
+				{
+					// A root that is not an object does not have format_version
+					skipValue(event);
+					m_position = Position::kAfterRoot;
+				}
+				break;
+
+			case Position::kRoot:
+				if (event == Event::kKey)
+				{
+					m_topKey = *pKey;
+				}
+				else if (event == Event::kEndObject)
+				{
+					m_position = Position::kAfterRoot;
+				}
+				else if (const auto sectionIdx = TopLevelSectionIdx(m_topKey); sectionIdx.has_value() && !isSectionLoaded(*sectionIdx))
+				{
+					// Note: The section is left default as if it were absent
+					skipValue(event);
+				}
+				else if (m_topKey == "audio" && !m_options.audioEffect && event == Event::kStartObject)
+				{
+					// Items of "audio" are loaded one by one to skip "audio_effect"
+					resetSection(kKsonSectionIdxAudio);
+					m_audio = nlohmann::json::object();
+					m_position = Position::kAudio;
+				}
+				else if (m_topKey == "note" && event == Event::kStartObject)
+				{
+					// Note lanes are loaded one by one
+					resetSection(kKsonSectionIdxNoteBT);
+					resetSection(kKsonSectionIdxNoteFX);
+					resetSection(kKsonSectionIdxNoteLaser);
+					m_position = Position::kNote;
+				}
+				else if (m_topKey == "format_version" || m_topKey == "impl" || TopLevelSectionIdx(m_topKey).has_value())
+				{
+					captureValue(forward);
+				}
+				else
+				{
+					skipValue(event);
+				}
+				break;
+
+			case Position::kNote:
+				if (event == Event::kKey)
+				{
+					m_noteKey = *pKey;
+				}
+				else if (event == Event::kEndObject)
+				{
+					m_position = Position::kRoot;
+				}
+				else if (const auto sectionIdx = NoteLaneSectionIdx(m_noteKey))
+				{
+					resetSection(*sectionIdx);
+					if (event == Event::kStartArray)
+					{
+						m_laneIdx = 0;
+						m_position = Position::kNoteLanes;
+					}
+					else
+					{
+						skipValue(event);
+					}
+				}
+				else
+				{
+					skipValue(event);
+				}
+				break;
+
+			case Position::kNoteLanes:
+				if (event == Event::kEndArray)
+				{
+					m_position = Position::kNote;
+				}
+				else
+				{
+					m_capturedLaneIdx = m_laneIdx++;
+					if (m_capturedLaneIdx < numLanes(m_noteKey))
+					{
+						captureValue(forward);
+					}
+					else
+					{
+						skipValue(event);
+					}
+				}
+				break;
+
+			case Position::kAudio:
+				if (event == Event::kKey)
+				{
+					m_audioKey = *pKey;
+				}
+				else if (event == Event::kEndObject)
+				{
+					m_position = Position::kRoot;
+					onTopLevelValue(std::move(m_audio));
+				}
+				else if (m_audioKey == "audio_effect")
+				{
+					skipValue(event);
+				}
+				else
+				{
+					captureValue(forward);
+				}
+				break;
+
+			case Position::kAfterRoot:
+				break;
+			}
+
+			return true;
+		}
+
+	public:
+		KsonSaxLoader(ChartData* pChartData, const ChartLoadingOptions& options)
+			: m_pChartData(pChartData)
+			, m_options(options)
+		{
+		}
+
+		// Validates format_version and reports the warnings of the sections in the same order as the DOM-based loader
+		// Returns false if the chart cannot be loaded
+		bool finish(KsonLoadingDiag* pKsonDiag)
+		{
+			ChartData& chartData = *m_pChartData;
+			if (!ValidateFormatVersion(m_isRootObject && m_formatVersion.has_value() ? &*m_formatVersion : nullptr, &chartData.error, pKsonDiag))
+			{
+				return false;
+			}
+
+			bool hasError = false;
+			for (std::size_t i = 0; i < kNumKsonSections; ++i)
+			{
+				const auto sectionIdx = static_cast<KsonSectionIdx>(i);
+				if (hasError)
+				{
+					// Sections after the error are not loaded
+					resetSection(sectionIdx);
+					continue;
+				}
+
+				auto& warnings = m_sectionDiags[sectionIdx].warnings;
+				pKsonDiag->warnings.insert(pKsonDiag->warnings.end(), std::make_move_iterator(warnings.begin()), std::make_move_iterator(warnings.end()));
+
+				if (m_sectionErrors[sectionIdx].has_value())
+				{
+					hasError = true;
+					chartData.error = m_sectionErrors[sectionIdx]->error;
+					pKsonDiag->warnings.push_back(std::move(m_sectionErrors[sectionIdx]->warning));
+					if (sectionIdx == kKsonSectionIdxNoteBT || sectionIdx == kKsonSectionIdxNoteFX || sectionIdx == kKsonSectionIdxNoteLaser)
+					{
+						// The note section is loaded all at once in the DOM-based loader
+						chartData.note = NoteInfo{};
+					}
+					else
+					{
+						resetSection(sectionIdx);
+					}
+				}
+			}
+
+			if (hasError)
+			{
+				chartData.impl = nlohmann::json::object();
+			}
+			else
+			{
+				chartData.error = ErrorType::None;
+			}
+
+			return true;
+		}
+	};
+
+	// SAX handler that only captures format_version, meta and audio.bgm
+	// Note: Other values are skipped without being stored, and parsing stops once all of them are found
+	class KsonMetaSaxLoader : public JsonSaxForwarder<KsonMetaSaxLoader>
+	{
+	private:
+		friend JsonSaxForwarder<KsonMetaSaxLoader>;
+
+		using Event = JsonSaxEvent;
+
+		enum class Position
+		{
+			kBeforeRoot,
+			kRoot,
+			kAudio,
+			kAfterRoot,
+		};
+
+		Position m_position = Position::kBeforeRoot;
+
+		std::string m_key;
+
+		std::optional<nlohmann::json>* m_pCaptureTarget = nullptr;
+
+		JsonValueBuilder m_builder;
+
+		std::size_t m_skipDepth = 0;
+
+		bool m_isRootObject = false;
+
+		std::optional<nlohmann::json> m_formatVersion;
+
+		std::optional<nlohmann::json> m_meta;
+
+		std::optional<nlohmann::json> m_bgm;
+
+		template <typename Forward>
+		void captureValue(std::optional<nlohmann::json>* pTarget, Forward forward)
+		{
+			m_pCaptureTarget = pTarget;
+			m_builder = JsonValueBuilder{};
+			forward(m_builder);
+			if (m_builder.isComplete())
+			{
+				*m_pCaptureTarget = m_builder.release();
+				m_pCaptureTarget = nullptr;
+			}
+		}
+
+		void skipValue(Event event)
+		{
+			if (event == Event::kStartObject || event == Event::kStartArray)
+			{
+				m_skipDepth = 1;
+			}
+		}
+
+		// Returns false to stop parsing
+		template <typename Forward>
+		bool onEvent(Event event, Forward forward, const std::string* pKey = nullptr)
+		{
+			if (m_pCaptureTarget != nullptr)
+			{
+				forward(m_builder);
+				if (m_builder.isComplete())
+				{
+					*m_pCaptureTarget = m_builder.release();
+					m_pCaptureTarget = nullptr;
+				}
+			}
+			else if (m_skipDepth > 0)
+			{
+				if (event == Event::kStartObject || event == Event::kStartArray)
+				{
+					++m_skipDepth;
+				}
+				else if (event == Event::kEndObject || event == Event::kEndArray)
+				{
+					--m_skipDepth;
+				}
+			}
+			else
+			{
+				switch (m_position)
+				{
+				case Position::kBeforeRoot:
+					if (event == Event::kStartObject)
+					{
+						m_isRootObject = true;
+						m_position = Position::kRoot;
+					}
+					else
+					{
+						// A root that is not an object does not have format_version
+						return false;
+					}
+					break;
+
+				case Position::kRoot:
+					if (event == Event::kKey)
+					{
+						m_key = *pKey;
+					}
+					else if (event == Event::kEndObject)
+					{
+						m_position = Position::kAfterRoot;
+					}
+					else if (m_key == "format_version")
+					{
+						captureValue(&m_formatVersion, forward);
+					}
+					else if (m_key == "meta")
+					{
+						captureValue(&m_meta, forward);
+					}
+					else if (m_key == "audio" && event == Event::kStartObject)
+					{
+						m_position = Position::kAudio;
+					}
+					else
+					{
+						skipValue(event);
+					}
+					break;
+
+				case Position::kAudio:
+					if (event == Event::kKey)
+					{
+						m_key = *pKey;
+					}
+					else if (event == Event::kEndObject)
+					{
+						m_position = Position::kRoot;
+					}
+					else if (m_key == "bgm")
+					{
+						captureValue(&m_bgm, forward);
+					}
+					else
+					{
+						skipValue(event);
+					}
+					break;
+
+				case Position::kAfterRoot:
+					break;
+				}
+			}
+
+			// Stop parsing once all values are found
+			const bool isCapturing = m_pCaptureTarget != nullptr;
+			return isCapturing || !m_formatVersion.has_value() || !m_meta.has_value() || !m_bgm.has_value();
+		}
+
+	public:
+		[[nodiscard]]
+		const nlohmann::json* formatVersion() const
+		{
+			return m_isRootObject && m_formatVersion.has_value() ? &*m_formatVersion : nullptr;
+		}
+
+		[[nodiscard]]
+		const std::optional<nlohmann::json>& meta() const
+		{
+			return m_meta;
+		}
+
+		[[nodiscard]]
+		const std::optional<nlohmann::json>& bgm() const
+		{
+			return m_bgm;
+		}
+	};
+}
+
+kson::ChartData kson::LoadKsonChartData(std::istream& stream, KsonLoadingDiag* pKsonDiag)
+{
+	return LoadKsonChartData(stream, ChartLoadingOptions{}, pKsonDiag);
+}
+
+kson::ChartData kson::LoadKsonChartData(std::istream& stream, const ChartLoadingOptions& options, KsonLoadingDiag* pKsonDiag)
+{
+	KsonLoadingDiag localDiag;
+	if (!pKsonDiag)
+	{
+		pKsonDiag = &localDiag;
+	}
+
+	ChartData chartData;
+
+	if (!stream.good())
+	{
+		chartData.error = ErrorType::GeneralIOError;
+		return chartData;
+	}
+
+	try
+	{
+		// Note: Non-strict parsing as with operator>>, which ignores trailing characters after the root value
+		KsonSaxLoader loader(&chartData, options);
+		nlohmann::json::sax_parse(stream, &loader, nlohmann::json::input_format_t::json, false);
+
+		if (!loader.finish(pKsonDiag))
+		{
+			// Note: Discard the partially loaded sections
+			return { .error = chartData.error };
+		}
 	}
 	catch (const nlohmann::json::parse_error& e)
 	{
-		chartData.error = ErrorType::KsonParseError;
 		pKsonDiag->warnings.push_back({
 			.type = KsonLoadingWarningType::JsonParseError,
 			.scope = WarningScope::PlayerAndEditor,
 			.message = "JSON parse error: " + std::string(e.what()),
 		});
-	}
-	catch (const nlohmann::json::type_error& e)
-	{
-		chartData.error = ErrorType::KsonParseError;
-		pKsonDiag->warnings.push_back({
-			.type = KsonLoadingWarningType::JsonTypeError,
-			.scope = WarningScope::PlayerAndEditor,
-			.message = "JSON type error: " + std::string(e.what()),
-		});
+		return { .error = ErrorType::KsonParseError };
 	}
 	catch (const std::exception& e)
 	{
@@ -2351,6 +3379,11 @@ std::vector<std::string> kson::KsonLoadingDiag::editorWarnings() const
 }
 
 kson::ChartData kson::LoadKsonChartData(const std::string& filePath, KsonLoadingDiag* pKsonDiag)
+{
+	return LoadKsonChartData(filePath, ChartLoadingOptions{}, pKsonDiag);
+}
+
+kson::ChartData kson::LoadKsonChartData(const std::string& filePath, const ChartLoadingOptions& options, KsonLoadingDiag* pKsonDiag)
 {
 	const auto fsPath = U8Path(filePath);
 	if (!std::filesystem::exists(fsPath))
@@ -2367,7 +3400,7 @@ kson::ChartData kson::LoadKsonChartData(const std::string& filePath, KsonLoading
 		chartData.error = ErrorType::CouldNotOpenInputFileStream;
 		return chartData;
 	}
-	return kson::LoadKsonChartData(ifs, pKsonDiag);
+	return kson::LoadKsonChartData(ifs, options, pKsonDiag);
 }
 
 kson::MetaChartData kson::LoadKsonMetaChartData(std::istream& stream, KsonLoadingDiag* pKsonDiag)
@@ -2380,22 +3413,31 @@ kson::MetaChartData kson::LoadKsonMetaChartData(std::istream& stream, KsonLoadin
 
 	MetaChartData metaChartData;
 
+	if (!stream.good())
+	{
+		metaChartData.error = ErrorType::GeneralIOError;
+		return metaChartData;
+	}
+
 	try
 	{
-		nlohmann::json j;
-		if (!ValidateAndParseKsonJson(stream, &j, &metaChartData.error, pKsonDiag))
+		// Note: The rest of the file is not parsed after format_version, meta and audio.bgm are found
+		KsonMetaSaxLoader loader;
+		nlohmann::json::sax_parse(stream, &loader, nlohmann::json::input_format_t::json, false);
+
+		if (!ValidateFormatVersion(loader.formatVersion(), &metaChartData.error, pKsonDiag))
 		{
 			return metaChartData;
 		}
 
-		if (j.contains("meta"))
+		if (loader.meta().has_value())
 		{
-			metaChartData.meta = ParseMetaInfo(j["meta"], pKsonDiag);
+			metaChartData.meta = ParseMetaInfo(*loader.meta(), pKsonDiag);
 		}
 
-		if (j.contains("audio") && j["audio"].contains("bgm"))
+		if (loader.bgm().has_value())
 		{
-			const BGMInfo bgmInfo = ParseBGMInfo(j["audio"]["bgm"], pKsonDiag);
+			const BGMInfo bgmInfo = ParseBGMInfo(*loader.bgm(), pKsonDiag);
 			metaChartData.audio.bgm.filename = bgmInfo.filename;
 			metaChartData.audio.bgm.vol = bgmInfo.vol;
 			metaChartData.audio.bgm.preview = bgmInfo.preview;
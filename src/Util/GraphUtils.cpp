@@ -3,50 +3,154 @@
 #include <algorithm>
 #include <vector>
 
-double kson::GraphValueAt(const Graph& graph, Pulse pulse)
+namespace
 {
-	if (graph.empty())
+	using namespace kson;
+
+	template <typename GraphType>
+	double GraphValueAtImpl(const GraphType& graph, Pulse pulse)
 	{
-		return 0.0;
+		if (graph.empty())
+		{
+			return 0.0;
+		}
+
+		auto itr = graph.upper_bound(pulse);
+		if (itr == graph.end())
+		{
+			return graph.rbegin()->second.v.vf;
+		}
+		if (itr != graph.begin())
+		{
+			--itr;
+		}
+
+		const auto& [pulse1, point1] = *itr;
+		if (pulse < pulse1)
+		{
+			return point1.v.v;
+		}
+
+		const auto nextItr = std::next(itr);
+		if (nextItr == graph.end())
+		{
+			return point1.v.vf;
+		}
+
+		const auto& [pulse2, point2] = *nextItr;
+		assert(pulse1 <= pulse && pulse < pulse2);
+
+		const Pulse segmentLength = pulse2 - pulse1;
+		if (segmentLength <= 0)
+		{
+			return point2.v.v;
+		}
+
+		const double lerpRate = static_cast<double>(pulse - pulse1) / static_cast<double>(segmentLength);
+
+		// Apply curve if present
+		const double curveValue = EvaluateCurve(point1.curve, lerpRate);
+
+		return std::lerp(point1.v.vf, point2.v.v, curveValue);
 	}
+}
+
+double kson::GraphValueAt(const Graph& graph, Pulse pulse)
+{
+	return GraphValueAtImpl(graph, pulse);
+}
+
+double kson::GraphValueAt(const FlatGraph& graph, Pulse pulse)
+{
+	return GraphValueAtImpl(graph, pulse);
+}
 
-	auto itr = graph.upper_bound(pulse);
-	if (itr == graph.end())
+template <typename GraphType>
+void kson::GraphSampler::resetImpl(const GraphType& graph)
+{
+	m_segments.clear();
+	m_segmentIdx = 0;
+	m_firstValue = graph.empty() ? 0.0 : graph.begin()->second.v.v;
+
+	for (auto itr = graph.begin(); itr != graph.end(); ++itr)
 	{
-		return graph.rbegin()->second.v.vf;
+		const auto& [pulse1, point1] = *itr;
+		const auto nextItr = std::next(itr);
+		if (nextItr == graph.end())
+		{
+			m_segments.push_back({ .pulse = pulse1, .startValue = point1.v.vf, .endValue = point1.v.vf, .invLength = 0.0, .curve = GraphCurveValue{} });
+			break;
+		}
+
+		const auto& [pulse2, point2] = *nextItr;
+		m_segments.push_back({
+			.pulse = pulse1,
+			.startValue = point1.v.vf,
+			.endValue = point2.v.v,
+			.invLength = 1.0 / static_cast<double>(pulse2 - pulse1),
+			.curve = point1.curve,
+		});
 	}
-	if (itr != graph.begin())
+}
+
+kson::GraphSampler::GraphSampler(const Graph& graph)
+{
+	resetImpl(graph);
+}
+
+kson::GraphSampler::GraphSampler(const FlatGraph& graph)
+{
+	resetImpl(graph);
+}
+
+void kson::GraphSampler::reset(const Graph& graph)
+{
+	resetImpl(graph);
+}
+
+void kson::GraphSampler::reset(const FlatGraph& graph)
+{
+	resetImpl(graph);
+}
+
+double kson::GraphSampler::valueAt(Pulse pulse)
+{
+	if (m_segments.empty())
 	{
-		--itr;
+		return 0.0;
 	}
 
-	const auto& [pulse1, point1] = *itr;
-	if (pulse < pulse1)
+	if (pulse < m_segments.front().pulse)
 	{
-		return point1.v.v;
+		return m_firstValue;
 	}
 
-	const auto nextItr = std::next(itr);
-	if (nextItr == graph.end())
+	if (pulse < m_segments[m_segmentIdx].pulse)
 	{
-		return point1.v.vf;
+		// Backward seek
+		const auto itr = std::upper_bound(m_segments.begin(), m_segments.end(), pulse, [](Pulse p, const Segment& segment) { return p < segment.pulse; });
+		m_segmentIdx = static_cast<std::size_t>(itr - m_segments.begin()) - 1;
 	}
-
-	const auto& [pulse2, point2] = *nextItr;
-	assert(pulse1 <= pulse && pulse < pulse2);
-
-	const Pulse segmentLength = pulse2 - pulse1;
-	if (segmentLength <= 0)
+	else
 	{
-		return point2.v.v;
+		while (m_segmentIdx + 1 < m_segments.size() && m_segments[m_segmentIdx + 1].pulse <= pulse)
+		{
+			++m_segmentIdx;
+		}
 	}
 
-	const double lerpRate = static_cast<double>(pulse - pulse1) / static_cast<double>(segmentLength);
-
-	// Apply curve if present
-	const double curveValue = EvaluateCurve(point1.curve, lerpRate);
+	const Segment& segment = m_segments[m_segmentIdx];
+	const double lerpRate = static_cast<double>(pulse - segment.pulse) * segment.invLength;
+	if (segment.curve.isLinear())
+	{
+		return std::lerp(segment.startValue, segment.endValue, lerpRate);
+	}
+	return std::lerp(segment.startValue, segment.endValue, EvaluateCurve(segment.curve.a, segment.curve.b, lerpRate));
+}
 
-	return std::lerp(point1.v.vf, point2.v.v, curveValue);
+bool kson::GraphSampler::empty() const
+{
+	return m_segments.empty();
 }
 
 kson::Graph kson::BakeStopIntoScrollSpeed(const Graph& scrollSpeed, const ByPulse<RelPulse>& stop)
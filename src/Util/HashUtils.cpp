@@ -0,0 +1,52 @@
+#include "kson/Util/HashUtils.hpp"
+#include <cstring>
+
+namespace
+{
+	constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+	constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+	constexpr std::uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+
+	constexpr std::uint64_t RotL(std::uint64_t value, int shift)
+	{
+		return (value << shift) | (value >> (64 - shift));
+	}
+
+	// Note: Each word is mixed into all 64 bits of the state, so that differences in the high bits of two words do not cancel out
+	constexpr std::uint64_t Round(std::uint64_t hash, std::uint64_t word)
+	{
+		hash ^= RotL(word * kPrime2, 31) * kPrime1;
+		return RotL(hash, 27) * kPrime1 + kPrime3;
+	}
+
+	constexpr std::uint64_t Avalanche(std::uint64_t hash)
+	{
+		hash ^= hash >> 33;
+		hash *= kPrime2;
+		hash ^= hash >> 29;
+		hash *= kPrime3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+}
+
+std::uint64_t kson::Hash64(std::span<const char> data, std::uint64_t seed)
+{
+	std::uint64_t hash = seed;
+	std::size_t i = 0;
+	for (; i + sizeof(std::uint64_t) <= data.size(); i += sizeof(std::uint64_t))
+	{
+		std::uint64_t word;
+		std::memcpy(&word, data.data() + i, sizeof(word));
+		hash = Round(hash, word);
+	}
+	if (i < data.size())
+	{
+		std::uint64_t word = 0;
+		std::memcpy(&word, data.data() + i, data.size() - i);
+		hash = Round(hash, word);
+	}
+
+	// Note: The size is mixed in so that trailing zero bytes are not ignored
+	return Avalanche(hash ^ (static_cast<std::uint64_t>(data.size()) * kPrime1));
+}
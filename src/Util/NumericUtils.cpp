@@ -0,0 +1,86 @@
+#include "kson/Util/NumericUtils.hpp"
+#include <cmath>
+#include <cstdint>
+
+#if !defined(_MSC_VER) && !defined(__cpp_lib_to_chars)
+namespace
+{
+	std::from_chars_result FromCharsDoubleFallback(const char* first, const char* last, double& value)
+	{
+		const char* p = first;
+
+		bool negative = false;
+		if (p != last && *p == '-')
+		{
+			negative = true;
+			++p;
+		}
+
+		std::uint64_t mantissa = 0;
+		std::int32_t exponent = 0;
+		bool hasDigits = false;
+		const auto accumulateDigits = [&](bool isFraction)
+		{
+			while (p != last && '0' <= *p && *p <= '9')
+			{
+				hasDigits = true;
+				if (mantissa < 1000000000000000000ULL)
+				{
+					mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+					if (isFraction)
+					{
+						--exponent;
+					}
+				}
+				else if (!isFraction)
+				{
+					++exponent;
+				}
+				++p;
+			}
+		};
+
+		accumulateDigits(false);
+		if (p != last && *p == '.')
+		{
+			++p;
+			accumulateDigits(true);
+		}
+
+		if (!hasDigits)
+		{
+			return { first, std::errc::invalid_argument };
+		}
+
+		if (p != last && (*p == 'e' || *p == 'E'))
+		{
+			const char* expFirst = p + 1;
+			std::int32_t expValue = 0;
+			const auto [expPtr, expEc] = std::from_chars(expFirst + (expFirst != last && *expFirst == '+'), last, expValue);
+			if (expEc == std::errc{})
+			{
+				exponent += expValue;
+				p = expPtr;
+			}
+		}
+
+		const double result = static_cast<double>(mantissa) * std::pow(10.0, exponent);
+		if (std::isinf(result))
+		{
+			return { p, std::errc::result_out_of_range };
+		}
+
+		value = negative ? -result : result;
+		return { p, std::errc{} };
+	}
+}
+#endif
+
+std::from_chars_result kson::FromCharsDouble(const char* first, const char* last, double& value)
+{
+#if defined(_MSC_VER) || defined(__cpp_lib_to_chars)
+	return std::from_chars(first, last, value, std::chars_format::general);
+#else
+	return FromCharsDoubleFallback(first, last, value);
+#endif
+}
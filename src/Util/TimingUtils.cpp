@@ -1,7 +1,49 @@
 #include "kson/Util/TimingUtils.hpp"
+#include <algorithm>
 #include <optional>
 #include <iostream>
 
+namespace
+{
+	using namespace kson;
+
+	std::size_t SegmentIdxAtPulse(const TimingIndex& index, double pulse)
+	{
+		const auto& segments = index.segments;
+		const auto itr = std::upper_bound(segments.begin(), segments.end(), pulse, [](double p, const TimingSegment& segment) { return p < static_cast<double>(segment.pulse); });
+		return itr == segments.begin() ? 0 : static_cast<std::size_t>(itr - segments.begin()) - 1;
+	}
+
+	std::size_t SegmentIdxAtSec(const TimingIndex& index, double sec)
+	{
+		const auto& segments = index.segments;
+		const auto itr = std::upper_bound(segments.begin(), segments.end(), sec, [](double s, const TimingSegment& segment) { return s < segment.sec; });
+		return itr == segments.begin() ? 0 : static_cast<std::size_t>(itr - segments.begin()) - 1;
+	}
+
+	// Note: The calculations below must be the same as the TimingCache versions so that the results are identical
+
+	double SegmentPulseToSec(const TimingSegment& segment, Pulse pulse)
+	{
+		return segment.sec + static_cast<double>(pulse - segment.pulse) / kResolution * 60 / segment.bpm;
+	}
+
+	double SegmentPulseDoubleToSec(const TimingSegment& segment, double pulseDouble)
+	{
+		return segment.sec + (pulseDouble - static_cast<double>(segment.pulse)) / kResolution * 60 / segment.bpm;
+	}
+
+	Pulse SegmentSecToPulse(const TimingSegment& segment, double sec)
+	{
+		return segment.pulse + static_cast<Pulse>(kResolution * (sec - segment.sec) * segment.bpm / 60);
+	}
+
+	double SegmentSecToPulseDouble(const TimingSegment& segment, double sec)
+	{
+		return static_cast<double>(segment.pulse) + kResolution * (sec - segment.sec) * segment.bpm / 60;
+	}
+}
+
 kson::Pulse kson::TimeSigOneMeasurePulse(const TimeSig& timeSig)
 {
 	if (timeSig.d == 0)
@@ -73,6 +115,206 @@ kson::TimingCache kson::CreateTimingCache(const BeatInfo& beatInfo)
 	return cache;
 }
 
+kson::TimingIndex kson::CreateTimingIndex(const BeatInfo& beatInfo)
+{
+	TimingIndex index;
+	if (beatInfo.bpm.empty())
+	{
+		// Same default as CreateTimingCache
+		index.segments.push_back({ .pulse = 0, .sec = 0.0, .bpm = 120.0 });
+		return index;
+	}
+
+	index.segments.reserve(beatInfo.bpm.size() + 1);
+	if (!beatInfo.bpm.contains(0))
+	{
+		// Same as CreateTimingCache, the first value is used at zero
+		index.segments.push_back({ .pulse = 0, .sec = 0.0, .bpm = beatInfo.bpm.begin()->second });
+	}
+
+	double sec = 0.0;
+	for (const auto& [pulse, bpm] : beatInfo.bpm)
+	{
+		if (!index.segments.empty())
+		{
+			const TimingSegment& prevSegment = index.segments.back();
+			sec += static_cast<double>(pulse - prevSegment.pulse) / kResolution * 60 / prevSegment.bpm;
+		}
+		index.segments.push_back({ .pulse = pulse, .sec = sec, .bpm = bpm });
+	}
+
+	return index;
+}
+
+double kson::PulseToSec(Pulse pulse, const TimingIndex& index)
+{
+	assert(!index.segments.empty());
+	return SegmentPulseToSec(index.segments[SegmentIdxAtPulse(index, static_cast<double>(pulse))], pulse);
+}
+
+double kson::PulseDoubleToSec(double pulseDouble, const TimingIndex& index)
+{
+	assert(!index.segments.empty());
+	return SegmentPulseDoubleToSec(index.segments[SegmentIdxAtPulse(index, static_cast<double>(static_cast<Pulse>(pulseDouble)))], pulseDouble);
+}
+
+kson::Pulse kson::SecToPulse(double sec, const TimingIndex& index)
+{
+	assert(!index.segments.empty());
+	return SegmentSecToPulse(index.segments[SegmentIdxAtSec(index, sec)], sec);
+}
+
+double kson::SecToPulseDouble(double sec, const TimingIndex& index)
+{
+	assert(!index.segments.empty());
+	return SegmentSecToPulseDouble(index.segments[SegmentIdxAtSec(index, sec)], sec);
+}
+
+void kson::PulsesToSec(std::span<const Pulse> pulses, std::span<double> dstSecs, const TimingIndex& index)
+{
+	assert(!index.segments.empty());
+	assert(pulses.size() == dstSecs.size());
+
+	const auto& segments = index.segments;
+	std::size_t segmentIdx = 0;
+	std::size_t i = 0;
+	while (i < pulses.size())
+	{
+		if (pulses[i] < segments[segmentIdx].pulse)
+		{
+			// Unsorted input
+			segmentIdx = SegmentIdxAtPulse(index, static_cast<double>(pulses[i]));
+		}
+		while (segmentIdx + 1 < segments.size() && segments[segmentIdx + 1].pulse <= pulses[i])
+		{
+			++segmentIdx;
+		}
+
+		// Find the end of the run within the current segment
+		const TimingSegment segment = segments[segmentIdx];
+		const bool isLastSegment = segmentIdx + 1 >= segments.size();
+		const Pulse segmentEndPulse = isLastSegment ? 0 : segments[segmentIdx + 1].pulse;
+		std::size_t runEnd = i + 1;
+		while (runEnd < pulses.size() && (segmentIdx == 0 || pulses[runEnd] >= segment.pulse) && (isLastSegment || pulses[runEnd] < segmentEndPulse))
+		{
+			++runEnd;
+		}
+
+		// Note: The same formula as PulseToSec is used so that the results are bit-for-bit equal to it
+		for (std::size_t j = i; j < runEnd; ++j)
+		{
+			dstSecs[j] = SegmentPulseToSec(segment, pulses[j]);
+		}
+		i = runEnd;
+	}
+}
+
+void kson::SecsToPulse(std::span<const double> secs, std::span<Pulse> dstPulses, const TimingIndex& index)
+{
+	assert(!index.segments.empty());
+	assert(secs.size() == dstPulses.size());
+
+	const auto& segments = index.segments;
+	std::size_t segmentIdx = 0;
+	std::size_t i = 0;
+	while (i < secs.size())
+	{
+		if (secs[i] < segments[segmentIdx].sec)
+		{
+			// Unsorted input
+			segmentIdx = SegmentIdxAtSec(index, secs[i]);
+		}
+		while (segmentIdx + 1 < segments.size() && segments[segmentIdx + 1].sec <= secs[i])
+		{
+			++segmentIdx;
+		}
+
+		// Find the end of the run within the current segment
+		const TimingSegment segment = segments[segmentIdx];
+		const bool isLastSegment = segmentIdx + 1 >= segments.size();
+		const double segmentEndSec = isLastSegment ? 0.0 : segments[segmentIdx + 1].sec;
+		std::size_t runEnd = i + 1;
+		while (runEnd < secs.size() && (segmentIdx == 0 || secs[runEnd] >= segment.sec) && (isLastSegment || secs[runEnd] < segmentEndSec))
+		{
+			++runEnd;
+		}
+
+		// Note: The same formula as SecToPulse is used so that the results are bit-for-bit equal to it
+		for (std::size_t j = i; j < runEnd; ++j)
+		{
+			dstPulses[j] = SegmentSecToPulse(segment, secs[j]);
+		}
+		i = runEnd;
+	}
+}
+
+kson::TimingCursor::TimingCursor(const TimingIndex& index)
+	: m_pIndex(&index)
+{
+	assert(!index.segments.empty());
+}
+
+void kson::TimingCursor::seekByPulse(double pulse)
+{
+	const auto& segments = m_pIndex->segments;
+	if (pulse < static_cast<double>(segments[m_segmentIdx].pulse))
+	{
+		// Backward seek
+		m_segmentIdx = SegmentIdxAtPulse(*m_pIndex, pulse);
+		return;
+	}
+
+	while (m_segmentIdx + 1 < segments.size() && static_cast<double>(segments[m_segmentIdx + 1].pulse) <= pulse)
+	{
+		++m_segmentIdx;
+	}
+}
+
+void kson::TimingCursor::seekBySec(double sec)
+{
+	const auto& segments = m_pIndex->segments;
+	if (sec < segments[m_segmentIdx].sec)
+	{
+		// Backward seek
+		m_segmentIdx = SegmentIdxAtSec(*m_pIndex, sec);
+		return;
+	}
+
+	while (m_segmentIdx + 1 < segments.size() && segments[m_segmentIdx + 1].sec <= sec)
+	{
+		++m_segmentIdx;
+	}
+}
+
+double kson::TimingCursor::pulseToSec(Pulse pulse)
+{
+	seekByPulse(static_cast<double>(pulse));
+	return SegmentPulseToSec(m_pIndex->segments[m_segmentIdx], pulse);
+}
+
+double kson::TimingCursor::pulseDoubleToSec(double pulseDouble)
+{
+	seekByPulse(static_cast<double>(static_cast<Pulse>(pulseDouble)));
+	return SegmentPulseDoubleToSec(m_pIndex->segments[m_segmentIdx], pulseDouble);
+}
+
+kson::Pulse kson::TimingCursor::secToPulse(double sec)
+{
+	seekBySec(sec);
+	return SegmentSecToPulse(m_pIndex->segments[m_segmentIdx], sec);
+}
+
+double kson::TimingCursor::secToPulseDouble(double sec)
+{
+	seekBySec(sec);
+	return SegmentSecToPulseDouble(m_pIndex->segments[m_segmentIdx], sec);
+}
+
+double kson::TimingCursor::currentBPM() const
+{
+	return m_pIndex->segments[m_segmentIdx].bpm;
+}
+
 double kson::PulseToMs(Pulse pulse, const BeatInfo& beatInfo, const TimingCache& cache)
 {
 	return PulseToSec(pulse, beatInfo, cache) * 1000;
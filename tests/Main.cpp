@@ -2,11 +2,27 @@
 #include <catch2/catch.hpp>
 
 #include <filesystem>
+#include <fstream>
+#include <sstream>
 #include <string>
+#include "TestUtils.hpp"
 
 std::string g_assetsDir;
 std::filesystem::path g_exeDir;
 
+std::string ReadFileToString(const std::string& filePath)
+{
+	std::ifstream ifs(filePath, std::ios_base::binary);
+	return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+std::string SaveKsonToString(const kson::ChartData& chartData)
+{
+	std::ostringstream oss;
+	REQUIRE(kson::SaveKsonChartData(oss, chartData) == kson::ErrorType::None);
+	return oss.str();
+}
+
 int main(int argc, char* argv[]) {
 	// Get the executable directory and construct the path to the assets directory
 	std::filesystem::path exePath = argv[0];
@@ -0,0 +1,347 @@
+#include <catch2/catch.hpp>
+#include <kson/kson.hpp>
+#include <sstream>
+
+extern std::string g_assetsDir;
+
+TEST_CASE("Audio effect parameter value parsing", "[audio_effect]")
+{
+	using kson::AudioEffectParamUnit;
+
+	SECTION("Single values") {
+		const auto rate = kson::ParseAudioEffectParamValue("50%");
+		REQUIRE(rate.isValid());
+		REQUIRE(rate.off.unit == AudioEffectParamUnit::kRate);
+		REQUIRE(rate.off.v == Approx(0.5));
+		REQUIRE(rate.onMin.v == Approx(0.5));
+		REQUIRE(rate.onMax.v == Approx(0.5));
+
+		const auto fraction = kson::ParseAudioEffectParamValue("1/8");
+		REQUIRE(fraction.onMin.unit == AudioEffectParamUnit::kFraction);
+		REQUIRE(fraction.onMin.v == Approx(0.125));
+
+		REQUIRE(kson::ParseAudioEffectParamValue("100ms").onMin.unit == AudioEffectParamUnit::kSec);
+		REQUIRE(kson::ParseAudioEffectParamValue("100ms").onMin.v == Approx(0.1));
+		REQUIRE(kson::ParseAudioEffectParamValue("2s").onMin.v == Approx(2.0));
+		REQUIRE(kson::ParseAudioEffectParamValue("500samples").onMin.unit == AudioEffectParamUnit::kSamples);
+		REQUIRE(kson::ParseAudioEffectParamValue("10kHz").onMin.unit == AudioEffectParamUnit::kHz);
+		REQUIRE(kson::ParseAudioEffectParamValue("10kHz").onMin.v == Approx(10000.0));
+		REQUIRE(kson::ParseAudioEffectParamValue("200Hz").onMin.v == Approx(200.0));
+		REQUIRE(kson::ParseAudioEffectParamValue("-6dB").onMin.unit == AudioEffectParamUnit::kDecibel);
+		REQUIRE(kson::ParseAudioEffectParamValue("-6dB").onMin.v == Approx(-6.0));
+		REQUIRE(kson::ParseAudioEffectParamValue("-12").onMin.unit == AudioEffectParamUnit::kNumber);
+		REQUIRE(kson::ParseAudioEffectParamValue("-12").onMin.v == Approx(-12.0));
+		REQUIRE(kson::ParseAudioEffectParamValue("on").onMin.unit == AudioEffectParamUnit::kSwitch);
+		REQUIRE(kson::ParseAudioEffectParamValue("on").onMin.v == 1.0);
+		REQUIRE(kson::ParseAudioEffectParamValue("off").onMin.v == 0.0);
+	}
+
+	SECTION("Off and on values") {
+		const auto value = kson::ParseAudioEffectParamValue("0%>100%");
+		REQUIRE(value.isValid());
+		REQUIRE(value.off.v == Approx(0.0));
+		REQUIRE(value.onMin.v == Approx(1.0));
+		REQUIRE(value.onMax.v == Approx(1.0));
+	}
+
+	SECTION("Ranges") {
+		const auto range = kson::ParseAudioEffectParamValue("12-24");
+		REQUIRE(range.off.v == Approx(12.0));
+		REQUIRE(range.onMin.v == Approx(12.0));
+		REQUIRE(range.onMax.v == Approx(24.0));
+
+		const auto full = kson::ParseAudioEffectParamValue("30samples>40samples-60samples");
+		REQUIRE(full.off.v == Approx(30.0));
+		REQUIRE(full.onMin.v == Approx(40.0));
+		REQUIRE(full.onMax.v == Approx(60.0));
+
+		const auto negative = kson::ParseAudioEffectParamValue("-12--6");
+		REQUIRE(negative.onMin.v == Approx(-12.0));
+		REQUIRE(negative.onMax.v == Approx(-6.0));
+	}
+
+	SECTION("Non-numeric values") {
+		REQUIRE_FALSE(kson::ParseAudioEffectParamValue("Gram_flan.ogg").isValid());
+		REQUIRE_FALSE(kson::ParseAudioEffectParamValue("").isValid());
+		REQUIRE_FALSE(kson::ParseAudioEffectParamValue("1/0").isValid());
+		REQUIRE_FALSE(kson::ParseAudioEffectParamValue("50%>").isValid());
+	}
+}
+
+TEST_CASE("Interned audio effect info", "[audio_effect]")
+{
+	kson::AudioEffectInfo audioEffect;
+	audioEffect.fx.def.push_back({ "re", { kson::AudioEffectType::Retrigger, { { "update_period", "1/2" }, { "mix", "0%>100%" } } } });
+	audioEffect.fx.def.push_back({ "sw", { kson::AudioEffectType::SwitchAudio, { { "filename", "a.ogg" } } } });
+	audioEffect.fx.def.push_back({ "re", { kson::AudioEffectType::Gate, {} } });
+	audioEffect.fx.paramChange["re"]["update_period"][960] = "1/4";
+	audioEffect.fx.longEvent["re"][0][480] = { { "wave_length", "1/16" } };
+	audioEffect.fx.longEvent["sw"][0][480] = {};
+	audioEffect.fx.longEvent["sw"][1][960] = {};
+	audioEffect.laser.pulseEvent["peaking_filter"] = { 0, 960 };
+	audioEffect.laser.pulseEvent["high_pass_filter"] = { 960 };
+
+	const kson::InternedAudioEffectInfo interned = kson::CreateInternedAudioEffectInfo(audioEffect);
+	const auto& symbols = interned.symbols;
+
+	const kson::AudioEffectSymbol re = symbols.find("re");
+	const kson::AudioEffectSymbol sw = symbols.find("sw");
+	REQUIRE(re != kson::kInvalidAudioEffectSymbol);
+	REQUIRE(symbols.str(re) == "re");
+	REQUIRE(symbols.find("unknown") == kson::kInvalidAudioEffectSymbol);
+
+	SECTION("Definitions") {
+		REQUIRE(interned.fx.def.size() == 2);
+
+		// The first definition is used as in defByName
+		const kson::InternedAudioEffectDef* pDef = interned.fx.findDef(re);
+		REQUIRE(pDef != nullptr);
+		REQUIRE(pDef->type == kson::AudioEffectType::Retrigger);
+
+		const kson::InternedAudioEffectParam* pParam = kson::FindInternedAudioEffectParam(pDef->v, symbols.find("update_period"));
+		REQUIRE(pParam != nullptr);
+		REQUIRE(pParam->value.onMin.unit == kson::AudioEffectParamUnit::kFraction);
+		REQUIRE(pParam->value.onMin.v == Approx(0.5));
+		REQUIRE(kson::FindInternedAudioEffectParam(pDef->v, symbols.find("filename")) == nullptr);
+
+		const kson::InternedAudioEffectParam* pFilename = kson::FindInternedAudioEffectParam(interned.fx.findDef(sw)->v, symbols.find("filename"));
+		REQUIRE(pFilename != nullptr);
+		REQUIRE_FALSE(pFilename->value.isValid());
+		REQUIRE(symbols.str(pFilename->raw) == "a.ogg");
+
+		REQUIRE(interned.laser.findDef(re) == nullptr);
+	}
+
+	SECTION("Parameter changes") {
+		REQUIRE(interned.fx.paramChange.size() == 1);
+		const auto& change = interned.fx.paramChange.front();
+		REQUIRE(change.name == re);
+		REQUIRE(change.key == symbols.find("update_period"));
+		REQUIRE(change.v.size() == 1);
+		REQUIRE(change.v.at(960).value.onMin.v == Approx(0.25));
+	}
+
+	SECTION("Long events") {
+		REQUIRE(interned.fx.longEvent[0].size() == 1);
+		const auto& invocations = interned.fx.longEvent[0].at(480);
+		REQUIRE(invocations.size() == 2);
+		REQUIRE(invocations[0].name < invocations[1].name);
+
+		const auto itr = std::find_if(invocations.begin(), invocations.end(), [re](const auto& invocation) { return invocation.name == re; });
+		REQUIRE(itr != invocations.end());
+		REQUIRE(itr->v.size() == 1);
+		REQUIRE(itr->v[0].value.onMin.v == Approx(1.0 / 16));
+
+		REQUIRE(interned.fx.longEvent[1].size() == 1);
+		REQUIRE(interned.fx.longEvent[1].at(960).front().name == sw);
+	}
+
+	SECTION("Laser pulse events") {
+		REQUIRE(interned.laser.pulseEvent.size() == 2);
+		REQUIRE(interned.laser.pulseEvent.at(0) == std::vector{ symbols.find("peaking_filter") });
+		REQUIRE(interned.laser.pulseEvent.at(960).size() == 2);
+	}
+}
+
+TEST_CASE("Interned audio effect info (bundled chart)", "[audio_effect][bundled]")
+{
+	const kson::ChartData chartData = kson::LoadKsonChartData(g_assetsDir + "/Gram_ex.kson");
+	REQUIRE(chartData.error == kson::ErrorType::None);
+
+	const kson::InternedAudioEffectInfo interned = kson::CreateInternedAudioEffectInfo(chartData.audio.audioEffect);
+	REQUIRE(interned.fx.def.size() == chartData.audio.audioEffect.fx.def.size());
+
+	for (const auto& [name, def] : chartData.audio.audioEffect.fx.def)
+	{
+		const kson::InternedAudioEffectDef* pDef = interned.fx.findDef(interned.symbols.find(name));
+		REQUIRE(pDef != nullptr);
+		REQUIRE(pDef->type == def.type);
+		REQUIRE(pDef->v.size() == def.v.size());
+		for (const auto& param : pDef->v)
+		{
+			REQUIRE(def.v.at(interned.symbols.str(param.key)) == interned.symbols.str(param.raw));
+			if (def.type != kson::AudioEffectType::SwitchAudio)
+			{
+				REQUIRE(param.value.isValid());
+			}
+		}
+	}
+
+	std::size_t numLongEvents = 0;
+	for (const auto& [name, lanes] : chartData.audio.audioEffect.fx.longEvent)
+	{
+		for (const auto& lane : lanes)
+		{
+			numLongEvents += lane.size();
+		}
+	}
+	std::size_t numInternedLongEvents = 0;
+	for (const auto& lane : interned.fx.longEvent)
+	{
+		for (const auto& [y, invocations] : lane)
+		{
+			numInternedLongEvents += invocations.size();
+		}
+	}
+	REQUIRE(numInternedLongEvents == numLongEvents);
+}
+
+TEST_CASE("Audio effect definition index", "[audio_effect]")
+{
+	std::vector<kson::AudioEffectDefKVP> def;
+	def.push_back({ "a", { kson::AudioEffectType::Retrigger, {} } });
+	def.push_back({ "b", { kson::AudioEffectType::Gate, {} } });
+	def.push_back({ "a", { kson::AudioEffectType::Flanger, {} } });
+
+	kson::AudioEffectDefIndex index(def);
+	REQUIRE(index.contains("a"));
+	REQUIRE(index.indexOf("b") == 1);
+	REQUIRE_FALSE(index.contains("c"));
+	REQUIRE(index.indexOf("c") == kson::AudioEffectDefIndex::npos);
+	REQUIRE(index.find("c") == nullptr);
+
+	// The first definition is found as in defByName
+	REQUIRE(index.find("a") == &def[0].v);
+
+	// The definitions are not copied
+	def[1].v.type = kson::AudioEffectType::Echo;
+	REQUIRE(index.find("b")->type == kson::AudioEffectType::Echo);
+
+	def.push_back({ "c", { kson::AudioEffectType::Phaser, {} } });
+	index.sync();
+	REQUIRE(index.find("c")->type == kson::AudioEffectType::Phaser);
+	REQUIRE(index.find("a") == &def[0].v);
+
+	def.erase(def.begin());
+	index.rebuild();
+	REQUIRE(index.find("a")->type == kson::AudioEffectType::Flanger);
+
+	def.clear();
+	def.push_back({ "d", { kson::AudioEffectType::Wobble, {} } });
+	index.sync();
+	REQUIRE_FALSE(index.contains("a"));
+	REQUIRE(index.find("d")->type == kson::AudioEffectType::Wobble);
+}
+
+TEST_CASE("KSH duplicate audio effect definitions", "[audio_effect][ksh_io]")
+{
+	const std::string ksh =
+		"title=a\r\nt=120\r\nver=171\r\n--\r\n"
+		"fx-l=myfx\r\n0000|10|--\r\n0000|00|--\r\n--\r\n"
+		"#define_fx myfx type=Retrigger;waveLength=1/8\r\n"
+		"#define_fx other type=Gate\r\n"
+		"#define_fx myfx type=Echo;waveLength=1/4\r\n";
+
+	const kson::ChartData chartData = kson::LoadKshChartData(std::span<const char>(ksh.data(), ksh.size()));
+	REQUIRE(chartData.error == kson::ErrorType::None);
+
+	// The later definition overwrites the earlier one in place
+	const auto& def = chartData.audio.audioEffect.fx.def;
+	REQUIRE(def.size() == 2);
+	REQUIRE(def[0].name == "myfx");
+	REQUIRE(def[0].v.type == kson::AudioEffectType::Echo);
+	REQUIRE(def[0].v.v.at("wave_length") == "1/4");
+	REQUIRE(def[1].name == "other");
+
+	std::ostringstream oss;
+	REQUIRE(kson::SaveKshChartData(oss, chartData) == kson::ErrorType::None);
+	REQUIRE(oss.str().find("fx-l=myfx") != std::string::npos);
+}
+
+TEST_CASE("Compiled audio effect info", "[audio_effect]")
+{
+	using kson::AudioEffectParamID;
+
+	kson::AudioEffectInfo audioEffect;
+	audioEffect.fx.def.push_back({ "re", { kson::AudioEffectType::Retrigger, { { "update_period", "1/2" }, { "mix", "0%>50%-100%" }, { "unknown_key", "1" } } } });
+	audioEffect.fx.def.push_back({ "sw", { kson::AudioEffectType::SwitchAudio, { { "filename", "a.ogg" } } } });
+	audioEffect.fx.paramChange["re"]["update_period"][960] = "1/4";
+	audioEffect.fx.longEvent["re"][0][1920] = { { "update_period", "1/8" } };
+	audioEffect.fx.longEvent["flanger"][1][480] = {};
+	audioEffect.fx.longEvent["undefined_effect"][1][480] = {};
+	audioEffect.laser.pulseEvent["peaking_filter"] = { 0 };
+
+	const kson::InternedAudioEffectInfo interned = kson::CreateInternedAudioEffectInfo(audioEffect);
+	const kson::CompiledAudioEffectInfo compiled = kson::CompileAudioEffectInfo(interned);
+	const auto& symbols = interned.symbols;
+
+	SECTION("Parameter IDs") {
+		for (std::size_t i = 0; i < kson::kNumAudioEffectParamIDs; ++i)
+		{
+			const auto id = static_cast<AudioEffectParamID>(i);
+			REQUIRE(kson::StrToAudioEffectParamID(kson::AudioEffectParamIDToStr(id)) == id);
+		}
+		REQUIRE(kson::StrToAudioEffectParamID("update_period") == AudioEffectParamID::UpdatePeriod);
+		REQUIRE(kson::StrToAudioEffectParamID("freq_1") == AudioEffectParamID::Freq1);
+		REQUIRE(kson::StrToAudioEffectParamID("unknown_key") == AudioEffectParamID::Unspecified);
+	}
+
+	SECTION("Effects") {
+		// Preset effects used without definition are included
+		REQUIRE(compiled.fx.effects.size() == 3);
+		REQUIRE(compiled.fx.find(symbols.find("flanger")) != nullptr);
+		REQUIRE(compiled.fx.find(symbols.find("flanger"))->type == kson::AudioEffectType::Flanger);
+		REQUIRE(compiled.fx.find(symbols.find("undefined_effect")) == nullptr);
+		REQUIRE(compiled.laser.effects.size() == 1);
+		REQUIRE(compiled.laser.find(symbols.find("peaking_filter"))->type == kson::AudioEffectType::PeakingFilter);
+
+		const kson::CompiledAudioEffect* pSw = compiled.fx.find(symbols.find("sw"));
+		REQUIRE(pSw != nullptr);
+		REQUIRE(pSw->params.contains(AudioEffectParamID::Filename));
+		REQUIRE_FALSE(pSw->params.contains(AudioEffectParamID::Mix));
+		REQUIRE(symbols.str(pSw->params.raw[static_cast<std::size_t>(AudioEffectParamID::Filename)]) == "a.ogg");
+	}
+
+	SECTION("Evaluation") {
+		const kson::CompiledAudioEffect* pRe = compiled.fx.find(symbols.find("re"));
+		REQUIRE(pRe != nullptr);
+		constexpr auto kMix = static_cast<std::size_t>(AudioEffectParamID::Mix);
+		constexpr auto kUpdatePeriod = static_cast<std::size_t>(AudioEffectParamID::UpdatePeriod);
+
+		const kson::AudioEffectParamScalars off = pRe->evaluate(0, 0.0, false);
+		REQUIRE(off[kMix].unit == kson::AudioEffectParamUnit::kRate);
+		REQUIRE(off[kMix].v == Approx(0.0));
+		REQUIRE(pRe->evaluate(0, 0.0)[kMix].v == Approx(0.5));
+		REQUIRE(pRe->evaluate(0, 0.5)[kMix].v == Approx(0.75));
+		REQUIRE(pRe->evaluate(0, 1.0)[kMix].v == Approx(1.0));
+
+		// Unspecified parameters are left to the consumer
+		REQUIRE(off[static_cast<std::size_t>(AudioEffectParamID::Feedback)].unit == kson::AudioEffectParamUnit::kInvalid);
+
+		// param_change is applied from its pulse
+		REQUIRE(pRe->evaluate(959, 1.0)[kUpdatePeriod].v == Approx(0.5));
+		REQUIRE(pRe->evaluate(960, 1.0)[kUpdatePeriod].v == Approx(0.25));
+
+		// The parameters of the long event take priority over param_change
+		const auto& invocations = compiled.fx.longEvent[0].at(1920);
+		REQUIRE(invocations.size() == 1);
+		REQUIRE(invocations.front().name == pRe->name);
+		REQUIRE(pRe->evaluate(1920, 1.0, true, &invocations.front().v)[kUpdatePeriod].v == Approx(0.125));
+		REQUIRE(pRe->evaluate(1920, 1.0, true, &invocations.front().v)[kMix].v == Approx(1.0));
+
+		REQUIRE(compiled.fx.longEvent[1].at(480).size() == 2);
+	}
+}
+
+TEST_CASE("Compiled audio effect info (bundled chart)", "[audio_effect][bundled]")
+{
+	const kson::ChartData chartData = kson::LoadKsonChartData(g_assetsDir + "/Gram_ex.kson");
+	REQUIRE(chartData.error == kson::ErrorType::None);
+
+	const kson::InternedAudioEffectInfo interned = kson::CreateInternedAudioEffectInfo(chartData.audio.audioEffect);
+	const kson::CompiledAudioEffectInfo compiled = kson::CompileAudioEffectInfo(interned);
+
+	for (const auto& def : interned.fx.def)
+	{
+		const kson::CompiledAudioEffect* pEffect = compiled.fx.find(def.name);
+		REQUIRE(pEffect != nullptr);
+		REQUIRE(pEffect->type == def.type);
+		for (const auto& param : def.v)
+		{
+			const kson::AudioEffectParamID id = kson::StrToAudioEffectParamID(interned.symbols.str(param.key));
+			REQUIRE(id != kson::AudioEffectParamID::Unspecified);
+			REQUIRE(pEffect->params.contains(id));
+			REQUIRE(pEffect->params.raw[static_cast<std::size_t>(id)] == param.raw);
+		}
+	}
+}
@@ -105,6 +105,104 @@ TEST_CASE("Timing Utilities", "[timing]") {
 		REQUIRE(kson::SecToPulse(2.0, beat, cache) == 960);
 	}
 
+	SECTION("Timing index and cursor") {
+		kson::BeatInfo beat;
+		beat.bpm.emplace(0, 120.0);
+		beat.bpm.emplace(960, 180.0);
+		beat.bpm.emplace(1920, 90.0);
+		beat.bpm.emplace(2000, 173.5);
+		beat.timeSig[0] = kson::TimeSig{4, 4};
+
+		const auto cache = kson::CreateTimingCache(beat);
+		const auto index = kson::CreateTimingIndex(beat);
+		REQUIRE(index.segments.size() == 4);
+		REQUIRE(index.segments[1].sec == cache.bpmChangeSec.at(960));
+		REQUIRE(index.segments[3].sec == cache.bpmChangeSec.at(2000));
+
+		// Results should be identical to the TimingCache versions
+		kson::TimingCursor cursor(index);
+		for (kson::Pulse pulse = -240; pulse < 4000; pulse += 37)
+		{
+			const double sec = kson::PulseToSec(pulse, beat, cache);
+			REQUIRE(kson::PulseToSec(pulse, index) == sec);
+			REQUIRE(cursor.pulseToSec(pulse) == sec);
+
+			const double pulseDouble = static_cast<double>(pulse) + 0.25;
+			REQUIRE(kson::PulseDoubleToSec(pulseDouble, index) == kson::PulseDoubleToSec(pulseDouble, beat, cache));
+			REQUIRE(cursor.pulseDoubleToSec(pulseDouble) == kson::PulseDoubleToSec(pulseDouble, beat, cache));
+		}
+		for (double sec = -0.5; sec < 8.0; sec += 0.0173)
+		{
+			REQUIRE(kson::SecToPulse(sec, index) == kson::SecToPulse(sec, beat, cache));
+			REQUIRE(cursor.secToPulse(sec) == kson::SecToPulse(sec, beat, cache));
+			REQUIRE(kson::SecToPulseDouble(sec, index) == kson::SecToPulseDouble(sec, beat, cache));
+			REQUIRE(cursor.secToPulseDouble(sec) == kson::SecToPulseDouble(sec, beat, cache));
+		}
+
+		// Backward seek
+		REQUIRE(cursor.pulseToSec(1200) == kson::PulseToSec(1200, beat, cache));
+		REQUIRE(cursor.currentBPM() == 180.0);
+		REQUIRE(cursor.secToPulse(0.5) == 240);
+		REQUIRE(cursor.currentBPM() == 120.0);
+
+		// Missing BPM at zero uses the first value
+		kson::BeatInfo beatWithoutZero;
+		beatWithoutZero.bpm.emplace(480, 150.0);
+		const auto indexWithoutZero = kson::CreateTimingIndex(beatWithoutZero);
+		REQUIRE(indexWithoutZero.segments.size() == 2);
+		REQUIRE(indexWithoutZero.segments[0].pulse == 0);
+		REQUIRE(indexWithoutZero.segments[0].bpm == 150.0);
+		REQUIRE(kson::PulseToSec(240, indexWithoutZero) == Approx(0.4));
+	}
+
+	SECTION("Batch timing conversion") {
+		kson::BeatInfo beat;
+		beat.bpm.emplace(0, 120.0);
+		beat.bpm.emplace(960, 180.0);
+		beat.bpm.emplace(1920, 90.0);
+		beat.bpm.emplace(2000, 173.5);
+		beat.timeSig[0] = kson::TimeSig{4, 4};
+
+		const auto cache = kson::CreateTimingCache(beat);
+		const auto index = kson::CreateTimingIndex(beat);
+
+		// Sorted input including values before zero and values on segment boundaries
+		std::vector<kson::Pulse> pulses = { -480, -1, 0, 240, 959, 960, 960, 1500, 1920, 1999, 2000, 5000 };
+		std::vector<double> secs(pulses.size());
+		kson::PulsesToSec(pulses, secs, index);
+		for (std::size_t i = 0; i < pulses.size(); ++i)
+		{
+			REQUIRE(secs[i] == kson::PulseToSec(pulses[i], beat, cache));
+		}
+
+		std::vector<kson::Pulse> resultPulses(secs.size());
+		kson::SecsToPulse(secs, resultPulses, index);
+		for (std::size_t i = 0; i < secs.size(); ++i)
+		{
+			REQUIRE(resultPulses[i] == kson::SecToPulse(secs[i], beat, cache));
+		}
+
+		// Unsorted input
+		pulses = { 2500, 100, 1000, -240, 1950, 0 };
+		secs.resize(pulses.size());
+		kson::PulsesToSec(pulses, secs, index);
+		for (std::size_t i = 0; i < pulses.size(); ++i)
+		{
+			REQUIRE(secs[i] == kson::PulseToSec(pulses[i], beat, cache));
+		}
+
+		resultPulses.resize(secs.size());
+		kson::SecsToPulse(secs, resultPulses, index);
+		for (std::size_t i = 0; i < secs.size(); ++i)
+		{
+			REQUIRE(resultPulses[i] == kson::SecToPulse(secs[i], beat, cache));
+		}
+
+		// Empty input
+		kson::PulsesToSec({}, {}, index);
+		kson::SecsToPulse({}, {}, index);
+	}
+
 	SECTION("GetModeBPM") {
 		kson::BeatInfo beat;
 
@@ -255,6 +353,68 @@ TEST_CASE("Graph Utilities", "[graph]") {
 			REQUIRE(kson::GraphValueAt(graph, 360) == Approx(0.9375));
 		}
 	}
+
+	SECTION("Graph sampler") {
+		kson::Graph graph;
+		graph.emplace(240, kson::GraphPoint{0.5, {1.0, 0.0}});
+		graph.emplace(720, kson::GraphValue{1.0, 2.0});
+		graph.emplace(960, 0.25);
+		graph.emplace(1440, kson::GraphPoint{kson::GraphValue{0.0, 1.5}, {0.0, 1.0}});
+		graph.emplace(1920, 3.0);
+
+		// Same values as GraphValueAt for increasing pulses
+		kson::GraphSampler sampler(graph);
+		for (kson::Pulse pulse = 0; pulse < 2400; pulse += 30)
+		{
+			REQUIRE(sampler.valueAt(pulse) == Approx(kson::GraphValueAt(graph, pulse)));
+		}
+
+		// Backward seek
+		REQUIRE(sampler.valueAt(720) == Approx(2.0));
+		REQUIRE(sampler.valueAt(0) == Approx(0.5));
+		REQUIRE(sampler.valueAt(1200) == Approx(kson::GraphValueAt(graph, 1200)));
+
+		// FlatGraph
+		const kson::FlatGraph flatGraph(graph);
+		kson::GraphSampler flatSampler(flatGraph);
+		for (kson::Pulse pulse = 0; pulse < 2400; pulse += 30)
+		{
+			REQUIRE(flatSampler.valueAt(pulse) == Approx(kson::GraphValueAt(flatGraph, pulse)));
+		}
+
+		// Empty graph
+		kson::GraphSampler emptySampler;
+		REQUIRE(emptySampler.empty());
+		REQUIRE(emptySampler.valueAt(0) == 0.0);
+	}
+
+	SECTION("Graph section sampler") {
+		kson::ByPulse<kson::LaserSection> sections;
+		sections[480].v.emplace(0, 0.0);
+		sections[480].v.emplace(240, kson::GraphPoint{1.0, {0.0, 1.0}});
+		sections[480].v.emplace(480, 0.5);
+		sections[1440].v.emplace(0, 1.0);
+		sections[1440].v.emplace(240, 0.0);
+		sections[2400].v.emplace(0, 0.5); // Single point sections have no values
+
+		kson::GraphSectionSampler sampler(sections);
+		for (kson::Pulse pulse = 0; pulse < 3000; pulse += 15)
+		{
+			const auto expected = kson::GraphSectionValueAt(sections, pulse);
+			const auto actual = sampler.valueAt(pulse);
+			REQUIRE(actual.has_value() == expected.has_value());
+			if (expected.has_value())
+			{
+				REQUIRE(*actual == Approx(*expected));
+			}
+		}
+
+		// Backward seek
+		REQUIRE(sampler.valueAt(600) == Approx(*kson::GraphSectionValueAt(sections, 600)));
+		REQUIRE_FALSE(sampler.valueAt(0).has_value());
+		REQUIRE(sampler.valueAtWithDefault(1920, -1.0) == -1.0);
+		REQUIRE(sampler.valueAtWithDefault(1500, -1.0) == Approx(0.75));
+	}
 }
 
 TEST_CASE("Note Data", "[note]") {
@@ -305,3 +465,105 @@ TEST_CASE("Note Data", "[note]") {
 		REQUIRE(notes.laser[0].at(0).v.size() == 2);
 	}
 }
+
+TEST_CASE("Frozen Chart Data", "[chart][frozen]") {
+	SECTION("FlatMap query helpers match std::map versions") {
+		kson::ByPulse<kson::Interval> lane;
+		lane.emplace(0, kson::Interval{ 0 });
+		lane.emplace(240, kson::Interval{ 120 });
+		lane.emplace(480, kson::Interval{ 0 });
+		lane.emplace(960, kson::Interval{ 480 });
+		const kson::FlatByPulse<kson::Interval> flatLane(lane);
+
+		REQUIRE(flatLane.size() == lane.size());
+		REQUIRE(flatLane.contains(240));
+		REQUIRE_FALSE(flatLane.contains(241));
+		REQUIRE(flatLane.at(960).length == 480);
+		REQUIRE_THROWS_AS(flatLane.at(1), std::out_of_range);
+
+		for (kson::Pulse start = -240; start <= 1680; start += 60)
+		{
+			for (kson::Pulse end = start; end <= 1680; end += 120)
+			{
+				REQUIRE(kson::CountInRange(flatLane, start, end) == kson::CountInRange(lane, start, end));
+
+				const auto itr = kson::FirstInRange(lane, start, end);
+				const auto flatItr = kson::FirstInRange(flatLane, start, end);
+				REQUIRE((itr == lane.end()) == (flatItr == flatLane.end()));
+				if (itr != lane.end())
+				{
+					REQUIRE(itr->first == flatItr->first);
+				}
+			}
+
+			const auto intervalItr = kson::IntervalAt(lane, start);
+			const auto flatIntervalItr = kson::IntervalAt(flatLane, start);
+			REQUIRE((intervalItr == lane.end()) == (flatIntervalItr == flatLane.end()));
+
+			const auto valueItr = kson::ValueItrAt(lane, start);
+			const auto flatValueItr = kson::ValueItrAt(flatLane, start);
+			REQUIRE(valueItr->first == flatValueItr->first);
+		}
+	}
+
+	SECTION("CreateFrozenChartData copies lanes and graphs") {
+		kson::ChartData chart;
+		chart.beat.bpm.emplace(0, 120.0);
+		chart.beat.bpm.emplace(960, 240.0);
+		chart.note.bt[1].emplace(480, kson::Interval{ 240 });
+		chart.camera.cam.body.zoomTop.emplace(0, kson::GraphPoint{ 0.0, { 1.0, 0.0 } });
+		chart.camera.cam.body.zoomTop.emplace(480, 100.0);
+
+		const kson::FrozenChartData frozen = kson::CreateFrozenChartData(chart);
+		REQUIRE(kson::ValueAtOrDefault(frozen.beat.bpm, kson::Pulse{ 1000 }, 0.0) == 240.0);
+		REQUIRE(frozen.note.bt[1].size() == 1);
+		REQUIRE(kson::IntervalAt(frozen.note.bt[1], 600) != frozen.note.bt[1].end());
+		for (kson::Pulse pulse = -120; pulse <= 720; pulse += 30)
+		{
+			REQUIRE(kson::GraphValueAt(frozen.camera.cam.zoomTop, pulse) == kson::GraphValueAt(chart.camera.cam.body.zoomTop, pulse));
+		}
+	}
+
+	SECTION("Frozen laser sections have the same query results") {
+		kson::ChartData chart;
+		auto& lane = chart.note.laser[0];
+		lane[480].v.emplace(0, 0.0);
+		lane[480].v.emplace(240, kson::GraphPoint{ 1.0, { 0.0, 1.0 } });
+		lane[480].v.emplace(480, 0.5);
+		lane[1440].v.emplace(0, kson::GraphValue{ 1.0, 0.25 });
+		lane[1440].v.emplace(240, 0.0);
+		lane[1440].w = kson::kLaserXScale2x;
+		lane[2400].v.emplace(0, 0.5); // Single point sections have no values
+
+		const kson::FrozenChartData frozen = kson::CreateFrozenChartData(chart);
+		const kson::FlatByPulse<kson::FlatLaserSection>& flatLane = frozen.note.laser[0];
+		REQUIRE(flatLane.size() == lane.size());
+		REQUIRE(flatLane.at(1440).wide());
+		REQUIRE_FALSE(flatLane.at(480).wide());
+
+		kson::GraphSectionSampler sampler(flatLane);
+		for (kson::Pulse pulse = 0; pulse < 3000; pulse += 15)
+		{
+			const auto expected = kson::GraphSectionValueAt(lane, pulse);
+			const auto actual = kson::GraphSectionValueAt(flatLane, pulse);
+			const auto sampled = sampler.valueAt(pulse);
+			REQUIRE(actual.has_value() == expected.has_value());
+			REQUIRE(sampled.has_value() == expected.has_value());
+			if (expected.has_value())
+			{
+				REQUIRE(*actual == *expected);
+				REQUIRE(*sampled == Approx(*expected));
+			}
+
+			const auto expectedPoint = kson::GraphPointAt(lane, pulse);
+			const auto actualPoint = kson::GraphPointAt(flatLane, pulse);
+			REQUIRE(actualPoint.has_value() == expectedPoint.has_value());
+			if (expectedPoint.has_value())
+			{
+				REQUIRE(actualPoint->v.v == expectedPoint->v.v);
+				REQUIRE(actualPoint->v.vf == expectedPoint->v.vf);
+			}
+		}
+		REQUIRE(kson::GraphSectionValueAtWithDefault(flatLane, 1920, -1.0) == -1.0);
+	}
+}
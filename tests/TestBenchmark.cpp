@@ -0,0 +1,384 @@
+#include <catch2/catch.hpp>
+#include <kson/kson.hpp>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include "TestUtils.hpp"
+
+extern std::string g_assetsDir;
+
+// Note: Benchmarks are hidden by default. Run with "kson_test [benchmark]".
+
+namespace
+{
+	template <typename Func>
+	double MeasureAverageMicroseconds(std::size_t iterations, Func func)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (std::size_t i = 0; i < iterations; ++i)
+		{
+			func();
+		}
+		const auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::micro>(end - start).count() / static_cast<double>(iterations);
+	}
+
+	// Synthetic chart with 192 lines per measure (a BT chip on every line) plus FX long notes and lasers
+	kson::ChartData CreateDenseChartData(std::int64_t numMeasures)
+	{
+		constexpr kson::Pulse kMeasurePulse = kson::kResolution * 4;
+		constexpr kson::Pulse kLinePulse = kMeasurePulse / 192;
+
+		kson::ChartData chartData;
+		chartData.meta.title = "Dense";
+		chartData.beat.bpm.emplace(0, 180.0);
+		chartData.beat.timeSig.emplace(0, kson::TimeSig{ 4, 4 });
+		for (std::int64_t measureIdx = 0; measureIdx < numMeasures; ++measureIdx)
+		{
+			const kson::Pulse measurePulse = measureIdx * kMeasurePulse;
+			for (kson::Pulse ry = 0; ry < kMeasurePulse; ry += kLinePulse)
+			{
+				chartData.note.bt[ry / kLinePulse % kson::kNumBTLanes].emplace(measurePulse + ry, kson::Interval{ 0 });
+			}
+			chartData.note.fx[measureIdx % kson::kNumFXLanes].emplace(measurePulse, kson::Interval{ kMeasurePulse / 2 });
+
+			auto& laserSection = chartData.note.laser[measureIdx % kson::kNumLaserLanes][measurePulse];
+			laserSection.v.emplace(0, 0.0);
+			laserSection.v.emplace(kMeasurePulse / 4, kson::GraphValue{ 1.0, 0.5 });
+			laserSection.v.emplace(kMeasurePulse / 2, kson::GraphPoint{ 0.25, { 0.25, 0.75 } });
+			laserSection.v.emplace(kMeasurePulse - kLinePulse * 2, 0.75);
+		}
+		return chartData;
+	}
+}
+
+TEST_CASE("Benchmark: KSH meta loading", "[.][benchmark][ksh_io]")
+{
+	constexpr std::size_t kIterations = 200;
+
+	for (const std::string filename : { "Gram_lt.ksh", "Gram_ch.ksh", "Gram_ex.ksh", "Gram_in.ksh" })
+	{
+		const std::string content = ReadFileToString(g_assetsDir + "/" + filename);
+		REQUIRE(!content.empty());
+
+		std::size_t scanBytesRead = 0;
+		const double scanUs = MeasureAverageMicroseconds(kIterations, [&]
+		{
+			std::istringstream iss(content);
+			const auto meta = kson::ScanKshMetaChartData(iss);
+			REQUIRE(meta.error == kson::ErrorType::None);
+			scanBytesRead = iss.eof() ? content.size() : static_cast<std::size_t>(iss.tellg());
+		});
+
+		std::size_t loadBytesRead = 0;
+		const double loadUs = MeasureAverageMicroseconds(kIterations, [&]
+		{
+			std::istringstream iss(content);
+			const auto meta = kson::LoadKshMetaChartData(iss);
+			REQUIRE(meta.error == kson::ErrorType::None);
+			loadBytesRead = iss.eof() ? content.size() : static_cast<std::size_t>(iss.tellg());
+		});
+
+		std::cout << filename << " (" << content.size() << " bytes)\n"
+			<< "  ScanKshMetaChartData: " << scanUs << " us/file, " << scanBytesRead << " bytes read\n"
+			<< "  LoadKshMetaChartData: " << loadUs << " us/file, " << loadBytesRead << " bytes read\n";
+	}
+}
+
+TEST_CASE("Benchmark: KSH numeric parsing", "[.][benchmark][ksh_io]")
+{
+	constexpr std::size_t kIterations = 20;
+	constexpr std::size_t kNumMeasures = 2000;
+
+	// Synthetic chart where most lines are numeric option values (including malformed ones)
+	std::ostringstream oss;
+	oss << "title=Benchmark\nt=120\n--\n";
+	for (std::size_t i = 0; i < kNumMeasures; ++i)
+	{
+		oss << "t=" << (120 + i % 60) << ".5\n"
+			<< "zoom_top=" << static_cast<int>(i % 300) - 150 << "\n"
+			<< "zoom_bottom=" << (i % 2 == 0 ? "x" : "-12.25") << "\n"
+			<< "tilt=" << (i % 3 == 0 ? "1.5" : "abc") << "\n"
+			<< "center_split=" << (i % 50) << ".125\n"
+			<< "0000|00|--\n--\n";
+	}
+	const std::string content = oss.str();
+
+	const double us = MeasureAverageMicroseconds(kIterations, [&]
+	{
+		const auto chartData = kson::LoadKshChartData(std::span<const char>(content.data(), content.size()));
+		REQUIRE(chartData.error == kson::ErrorType::None);
+	});
+
+	std::cout << "Numeric-heavy chart (" << kNumMeasures * 5 << " numeric values): " << us << " us/load\n";
+}
+
+TEST_CASE("Benchmark: Batch timing conversion", "[.][benchmark][timing]")
+{
+	constexpr std::size_t kIterations = 20;
+	constexpr std::size_t kNumNotes = 200000;
+	constexpr kson::Pulse kNoteInterval = 60;
+
+	kson::BeatInfo beat;
+	for (kson::Pulse pulse = 0; pulse < static_cast<kson::Pulse>(kNumNotes) * kNoteInterval; pulse += kson::kResolution * 16)
+	{
+		beat.bpm.emplace(pulse, 120.0 + static_cast<double>(pulse / (kson::kResolution * 16) % 60));
+	}
+	beat.timeSig.emplace(0, kson::TimeSig{ 4, 4 });
+
+	std::vector<kson::Pulse> pulses(kNumNotes);
+	for (std::size_t i = 0; i < kNumNotes; ++i)
+	{
+		pulses[i] = static_cast<kson::Pulse>(i) * kNoteInterval;
+	}
+	std::vector<double> secs(kNumNotes);
+
+	const auto cache = kson::CreateTimingCache(beat);
+	const double perNoteUs = MeasureAverageMicroseconds(kIterations, [&]
+	{
+		for (std::size_t i = 0; i < kNumNotes; ++i)
+		{
+			secs[i] = kson::PulseToSec(pulses[i], beat, cache);
+		}
+	});
+
+	const auto index = kson::CreateTimingIndex(beat);
+	const double batchUs = MeasureAverageMicroseconds(kIterations, [&]
+	{
+		kson::PulsesToSec(pulses, secs, index);
+	});
+
+	std::cout << kNumNotes << " notes, " << beat.bpm.size() << " tempo changes\n"
+		<< "  PulseToSec (per note): " << perNoteUs << " us\n"
+		<< "  PulsesToSec (batch): " << batchUs << " us\n";
+}
+
+TEST_CASE("Benchmark: KSH saving (dense chart)", "[.][benchmark][ksh_io]")
+{
+	constexpr std::size_t kIterations = 5;
+	constexpr std::int64_t kNumMeasures = 100;
+
+	const kson::ChartData chartData = CreateDenseChartData(kNumMeasures);
+	std::size_t numNotes = 0;
+	for (const auto& lane : chartData.note.bt)
+	{
+		numNotes += lane.size();
+	}
+
+	std::size_t outputSize = 0;
+	const double us = MeasureAverageMicroseconds(kIterations, [&]
+	{
+		std::ostringstream oss;
+		REQUIRE(kson::SaveKshChartData(oss, chartData) == kson::ErrorType::None);
+		outputSize = oss.str().size();
+	});
+
+	std::cout << "Dense chart (" << kNumMeasures << " measures, " << numNotes << " BT notes, " << outputSize << " bytes): " << us << " us/save\n";
+}
+
+TEST_CASE("Benchmark: kson-bin loading", "[.][benchmark][kson_bin_io]")
+{
+	constexpr std::size_t kIterations = 200;
+
+	for (const std::string filename : { "Gram_lt.ksh", "Gram_ch.ksh", "Gram_ex.ksh", "Gram_in.ksh" })
+	{
+		const kson::ChartData chartData = kson::LoadKshChartData(g_assetsDir + "/" + filename);
+		REQUIRE(chartData.error == kson::ErrorType::None);
+
+		std::ostringstream ksonStream;
+		REQUIRE(kson::SaveKsonChartData(ksonStream, chartData) == kson::ErrorType::None);
+		const std::string kson = ksonStream.str();
+
+		std::ostringstream binStream;
+		REQUIRE(kson::SaveKsonBinChartData(binStream, chartData) == kson::ErrorType::None);
+		const std::string bin = binStream.str();
+		std::vector<std::uint64_t> alignedBin((bin.size() + 7) / 8);
+		std::memcpy(alignedBin.data(), bin.data(), bin.size());
+		const std::span<const char> binSpan(reinterpret_cast<const char*>(alignedBin.data()), bin.size());
+
+		const double ksonUs = MeasureAverageMicroseconds(kIterations, [&]
+		{
+			std::istringstream iss(kson);
+			REQUIRE(kson::LoadKsonChartData(iss).error == kson::ErrorType::None);
+		});
+
+		const double binUs = MeasureAverageMicroseconds(kIterations, [&]
+		{
+			REQUIRE(kson::LoadKsonBinChartData(binSpan).error == kson::ErrorType::None);
+		});
+
+		const double viewUs = MeasureAverageMicroseconds(kIterations, [&]
+		{
+			REQUIRE(kson::KsonBinChartView(binSpan).error() == kson::ErrorType::None);
+		});
+
+		std::cout << filename << ": KSON " << ksonUs << " us (" << kson.size() << " bytes), kson-bin " << binUs << " us (" << bin.size() << " bytes), view " << viewUs << " us\n";
+	}
+}
+
+TEST_CASE("Benchmark: section-selective loading", "[.][benchmark][ksh_io][kson_io]")
+{
+	constexpr std::size_t kIterations = 50;
+
+	for (const std::string filename : { "Gram_ex.ksh", "Gram_in.ksh" })
+	{
+		const std::string kshContent = ReadFileToString(g_assetsDir + "/" + filename);
+		const kson::ChartData chartData = kson::LoadKshChartData(std::span<const char>(kshContent.data(), kshContent.size()));
+		REQUIRE(chartData.error == kson::ErrorType::None);
+
+		std::ostringstream oss;
+		REQUIRE(kson::SaveKsonChartData(oss, chartData) == kson::ErrorType::None);
+		const std::string ksonContent = oss.str();
+
+		std::cout << filename << "\n";
+		for (const auto& [name, options] : { std::pair{ "all", kson::ChartLoadingOptions{} }, std::pair{ "beat and note", kson::kChartLoadingOptionsBeatAndNote } })
+		{
+			const double kshUs = MeasureAverageMicroseconds(kIterations, [&]
+			{
+				const auto loaded = kson::LoadKshChartData(std::span<const char>(kshContent.data(), kshContent.size()), options);
+				REQUIRE(loaded.error == kson::ErrorType::None);
+			});
+
+			const double ksonUs = MeasureAverageMicroseconds(kIterations, [&]
+			{
+				std::istringstream iss(ksonContent);
+				const auto loaded = kson::LoadKsonChartData(iss, options);
+				REQUIRE(loaded.error == kson::ErrorType::None);
+			});
+
+			std::cout << "  " << name << ": KSH " << kshUs << " us/load, KSON " << ksonUs << " us/load\n";
+		}
+	}
+}
+
+TEST_CASE("Benchmark: KSH laser curve attachment", "[.][benchmark][ksh_io]")
+{
+	constexpr std::size_t kIterations = 5;
+	constexpr std::size_t kNumMeasures = 4000;
+
+	// Synthetic chart where every laser point has a curve (as written by newer editors)
+	std::ostringstream oss;
+	oss << "title=Benchmark\nt=120\nver=170\n--\n";
+	for (std::size_t i = 0; i < kNumMeasures; ++i)
+	{
+		oss << "laser_l_curve=0.25;0.75\nlaser_r_curve=0.5;0.5\n0000|00|0o\n"
+			<< "laser_l_curve=0.75;0.25\nlaser_r_curve=0.5;0.5\n0000|00|o0\n"
+			<< "0000|00|--\n"
+			<< "0000|00|--\n--\n";
+	}
+	const std::string content = oss.str();
+
+	const double us = MeasureAverageMicroseconds(kIterations, [&]
+	{
+		const auto chartData = kson::LoadKshChartData(std::span<const char>(content.data(), content.size()));
+		REQUIRE(chartData.error == kson::ErrorType::None);
+		REQUIRE(chartData.note.laser[0].size() == kNumMeasures);
+	});
+
+	std::cout << "Curve-heavy chart (" << kNumMeasures << " laser sections and " << kNumMeasures * 4 << " curves): " << us << " us/load\n";
+}
+
+TEST_CASE("Benchmark: loading into a chart arena", "[.][benchmark][chart_memory_resource]")
+{
+	constexpr std::size_t kIterations = 50;
+
+	for (const std::string filename : { "Gram_ex.ksh", "Gram_in.ksh" })
+	{
+		const std::string content = ReadFileToString(g_assetsDir + "/" + filename);
+		const std::span<const char> contentSpan(content.data(), content.size());
+
+		const double heapUs = MeasureAverageMicroseconds(kIterations, [&]
+		{
+			const auto chartData = kson::LoadKshChartData(contentSpan);
+			REQUIRE(chartData.error == kson::ErrorType::None);
+		});
+
+		// Note: The arena is effective only if KSON_USE_CHART_ALLOCATOR is defined
+		const double arenaUs = MeasureAverageMicroseconds(kIterations, [&]
+		{
+			std::pmr::monotonic_buffer_resource arena;
+			const kson::ScopedChartMemoryResource scope(&arena);
+			const auto chartData = kson::LoadKshChartData(contentSpan);
+			REQUIRE(chartData.error == kson::ErrorType::None);
+		});
+
+		std::cout << filename << ": heap " << heapUs << " us/load, arena " << arenaUs << " us/load (kUseChartAllocator: " << kson::kUseChartAllocator << ")\n";
+	}
+}
+
+TEST_CASE("Benchmark: KSH saving with many audio effect definitions", "[.][benchmark][ksh_io][audio_effect]")
+{
+	constexpr std::size_t kIterations = 5;
+	constexpr std::int64_t kNumMeasures = 2000;
+	constexpr std::size_t kNumDefs = 500;
+
+	kson::ChartData chartData;
+	chartData.meta.title = "Heavy FX";
+	chartData.beat.bpm.emplace(0, 180.0);
+	chartData.beat.timeSig.emplace(0, kson::TimeSig{ 4, 4 });
+	for (std::size_t i = 0; i < kNumDefs; ++i)
+	{
+		chartData.audio.audioEffect.fx.def.push_back({ "fx" + std::to_string(i), { kson::AudioEffectType::Retrigger, { { "update_period", "1/2" } } } });
+	}
+	for (std::int64_t measureIdx = 0; measureIdx < kNumMeasures; ++measureIdx)
+	{
+		const kson::Pulse y = measureIdx * kson::kResolution4;
+		const std::size_t laneIdx = static_cast<std::size_t>(measureIdx % kson::kNumFXLanes);
+		chartData.note.fx[laneIdx].emplace(y, kson::Interval{ kson::kResolution });
+		chartData.audio.audioEffect.fx.longEvent["fx" + std::to_string(measureIdx % kNumDefs)][laneIdx].emplace(y, kson::AudioEffectParams{ { "wave_length", "1/8" } });
+	}
+
+	const double us = MeasureAverageMicroseconds(kIterations, [&]
+	{
+		std::ostringstream oss;
+		REQUIRE(kson::SaveKshChartData(oss, chartData) == kson::ErrorType::None);
+	});
+
+	std::cout << "Heavy FX chart (" << kNumDefs << " definitions, " << kNumMeasures << " FX long notes): " << us << " us/save\n";
+}
+
+TEST_CASE("Benchmark: audio effect parameter evaluation", "[.][benchmark][audio_effect]")
+{
+	constexpr std::size_t kIterations = 5;
+	constexpr std::size_t kNumBlocks = 100000;
+
+	kson::AudioEffectInfo audioEffect;
+	audioEffect.laser.def.push_back({ "pf", { kson::AudioEffectType::PeakingFilter, { { "freq", "80Hz-8kHz" }, { "gain", "-6dB>12dB" }, { "q", "1.2" }, { "mix", "0%>100%" } } } });
+	const kson::AudioEffectDef& def = audioEffect.laser.def.front().v;
+
+	const kson::InternedAudioEffectInfo interned = kson::CreateInternedAudioEffectInfo(audioEffect);
+	const kson::CompiledAudioEffectInfo compiled = kson::CompileAudioEffectInfo(interned);
+	const kson::CompiledAudioEffect& effect = compiled.laser.effects.front();
+
+	// Parsing the parameter strings for each audio block
+	double parseSum = 0.0;
+	const double parseUs = MeasureAverageMicroseconds(kIterations, [&]
+	{
+		for (std::size_t i = 0; i < kNumBlocks; ++i)
+		{
+			const double laserValue = static_cast<double>(i % 100) / 100;
+			for (const auto& [key, value] : def.v)
+			{
+				parseSum += kson::ParseAudioEffectParamValue(value).evaluate(laserValue).v;
+			}
+		}
+	});
+
+	// Evaluating the compiled parameters for each audio block
+	double evaluateSum = 0.0;
+	const double evaluateUs = MeasureAverageMicroseconds(kIterations, [&]
+	{
+		for (std::size_t i = 0; i < kNumBlocks; ++i)
+		{
+			const double laserValue = static_cast<double>(i % 100) / 100;
+			for (const auto& scalar : effect.evaluate(static_cast<kson::Pulse>(i), laserValue))
+			{
+				evaluateSum += scalar.v;
+			}
+		}
+	});
+
+	REQUIRE(parseSum == Approx(evaluateSum));
+	std::cout << kNumBlocks << " blocks: parse " << parseUs << " us, evaluate " << evaluateUs << " us\n";
+}
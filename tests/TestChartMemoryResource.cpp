@@ -0,0 +1,96 @@
+#include <catch2/catch.hpp>
+#include <kson/kson.hpp>
+#include <memory>
+#include "TestUtils.hpp"
+
+extern std::string g_assetsDir;
+
+namespace
+{
+	// Counts the allocations passed through to the upstream resource
+	class CountingMemoryResource : public std::pmr::memory_resource
+	{
+	private:
+		std::pmr::memory_resource* m_upstream;
+		std::size_t m_numAllocations = 0;
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override
+		{
+			++m_numAllocations;
+			return m_upstream->allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+		{
+			m_upstream->deallocate(p, bytes, alignment);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+
+	public:
+		explicit CountingMemoryResource(std::pmr::memory_resource* upstream)
+			: m_upstream(upstream)
+		{
+		}
+
+		std::size_t numAllocations() const
+		{
+			return m_numAllocations;
+		}
+	};
+}
+
+TEST_CASE("Scoped chart memory resource", "[chart_memory_resource]")
+{
+	REQUIRE(kson::CurrentChartMemoryResource() == std::pmr::new_delete_resource());
+
+	std::pmr::monotonic_buffer_resource arena;
+	{
+		const kson::ScopedChartMemoryResource scope(&arena);
+		REQUIRE(kson::CurrentChartMemoryResource() == &arena);
+		{
+			const kson::ScopedChartMemoryResource nestedScope(std::pmr::null_memory_resource());
+			REQUIRE(kson::CurrentChartMemoryResource() == std::pmr::null_memory_resource());
+		}
+		REQUIRE(kson::CurrentChartMemoryResource() == &arena);
+	}
+	REQUIRE(kson::CurrentChartMemoryResource() == std::pmr::new_delete_resource());
+}
+
+TEST_CASE("Loading a chart into an arena", "[chart_memory_resource][bundled]")
+{
+	const std::string filePath = g_assetsDir + "/Gram_ex.ksh";
+	const std::string expected = SaveKsonToString(kson::LoadKshChartData(filePath));
+
+	kson::ChartData copied;
+	{
+		CountingMemoryResource arena(std::pmr::new_delete_resource());
+		std::unique_ptr<kson::ChartData> pChartData;
+		{
+			const kson::ScopedChartMemoryResource scope(&arena);
+			pChartData = std::make_unique<kson::ChartData>(kson::LoadKshChartData(filePath));
+		}
+		REQUIRE(pChartData->error == kson::ErrorType::None);
+		REQUIRE(SaveKsonToString(*pChartData) == expected);
+
+#ifdef KSON_USE_CHART_ALLOCATOR
+		REQUIRE(arena.numAllocations() > 0);
+		REQUIRE(pChartData->note.bt[0].get_allocator().resource() == &arena);
+		REQUIRE(pChartData->note.laser[0].begin()->second.v.get_allocator().resource() == &arena);
+		REQUIRE(pChartData->audio.audioEffect.laser.pulseEvent.begin()->second.get_allocator().resource() == &arena);
+#else
+		REQUIRE(arena.numAllocations() == 0);
+#endif
+
+		// Copies made outside the scope do not depend on the arena
+		copied = *pChartData;
+		const std::size_t numAllocations = arena.numAllocations();
+		const kson::ChartData copyConstructed = *pChartData;
+		REQUIRE(arena.numAllocations() == numAllocations);
+		REQUIRE(SaveKsonToString(copyConstructed) == expected);
+	}
+	REQUIRE(SaveKsonToString(copied) == expected);
+}
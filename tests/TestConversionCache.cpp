@@ -0,0 +1,128 @@
+#include <catch2/catch.hpp>
+#include <kson/kson.hpp>
+#include <kson/IO/ConversionCache.hpp>
+#include <filesystem>
+#include <fstream>
+#include "TestUtils.hpp"
+
+extern std::string g_assetsDir;
+
+namespace
+{
+	// Creates an empty directory that is removed at the end of the scope
+	class TemporaryDirectory
+	{
+	private:
+		std::filesystem::path m_path;
+
+	public:
+		explicit TemporaryDirectory(const std::string& name)
+			: m_path(std::filesystem::temp_directory_path() / name)
+		{
+			std::filesystem::remove_all(m_path);
+			std::filesystem::create_directories(m_path);
+		}
+
+		~TemporaryDirectory()
+		{
+			std::error_code ec;
+			std::filesystem::remove_all(m_path, ec);
+		}
+
+		std::string string() const
+		{
+			return m_path.string();
+		}
+
+		std::size_t numFiles() const
+		{
+			std::size_t count = 0;
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(m_path))
+			{
+				if (entry.is_regular_file())
+				{
+					++count;
+				}
+			}
+			return count;
+		}
+	};
+}
+
+TEST_CASE("Conversion cache", "[conversion_cache]")
+{
+	const TemporaryDirectory dir("kson_test_conversion_cache");
+	const kson::ConversionCache cache(dir.string(), "test 1.0");
+
+	const std::string input = "title=a\n--\n";
+	const std::span<const char> inputSpan(input.data(), input.size());
+
+	SECTION("Keys") {
+		const std::string key = cache.keyOf(inputSpan, kson::ConversionCacheFormat::kKson);
+		REQUIRE(key == cache.keyOf(inputSpan, kson::ConversionCacheFormat::kKson));
+		REQUIRE(key.ends_with(std::string("_").append(std::to_string(input.size())).append(".kson")));
+		REQUIRE(key != cache.keyOf(inputSpan, kson::ConversionCacheFormat::kKsonBin));
+		REQUIRE(key != cache.keyOf(inputSpan.first(input.size() - 1), kson::ConversionCacheFormat::kKson));
+		REQUIRE(key != kson::ConversionCache(dir.string(), "test 1.1").keyOf(inputSpan, kson::ConversionCacheFormat::kKson));
+	}
+
+	SECTION("Keys of inputs differing in the high bits of two words") {
+		// Note: This pair collided when the hash was FNV-1a over 64-bit words
+		const std::string a(32, 'a');
+		std::string b = a;
+		b[7] ^= static_cast<char>(0x80);
+		b[15] ^= static_cast<char>(0x80);
+		REQUIRE(cache.keyOf(std::span<const char>(a.data(), a.size()), kson::ConversionCacheFormat::kKson)
+			!= cache.keyOf(std::span<const char>(b.data(), b.size()), kson::ConversionCacheFormat::kKson));
+	}
+
+	SECTION("Store and load") {
+		const std::string key = cache.keyOf(inputSpan, kson::ConversionCacheFormat::kKson);
+		REQUIRE_FALSE(cache.load(key).has_value());
+
+		REQUIRE(cache.store(key, "content") == kson::ErrorType::None);
+		REQUIRE(cache.load(key) == "content");
+
+		REQUIRE(cache.store(key, "content2") == kson::ErrorType::None);
+		REQUIRE(cache.load(key) == "content2");
+
+		// Temporary files must not be left
+		REQUIRE(dir.numFiles() == 1);
+	}
+}
+
+TEST_CASE("Loading KSH through the conversion cache", "[conversion_cache][bundled]")
+{
+	const TemporaryDirectory dir("kson_test_ksh_cache");
+	const kson::ConversionCache cache(dir.string(), "test 1.0");
+
+	const std::string filePath = g_assetsDir + "/Gram_ex.ksh";
+	const std::string input = ReadFileToString(filePath);
+	const std::string expected = SaveKsonToString(kson::LoadKshChartData(filePath));
+
+	// Miss
+	const kson::ChartData first = kson::LoadKshChartDataWithCache(filePath, cache);
+	REQUIRE(first.error == kson::ErrorType::None);
+	REQUIRE(SaveKsonToString(first) == expected);
+
+	const std::string cacheFilePath = cache.filePathOf(cache.keyOf(std::span<const char>(input.data(), input.size()), kson::ConversionCacheFormat::kKsonBin));
+	REQUIRE(std::filesystem::exists(cacheFilePath));
+	REQUIRE(dir.numFiles() == 1);
+
+	// Hit
+	const kson::ChartData second = kson::LoadKshChartDataWithCache(filePath, cache);
+	REQUIRE(second.error == kson::ErrorType::None);
+	REQUIRE(SaveKsonToString(second) == expected);
+
+	// A broken entry is replaced
+	{
+		std::ofstream ofs(cacheFilePath, std::ios_base::binary | std::ios_base::trunc);
+		ofs << "broken";
+	}
+	const kson::ChartData third = kson::LoadKshChartDataWithCache(filePath, cache);
+	REQUIRE(third.error == kson::ErrorType::None);
+	REQUIRE(SaveKsonToString(third) == expected);
+	REQUIRE(kson::LoadKsonBinChartData(cacheFilePath).error == kson::ErrorType::None);
+
+	REQUIRE(kson::LoadKshChartDataWithCache(g_assetsDir + "/not_found.ksh", cache).error == kson::ErrorType::FileNotFound);
+}
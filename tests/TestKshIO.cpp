@@ -6,6 +6,9 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <mutex>
+#include <atomic>
+#include "TestUtils.hpp"
 
 extern std::string g_assetsDir;
 extern std::filesystem::path g_exeDir;
@@ -629,6 +632,47 @@ TEST_CASE("KSH Curve Parameter Loading", "[ksh_io][curve]") {
         REQUIRE(laserR.v.at(0).curve.a == Approx(0.7));
         REQUIRE(laserR.v.at(0).curve.b == Approx(0.3));
     }
+
+    SECTION("Laser curves in multiple sections") {
+        std::stringstream ss;
+        ss << "title=Curve Test\n";
+        ss << "t=120\n";
+        ss << "ver=170\n";
+        ss << "--\n";
+        ss << "laser_l_curve=0.1;0.9\n"; // Before the first section
+        ss << "0000|00|--\n";
+        ss << "laser_l_curve=0.2;0.8\n"; // First point of section 1
+        ss << "0000|00|0-\n";
+        ss << "laser_l_curve=0.3;0.7\n"; // Last point of section 1
+        ss << "0000|00|o-\n";
+        ss << "laser_l_curve=0.4;0.6\n"; // Between sections
+        ss << "0000|00|--\n";
+        ss << "--\n";
+        ss << "0000|00|0-\n";
+        ss << "laser_l_curve=0.5;0.5\n"; // Connection line (no point) of section 2
+        ss << "0000|00|:-\n";
+        ss << "laser_l_curve=0.6;0.4\n"; // Last point of section 2
+        ss << "0000|00|o-\n";
+        ss << "laser_l_curve=0.7;0.3\n"; // After the last section
+        ss << "0000|00|--\n";
+        ss << "--\n";
+
+        kson::ChartData chart = kson::LoadKshChartData(ss);
+        REQUIRE(chart.error == kson::ErrorType::None);
+        REQUIRE(chart.note.laser[0].size() == 2);
+
+        const auto& [section1Pulse, section1] = *chart.note.laser[0].begin();
+        REQUIRE(section1Pulse == kMeasurePulse / 4);
+        REQUIRE(section1.v.size() == 2);
+        REQUIRE(section1.v.at(0).curve.a == Approx(0.2));
+        REQUIRE(section1.v.at(kMeasurePulse / 4).curve.a == Approx(0.3));
+
+        const auto& [section2Pulse, section2] = *std::next(chart.note.laser[0].begin());
+        REQUIRE(section2Pulse == kMeasurePulse);
+        REQUIRE(section2.v.size() == 2);
+        REQUIRE(section2.v.at(0).curve.isLinear());
+        REQUIRE(section2.v.at(kMeasurePulse / 2).curve.a == Approx(0.6));
+    }
 }
 
 TEST_CASE("KSH scroll_speed Loading", "[ksh_io][scroll_speed]") {
@@ -2477,3 +2521,411 @@ TEST_CASE("KSH multiple comments at same pulse", "[ksh_io][comment]")
 	REQUIRE(comments.count("Comment 3") == 1);
 }
 
+TEST_CASE("KSH center_split and zoom curves round-trip", "[ksh_io][camera]")
+{
+	constexpr kson::Pulse kMeasurePulse = kson::kResolution4;
+
+	kson::ChartData chartData;
+	chartData.meta.title = "Test Camera Curves";
+	chartData.meta.artist = "Test";
+	chartData.meta.chartAuthor = "Test";
+	chartData.meta.level = 1;
+	chartData.meta.difficulty.idx = 0;
+	chartData.beat.bpm[0] = 120.0;
+	chartData.beat.timeSig[0] = kson::TimeSig{ .n = 4, .d = 4 };
+
+	auto& cam = chartData.camera.cam.body;
+	cam.centerSplit.emplace(0, kson::GraphPoint(kson::GraphValue(65.0, 30.0), kson::GraphCurveValue(0.5, 0.5)));
+	cam.centerSplit.emplace(kMeasurePulse, kson::GraphPoint(kson::GraphValue(-12.0)));
+	cam.zoomTop.emplace(0, kson::GraphPoint(kson::GraphValue(100.0), kson::GraphCurveValue(0.3, 0.7)));
+	cam.zoomBottom.emplace(kMeasurePulse / 2, kson::GraphPoint(kson::GraphValue(50.0), kson::GraphCurveValue(0.4, 0.6)));
+	cam.zoomSide.emplace(kMeasurePulse, kson::GraphPoint(kson::GraphValue(-25.0), kson::GraphCurveValue(0.25, 0.75)));
+
+	// Values with more than 3 decimal places are written with 6 significant digits
+	cam.centerSplit.emplace(kMeasurePulse * 2, kson::GraphPoint(kson::GraphValue(12.3456), kson::GraphCurveValue(0.1234, 0.5678)));
+	cam.zoomTop.emplace(kMeasurePulse * 2, kson::GraphPoint(kson::GraphValue(80.0), kson::GraphCurveValue(0.12345678, 0.9)));
+
+	std::ostringstream oss;
+	const kson::ErrorType result = kson::SaveKshChartData(oss, chartData);
+	REQUIRE(result == kson::ErrorType::None);
+
+	const std::string kshOutput = oss.str();
+	INFO("KSH output:\n" << kshOutput);
+
+	REQUIRE(kshOutput.find("center_split=65\r\n") != std::string::npos);
+	REQUIRE(kshOutput.find("center_split=30\r\n") != std::string::npos);
+	REQUIRE(kshOutput.find("center_split=-12\r\n") != std::string::npos);
+	REQUIRE(kshOutput.find("center_split_curve=0.5;0.5\r\n") != std::string::npos);
+	REQUIRE(kshOutput.find("zoom_top_curve=0.3;0.7\r\n") != std::string::npos);
+	REQUIRE(kshOutput.find("zoom_bottom_curve=0.4;0.6\r\n") != std::string::npos);
+	REQUIRE(kshOutput.find("zoom_side_curve=0.25;0.75\r\n") != std::string::npos);
+	REQUIRE(kshOutput.find("center_split=12.3456\r\n") != std::string::npos);
+	REQUIRE(kshOutput.find("center_split_curve=0.1234;0.5678\r\n") != std::string::npos);
+	REQUIRE(kshOutput.find("zoom_top_curve=0.123457;0.9\r\n") != std::string::npos);
+
+	std::istringstream iss(kshOutput);
+	const kson::ChartData chartData2 = kson::LoadKshChartData(iss);
+	REQUIRE(chartData2.error == kson::ErrorType::None);
+
+	const auto& cam2 = chartData2.camera.cam.body;
+	REQUIRE(cam2.centerSplit.contains(0));
+	REQUIRE(cam2.centerSplit.at(0).v.v == Approx(65.0));
+	REQUIRE(cam2.centerSplit.at(0).v.vf == Approx(30.0));
+	REQUIRE(cam2.centerSplit.at(0).curve.a == Approx(0.5));
+	REQUIRE(cam2.centerSplit.at(0).curve.b == Approx(0.5));
+	REQUIRE(cam2.centerSplit.contains(kMeasurePulse));
+	REQUIRE(cam2.centerSplit.at(kMeasurePulse).v.v == Approx(-12.0));
+
+	REQUIRE(cam2.zoomTop.contains(0));
+	REQUIRE(cam2.zoomTop.at(0).v.v == Approx(100.0));
+	REQUIRE(cam2.zoomTop.at(0).curve.a == Approx(0.3));
+	REQUIRE(cam2.zoomTop.at(0).curve.b == Approx(0.7));
+
+	REQUIRE(cam2.zoomBottom.contains(kMeasurePulse / 2));
+	REQUIRE(cam2.zoomBottom.at(kMeasurePulse / 2).v.v == Approx(50.0));
+	REQUIRE(cam2.zoomBottom.at(kMeasurePulse / 2).curve.a == Approx(0.4));
+	REQUIRE(cam2.zoomBottom.at(kMeasurePulse / 2).curve.b == Approx(0.6));
+
+	REQUIRE(cam2.zoomSide.contains(kMeasurePulse));
+	REQUIRE(cam2.zoomSide.at(kMeasurePulse).v.v == Approx(-25.0));
+	REQUIRE(cam2.zoomSide.at(kMeasurePulse).curve.a == Approx(0.25));
+	REQUIRE(cam2.zoomSide.at(kMeasurePulse).curve.b == Approx(0.75));
+
+	// Note: center_split is loaded as an integer value
+	REQUIRE(cam2.centerSplit.contains(kMeasurePulse * 2));
+	REQUIRE(cam2.centerSplit.at(kMeasurePulse * 2).v.v == Approx(12.0));
+	REQUIRE(cam2.centerSplit.at(kMeasurePulse * 2).curve.a == 0.1234);
+	REQUIRE(cam2.centerSplit.at(kMeasurePulse * 2).curve.b == 0.5678);
+	REQUIRE(cam2.zoomTop.contains(kMeasurePulse * 2));
+	REQUIRE(cam2.zoomTop.at(kMeasurePulse * 2).curve.a == 0.123457);
+}
+
+TEST_CASE("KSH loading from memory buffer", "[ksh_io][buffer]")
+{
+	SECTION("Buffer overload produces the same result as stream overload") {
+		for (const std::string filename : { "Gram_lt.ksh", "Gram_ch.ksh", "Gram_ex.ksh", "Gram_in.ksh" })
+		{
+			INFO("Testing file: " << filename);
+
+			std::ifstream ifs(g_assetsDir + "/" + filename, std::ios_base::binary);
+			REQUIRE(ifs.good());
+			const std::string buffer((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+			std::istringstream iss(buffer);
+			const auto chartFromStream = kson::LoadKshChartData(iss);
+			const auto chartFromBuffer = kson::LoadKshChartData(std::span<const char>(buffer.data(), buffer.size()));
+			REQUIRE(chartFromStream.error == kson::ErrorType::None);
+			REQUIRE(chartFromBuffer.error == kson::ErrorType::None);
+
+			std::ostringstream ossStream;
+			std::ostringstream ossBuffer;
+			REQUIRE(kson::SaveKsonChartData(ossStream, chartFromStream) == kson::ErrorType::None);
+			REQUIRE(kson::SaveKsonChartData(ossBuffer, chartFromBuffer) == kson::ErrorType::None);
+			REQUIRE(ossStream.str() == ossBuffer.str());
+
+			const auto metaFromBuffer = kson::LoadKshMetaChartData(std::span<const char>(buffer.data(), buffer.size()));
+			REQUIRE(metaFromBuffer.error == kson::ErrorType::None);
+			REQUIRE(metaFromBuffer.meta.title == chartFromBuffer.meta.title);
+			REQUIRE(metaFromBuffer.meta.level == chartFromBuffer.meta.level);
+		}
+	}
+
+	SECTION("CRLF, BOM and missing trailing newline are handled") {
+		const std::string ksh = "\xEF\xBB\xBFtitle=Test\r\nartist=Test\r\nt=120\r\n--\r\n1000|00|--\r\n--";
+		const auto chartData = kson::LoadKshChartData(std::span<const char>(ksh.data(), ksh.size()));
+		REQUIRE(chartData.error == kson::ErrorType::None);
+		REQUIRE(chartData.meta.title == "Test");
+		REQUIRE(chartData.note.bt[0].size() == 1);
+	}
+
+	SECTION("Buffer without bar line is an error") {
+		const std::string ksh = "title=Test\nartist=Test\n";
+		const auto chartData = kson::LoadKshChartData(std::span<const char>(ksh.data(), ksh.size()));
+		REQUIRE(chartData.error == kson::ErrorType::GeneralChartFormatError);
+	}
+}
+
+TEST_CASE("KSH header-only meta scanning", "[ksh_io][meta_scan]")
+{
+	SECTION("Scanned fields match LoadKshMetaChartData") {
+		for (const std::string filename : { "Gram_lt.ksh", "Gram_ch.ksh", "Gram_ex.ksh", "Gram_in.ksh" })
+		{
+			INFO("Testing file: " << filename);
+
+			const auto expected = kson::LoadKshMetaChartData(g_assetsDir + "/" + filename);
+			const auto scanned = kson::ScanKshMetaChartData(g_assetsDir + "/" + filename);
+			REQUIRE(expected.error == kson::ErrorType::None);
+			REQUIRE(scanned.error == kson::ErrorType::None);
+
+			REQUIRE(scanned.meta.title == expected.meta.title);
+			REQUIRE(scanned.meta.artist == expected.meta.artist);
+			REQUIRE(scanned.meta.difficulty.idx == expected.meta.difficulty.idx);
+			REQUIRE(scanned.meta.difficulty.name == expected.meta.difficulty.name);
+			REQUIRE(scanned.meta.level == expected.meta.level);
+			REQUIRE(scanned.meta.dispBPM == expected.meta.dispBPM);
+			REQUIRE(scanned.meta.stdBPM == expected.meta.stdBPM);
+			REQUIRE(scanned.meta.jacketFilename == expected.meta.jacketFilename);
+			REQUIRE(scanned.audio.bgm.filename == expected.audio.bgm.filename);
+			REQUIRE(scanned.audio.bgm.vol == expected.audio.bgm.vol);
+			REQUIRE(scanned.audio.bgm.preview.offset == expected.audio.bgm.preview.offset);
+			REQUIRE(scanned.audio.bgm.preview.duration == expected.audio.bgm.preview.duration);
+
+			// Other fields are not decoded
+			REQUIRE(scanned.meta.chartAuthor.empty());
+		}
+	}
+
+	SECTION("Stream is not read past the first bar line chunk") {
+		const std::string header = "title=Test\r\nartist=Artist\r\nlevel=25\r\ndifficulty=extended\r\nt=120-240\r\n--\r\n";
+		const std::string ksh = header + std::string(100000, '/') + "\r\n--\r\n";
+		std::istringstream iss(ksh);
+		const auto scanned = kson::ScanKshMetaChartData(iss);
+		REQUIRE(scanned.error == kson::ErrorType::None);
+		REQUIRE(scanned.meta.title == "Test");
+		REQUIRE(scanned.meta.level == 20);
+		REQUIRE(scanned.meta.difficulty.idx == 2);
+		REQUIRE(scanned.meta.dispBPM == "120-240");
+		REQUIRE(static_cast<std::size_t>(iss.tellg()) < ksh.size());
+	}
+
+	SECTION("Bar line beyond maxBytes is an error") {
+		const std::string ksh = "title=Test\n" + std::string(200, 'x') + "\n--\n";
+		REQUIRE(kson::ScanKshMetaChartData(std::span<const char>(ksh.data(), ksh.size()), 100).error == kson::ErrorType::GeneralChartFormatError);
+		REQUIRE(kson::ScanKshMetaChartData(std::span<const char>(ksh.data(), ksh.size())).error == kson::ErrorType::None);
+
+		std::istringstream iss(ksh);
+		REQUIRE(kson::ScanKshMetaChartData(iss, 100).error == kson::ErrorType::GeneralChartFormatError);
+	}
+
+	SECTION("Missing title is an error") {
+		const std::string ksh = "artist=Test\n--\n";
+		REQUIRE(kson::ScanKshMetaChartData(std::span<const char>(ksh.data(), ksh.size())).error == kson::ErrorType::GeneralChartFormatError);
+	}
+}
+
+TEST_CASE("KSH numeric value parsing", "[ksh_io][numeric]")
+{
+	const std::string ksh = "title=Test\nlevel=+5\nto= 150.5\npo=abc\nplength=12000ms\nt=128.25\n--\nzoom_top=-150\n0000|00|--\n--\n";
+	std::istringstream iss(ksh);
+	const auto chartData = kson::LoadKshChartData(iss);
+	REQUIRE(chartData.error == kson::ErrorType::None);
+	REQUIRE(chartData.meta.level == 5);
+	REQUIRE(chartData.meta.stdBPM == 150.5);
+	REQUIRE(chartData.audio.bgm.preview.offset == 0);
+	REQUIRE(chartData.audio.bgm.preview.duration == 12000);
+	REQUIRE(chartData.beat.bpm.at(0) == 128.25);
+	REQUIRE(chartData.camera.cam.body.zoomTop.at(0).v.v == -150.0);
+}
+
+TEST_CASE("KSH Shift-JIS loading", "[ksh_io][encoding]")
+{
+	// "テスト" in Shift-JIS
+	const std::string kTestSJIS = "\x83\x65\x83\x58\x83\x67";
+	const std::string kTestUTF8 = "\xE3\x83\x86\xE3\x82\xB9\xE3\x83\x88";
+
+	SECTION("Conversion appends to the caller-provided buffer") {
+		std::string dst = "title=";
+		REQUIRE(kson::Encoding::ShiftJISToUTF8(kTestSJIS, &dst));
+		REQUIRE(dst == "title=" + kTestUTF8);
+
+		REQUIRE(kson::Encoding::ShiftJISToUTF8("abc", &dst));
+		REQUIRE(dst == "title=" + kTestUTF8 + "abc");
+	}
+
+	SECTION("Built-in table covers ASCII, half-width katakana and double-byte characters") {
+		// "abc\" + half-width "ｱ" + "漢" + 0x5C as a trail byte ("表") + "0123456789"
+		std::string dst;
+		REQUIRE(kson::Encoding::ShiftJISToUTF8("abc\\\xB1\x8A\xBF\x95\x5C" "0123456789", &dst));
+		REQUIRE(dst == "abc\\\xEF\xBD\xB1\xE6\xBC\xA2\xE8\xA1\xA8" "0123456789");
+
+		// Invalid sequences are rejected and the buffer is left unchanged
+		dst = "x";
+		REQUIRE_FALSE(kson::Encoding::ShiftJISToUTF8("abc\x80", &dst));
+		REQUIRE_FALSE(kson::Encoding::ShiftJISToUTF8("\x81", &dst));
+		REQUIRE_FALSE(kson::Encoding::ShiftJISToUTF8("\x81\x7F", &dst));
+		REQUIRE(dst == "x");
+	}
+
+	SECTION("Whole Shift-JIS chart is converted to UTF-8") {
+		const std::string ksh = "title=" + kTestSJIS + "\r\nartist=" + kTestSJIS + "\r\nt=120\r\n--\r\n//" + kTestSJIS + "\r\n1000|00|--\r\n--\r\n";
+		std::istringstream iss(ksh);
+		const auto chartData = kson::LoadKshChartData(iss);
+		REQUIRE(chartData.error == kson::ErrorType::None);
+		REQUIRE(chartData.meta.title == kTestUTF8);
+		REQUIRE(chartData.meta.artist == kTestUTF8);
+		REQUIRE(chartData.editor.comment.size() == 1);
+		REQUIRE(chartData.editor.comment.begin()->second == kTestUTF8);
+
+		const auto metaData = kson::LoadKshMetaChartData(std::span<const char>(ksh.data(), ksh.size()));
+		REQUIRE(metaData.meta.title == kTestUTF8);
+	}
+}
+
+TEST_CASE("KSH/KSON batch loading", "[ksh_io][kson_io][batch]")
+{
+	std::vector<std::string> filePaths;
+	for (int i = 0; i < 3; ++i)
+	{
+		for (const std::string filename : { "Gram_lt.ksh", "Gram_ch.ksh", "Gram_ex.ksh", "Gram_in.ksh" })
+		{
+			filePaths.push_back(g_assetsDir + "/" + filename);
+		}
+	}
+	filePaths.push_back(g_assetsDir + "/not_found.ksh");
+
+	SECTION("Results are in the same order as the input paths") {
+		std::vector<kson::KshLoadingDiag> diags;
+		const auto results = kson::LoadKshChartDataBatch(filePaths, 4, &diags);
+		REQUIRE(results.size() == filePaths.size());
+		REQUIRE(diags.size() == filePaths.size());
+
+		for (std::size_t i = 0; i + 1 < filePaths.size(); ++i)
+		{
+			INFO("Testing file: " << filePaths[i]);
+			const auto expected = kson::LoadKshChartData(filePaths[i]);
+			REQUIRE(results[i].error == kson::ErrorType::None);
+			REQUIRE(results[i].meta.difficulty.idx == expected.meta.difficulty.idx);
+			REQUIRE(results[i].meta.level == expected.meta.level);
+			REQUIRE(results[i].note.bt[0].size() == expected.note.bt[0].size());
+		}
+		REQUIRE(results.back().error == kson::ErrorType::FileNotFound);
+	}
+
+	SECTION("Single thread and empty input") {
+		const auto results = kson::LoadKshChartDataBatch(filePaths, 1);
+		REQUIRE(results.size() == filePaths.size());
+		REQUIRE(results.front().error == kson::ErrorType::None);
+
+		REQUIRE(kson::LoadKshChartDataBatch({}, 4).empty());
+	}
+
+	SECTION("Sink receives each result exactly once") {
+		std::mutex mutex;
+		std::vector<int> callCounts(filePaths.size(), 0);
+		std::vector<kson::ErrorType> errors(filePaths.size(), kson::ErrorType::UnknownError);
+		kson::LoadKshChartDataBatch(filePaths, 4, [&](std::size_t i, kson::ChartData&& chartData, kson::KshLoadingDiag&&)
+		{
+			std::lock_guard lock(mutex);
+			++callCounts[i];
+			errors[i] = chartData.error;
+		});
+
+		for (std::size_t i = 0; i < filePaths.size(); ++i)
+		{
+			REQUIRE(callCounts[i] == 1);
+			REQUIRE(errors[i] == (i + 1 < filePaths.size() ? kson::ErrorType::None : kson::ErrorType::FileNotFound));
+		}
+	}
+
+	SECTION("Exception thrown by the sink is rethrown after the workers finish") {
+		std::atomic<int> numCalls{ 0 };
+		REQUIRE_THROWS_AS(kson::LoadKshChartDataBatch(filePaths, 4, [&](std::size_t, kson::ChartData&&, kson::KshLoadingDiag&&)
+		{
+			++numCalls;
+			throw std::runtime_error("sink error");
+		}), std::runtime_error);
+
+		// Note: Files already being loaded by the other workers may still be passed to the sink
+		REQUIRE(numCalls >= 1);
+		REQUIRE(numCalls <= 4);
+	}
+
+	SECTION("KSON batch loading") {
+		const std::vector<std::string> ksonFilePaths(8, g_assetsDir + "/Gram_ex.kson");
+		std::vector<kson::KsonLoadingDiag> diags;
+		const auto results = kson::LoadKsonChartDataBatch(ksonFilePaths, 0, &diags);
+		REQUIRE(results.size() == ksonFilePaths.size());
+		REQUIRE(diags.size() == ksonFilePaths.size());
+		for (const auto& chartData : results)
+		{
+			REQUIRE(chartData.error == kson::ErrorType::None);
+			REQUIRE(chartData.meta.title == results.front().meta.title);
+		}
+	}
+}
+
+namespace
+{
+	// Same as the full chart data except for the sections not selected by options
+	kson::ChartData ExpectedChartDataWithOptions(kson::ChartData chartData, const kson::ChartLoadingOptions& options)
+	{
+		if (!options.beat)
+		{
+			chartData.beat = {};
+			chartData.beat.timeSig.emplace(0, kson::TimeSig{ 4, 4 });
+			chartData.beat.scrollSpeed.emplace(0, kson::GraphValue{ 1.0, 1.0 });
+		}
+		if (!options.note)
+		{
+			chartData.note = {};
+			chartData.audio.keySound.fx.chipEvent.clear();
+			chartData.audio.keySound.laser.slamEvent.clear();
+			chartData.audio.audioEffect.fx.longEvent.clear();
+		}
+		if (!options.camera)
+		{
+			chartData.camera = {};
+			chartData.camera.tilt.emplace(0, kson::AutoTiltType::kNormal);
+		}
+		if (!options.audioEffect)
+		{
+			chartData.audio.audioEffect = {};
+			chartData.audio.audioEffect.laser.legacy.filterGain.emplace(0, 0.5);
+		}
+		if (!options.bg)
+		{
+			chartData.bg = {};
+		}
+		if (!options.editor)
+		{
+			chartData.editor = {};
+		}
+		if (!options.compat)
+		{
+			chartData.compat = {};
+		}
+		return chartData;
+	}
+}
+
+TEST_CASE("KSH/KSON section-selective loading", "[ksh_io][kson_io][loading_options]")
+{
+	const kson::ChartLoadingOptions cameraOnly{
+		.beat = false,
+		.note = false,
+		.camera = true,
+		.audioEffect = false,
+		.bg = false,
+		.editor = false,
+		.compat = false,
+	};
+	const kson::ChartLoadingOptions withoutCompat{ .compat = false };
+
+	for (const std::string filename : { "Gram_ex.ksh", "Gram_in.ksh" })
+	{
+		INFO("Testing file: " << filename);
+		const std::string filePath = g_assetsDir + "/" + filename;
+		const kson::ChartData full = kson::LoadKshChartData(filePath);
+		REQUIRE(full.error == kson::ErrorType::None);
+
+		for (const auto& options : { kson::ChartLoadingOptions{}, kson::kChartLoadingOptionsBeatAndNote, cameraOnly, withoutCompat })
+		{
+			const kson::ChartData loaded = kson::LoadKshChartData(filePath, options);
+			REQUIRE(loaded.error == kson::ErrorType::None);
+			REQUIRE(SaveKsonToString(loaded) == SaveKsonToString(ExpectedChartDataWithOptions(full, options)));
+		}
+
+		// KSON
+		std::stringstream ss(SaveKsonToString(full));
+		const kson::ChartData fullKson = kson::LoadKsonChartData(ss);
+		REQUIRE(fullKson.error == kson::ErrorType::None);
+
+		for (const auto& options : { kson::ChartLoadingOptions{}, kson::kChartLoadingOptionsBeatAndNote, cameraOnly, withoutCompat })
+		{
+			std::stringstream ssOptions(SaveKsonToString(full));
+			const kson::ChartData loaded = kson::LoadKsonChartData(ssOptions, options);
+			REQUIRE(loaded.error == kson::ErrorType::None);
+			REQUIRE(SaveKsonToString(loaded) == SaveKsonToString(ExpectedChartDataWithOptions(fullKson, options)));
+		}
+	}
+}
@@ -0,0 +1,181 @@
+#include <catch2/catch.hpp>
+#include <kson/kson.hpp>
+#include <kson/IO/KsonBinIO.hpp>
+#include <cstring>
+#include <sstream>
+#include "TestUtils.hpp"
+
+extern std::string g_assetsDir;
+
+namespace
+{
+	std::string SaveKsonBinToString(const kson::ChartData& chartData)
+	{
+		std::ostringstream oss;
+		REQUIRE(kson::SaveKsonBinChartData(oss, chartData) == kson::ErrorType::None);
+		return oss.str();
+	}
+
+	// Copies the content into a buffer aligned to 8 bytes as required by KsonBinChartView
+	std::vector<std::uint64_t> ToAlignedBuffer(const std::string& content)
+	{
+		std::vector<std::uint64_t> buffer((content.size() + 7) / 8);
+		std::memcpy(buffer.data(), content.data(), content.size());
+		return buffer;
+	}
+
+	std::span<const char> AsSpan(const std::vector<std::uint64_t>& buffer, std::size_t size)
+	{
+		return { reinterpret_cast<const char*>(buffer.data()), size };
+	}
+}
+
+TEST_CASE("kson-bin round trip (bundled charts)", "[kson_bin_io][bundled]")
+{
+	for (const std::string filename : { "Gram_lt.ksh", "Gram_ch.ksh", "Gram_ex.ksh", "Gram_in.ksh" })
+	{
+		const kson::ChartData chartData = kson::LoadKshChartData(g_assetsDir + "/" + filename);
+		REQUIRE(chartData.error == kson::ErrorType::None);
+
+		std::istringstream iss(SaveKsonBinToString(chartData));
+		const kson::ChartData loaded = kson::LoadKsonBinChartData(iss);
+		REQUIRE(loaded.error == kson::ErrorType::None);
+		REQUIRE(SaveKsonToString(loaded) == SaveKsonToString(chartData));
+		REQUIRE(loaded.compat.kshUnknown.meta == chartData.compat.kshUnknown.meta);
+	}
+}
+
+TEST_CASE("kson-bin round trip (non-note data)", "[kson_bin_io]")
+{
+	kson::ChartData chartData;
+	chartData.meta.title = "Title \xE3\x81\x82";
+	chartData.meta.difficulty.name = "ex";
+	chartData.beat.bpm[0] = 120.0;
+	chartData.beat.stop[960] = 240;
+	chartData.camera.tilt[0] = kson::AutoTiltType::kBigger;
+	chartData.camera.tilt[480] = kson::TiltGraphPoint{ kson::TiltGraphValue{ 1.0, kson::AutoTiltType::kZero } };
+	chartData.camera.tilt[960] = kson::TiltGraphPoint{ kson::TiltGraphValue{ 1.0, 2.0 }, kson::GraphCurveValue{ 0.25, 0.75 } };
+	chartData.camera.cam.body.zoomTop[0] = 100.0;
+	chartData.camera.cam.pattern.laser.slamEvent.swing[0] = { 1, 192, { 100.0, 4, 2 } };
+	chartData.audio.audioEffect.fx.def.push_back({ "re", kson::AudioEffectDef{ kson::AudioEffectType::Retrigger, { { "rate", "50%" } } } });
+	chartData.audio.audioEffect.fx.paramChange["re"]["rate"][480] = "60%";
+	chartData.audio.audioEffect.fx.longEvent["re"][1][0] = { { "rate", "70%" } };
+	chartData.audio.keySound.laser.slamEvent["slam"] = { 0, 960 };
+	chartData.editor.comment.emplace(0, "a");
+	chartData.editor.comment.emplace(0, "b");
+	chartData.compat.kshUnknown.meta["zeta"] = "1";
+	chartData.compat.kshUnknown.option["opt"].emplace(0, "value");
+	chartData.impl["key"] = { 1, 2 };
+
+	const std::string content = SaveKsonBinToString(chartData);
+	REQUIRE(content == SaveKsonBinToString(chartData));
+
+	const auto buffer = ToAlignedBuffer(content);
+	const kson::ChartData loaded = kson::LoadKsonBinChartData(AsSpan(buffer, content.size()));
+	REQUIRE(loaded.error == kson::ErrorType::None);
+	REQUIRE(SaveKsonToString(loaded) == SaveKsonToString(chartData));
+	REQUIRE(loaded.editor.comment == chartData.editor.comment);
+	REQUIRE(loaded.compat.kshUnknown.option == chartData.compat.kshUnknown.option);
+}
+
+TEST_CASE("kson-bin chart view", "[kson_bin_io]")
+{
+	const kson::ChartData chartData = kson::LoadKsonChartData(g_assetsDir + "/Gram_ex.kson");
+	REQUIRE(chartData.error == kson::ErrorType::None);
+
+	const std::string content = SaveKsonBinToString(chartData);
+	const auto buffer = ToAlignedBuffer(content);
+	const kson::KsonBinChartView view(AsSpan(buffer, content.size()));
+	REQUIRE(view.error() == kson::ErrorType::None);
+
+	REQUIRE(view.bpm().size() == chartData.beat.bpm.size());
+	REQUIRE(view.bpm()[0].v == chartData.beat.bpm.begin()->second);
+
+	for (std::size_t i = 0; i < kson::kNumBTLanesSZ; ++i)
+	{
+		const auto notes = view.bt(i);
+		REQUIRE(notes.size() == chartData.note.bt[i].size());
+
+		std::size_t idx = 0;
+		for (const auto& [y, note] : chartData.note.bt[i])
+		{
+			REQUIRE(notes[idx].y == y);
+			REQUIRE(notes[idx].length == note.length);
+			++idx;
+		}
+	}
+
+	for (std::size_t i = 0; i < kson::kNumLaserLanesSZ; ++i)
+	{
+		const auto sections = view.laserSections(i);
+		REQUIRE(sections.size() == chartData.note.laser[i].size());
+
+		std::size_t idx = 0;
+		for (const auto& [y, section] : chartData.note.laser[i])
+		{
+			REQUIRE(sections[idx].y == y);
+			REQUIRE(sections[idx].w == section.w);
+
+			const auto points = view.laserPoints(i, sections[idx]);
+			REQUIRE(points.size() == section.v.size());
+			REQUIRE(points.front().y == section.v.begin()->first);
+			REQUIRE(points.front().v == section.v.begin()->second.v.v);
+			++idx;
+		}
+	}
+
+	REQUIRE(view.numStrings() > 0);
+	REQUIRE(view.string(view.numStrings()).empty());
+}
+
+TEST_CASE("kson-bin validation", "[kson_bin_io]")
+{
+	kson::ChartData chartData;
+	chartData.meta.title = "Validation";
+	chartData.note.bt[0][0] = kson::Interval{ 0 };
+	const std::string content = SaveKsonBinToString(chartData);
+
+	SECTION("Valid data") {
+		const auto buffer = ToAlignedBuffer(content);
+		REQUIRE(kson::KsonBinChartView(AsSpan(buffer, content.size())).error() == kson::ErrorType::None);
+	}
+
+	SECTION("Corrupted payload") {
+		std::string corrupted = content;
+		corrupted[kson::kKsonBinHeaderSize + 40] ^= 0x01;
+		const auto buffer = ToAlignedBuffer(corrupted);
+		REQUIRE(kson::LoadKsonBinChartData(AsSpan(buffer, corrupted.size())).error == kson::ErrorType::KsonBinParseError);
+	}
+
+	SECTION("Corrupted high bits of two payload words") {
+		std::string corrupted = content;
+		corrupted[kson::kKsonBinHeaderSize + 39] ^= static_cast<char>(0x80);
+		corrupted[kson::kKsonBinHeaderSize + 47] ^= static_cast<char>(0x80);
+		const auto buffer = ToAlignedBuffer(corrupted);
+		REQUIRE(kson::LoadKsonBinChartData(AsSpan(buffer, corrupted.size())).error == kson::ErrorType::KsonBinParseError);
+	}
+
+	SECTION("Truncated data") {
+		const auto buffer = ToAlignedBuffer(content);
+		REQUIRE(kson::LoadKsonBinChartData(AsSpan(buffer, content.size() - 8)).error == kson::ErrorType::KsonBinParseError);
+		REQUIRE(kson::LoadKsonBinChartData(AsSpan(buffer, 16)).error == kson::ErrorType::KsonBinParseError);
+	}
+
+	SECTION("Different format version") {
+		std::string otherVersion = content;
+		const std::uint32_t version = kson::kKsonBinFormatVersion + 1;
+		std::memcpy(otherVersion.data() + 8, &version, sizeof(version));
+		const auto buffer = ToAlignedBuffer(otherVersion);
+		REQUIRE(kson::LoadKsonBinChartData(AsSpan(buffer, otherVersion.size())).error == kson::ErrorType::KsonBinParseError);
+	}
+
+	SECTION("Misaligned buffer") {
+		const auto buffer = ToAlignedBuffer("_" + content);
+		REQUIRE(kson::KsonBinChartView(AsSpan(buffer, content.size() + 1).subspan(1)).error() == kson::ErrorType::KsonBinParseError);
+	}
+
+	SECTION("Not a kson-bin file") {
+		std::istringstream iss(SaveKsonToString(chartData));
+		REQUIRE(kson::LoadKsonBinChartData(iss).error == kson::ErrorType::KsonBinParseError);
+	}
+}
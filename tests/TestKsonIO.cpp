@@ -182,6 +182,127 @@ TEST_CASE("KSON Loading", "[kson_io]") {
         auto chart = kson::LoadKsonChartData("non_existent_file.kson");
         REQUIRE(chart.error == kson::ErrorType::FileNotFound);
     }
+
+    SECTION("Key order does not affect loading") {
+        // format_version at the end, and sections in non-canonical order
+        std::string ksonData = R"({
+            "note": {
+                "laser": [[], [[0, [[0, 0.0], [240, 1.0]]], "invalid"]],
+                "bt": [[0, [240, 480], "invalid"], [], [], [], [960]],
+                "fx": [[], [[480, 240]]]
+            },
+            "impl": { "key": [1, 2] },
+            "unknown": { "nested": [[{}]] },
+            "meta": { "title": "Key Order" },
+            "format_version": 2
+        })";
+
+        std::istringstream stream(ksonData);
+        kson::KsonLoadingDiag ksonDiag;
+        auto chart = kson::LoadKsonChartData(stream, &ksonDiag);
+
+        REQUIRE(chart.error == kson::ErrorType::None);
+        REQUIRE(chart.meta.title == "Key Order");
+        REQUIRE(chart.note.bt[0].size() == 2);
+        REQUIRE(chart.note.bt[0].at(240).length == 480);
+        REQUIRE(chart.note.fx[1].at(480).length == 240);
+        REQUIRE(chart.note.laser[1].at(0).v.size() == 2);
+        REQUIRE(chart.impl["key"] == nlohmann::json::array({ 1, 2 }));
+
+        // Warnings are reported in the order of format_version, BT, and laser
+        REQUIRE(ksonDiag.warnings.size() == 3);
+        REQUIRE(ksonDiag.warnings[0].type == kson::KsonLoadingWarningType::NewerFormatVersion);
+        REQUIRE(ksonDiag.warnings[1].type == kson::KsonLoadingWarningType::InvalidNoteEntryFormat);
+        REQUIRE(ksonDiag.warnings[2].type == kson::KsonLoadingWarningType::InvalidLaserSectionFormat);
+    }
+
+    SECTION("Duplicate keys use the last value") {
+        std::string ksonData = R"({
+            "format_version": 1,
+            "meta": { "title": "First" },
+            "note": { "bt": [[0]] },
+            "meta": { "title": "Second" },
+            "note": { "fx": [[], [0]] }
+        })";
+
+        std::istringstream stream(ksonData);
+        auto chart = kson::LoadKsonChartData(stream);
+
+        REQUIRE(chart.error == kson::ErrorType::None);
+        REQUIRE(chart.meta.title == "Second");
+        REQUIRE(chart.note.bt[0].empty());
+        REQUIRE(chart.note.fx[1].contains(0));
+    }
+}
+
+TEST_CASE("KSON Meta Loading", "[kson_io][meta]") {
+    SECTION("Load meta and audio.bgm") {
+        std::string ksonData = R"({
+            "audio": {
+                "key_sound": { "fx": { "chip_event": {} } },
+                "bgm": { "filename": "song.ogg", "vol": 0.8, "preview": { "offset": 1000, "duration": 12000 } }
+            },
+            "beat": { "bpm": [[0, 120.0]] },
+            "meta": { "title": "Meta Test", "level": 12 },
+            "format_version": 1,
+            "note": { "bt": [[0, 240], [], [], []] }
+        })";
+
+        std::istringstream stream(ksonData);
+        auto meta = kson::LoadKsonMetaChartData(stream);
+
+        REQUIRE(meta.error == kson::ErrorType::None);
+        REQUIRE(meta.meta.title == "Meta Test");
+        REQUIRE(meta.meta.level == 12);
+        REQUIRE(meta.audio.bgm.filename == "song.ogg");
+        REQUIRE(meta.audio.bgm.vol == Approx(0.8));
+        REQUIRE(meta.audio.bgm.preview.offset == 1000);
+        REQUIRE(meta.audio.bgm.preview.duration == 12000);
+    }
+
+    SECTION("Parsing stops after meta and audio.bgm are found") {
+        // The malformed part after the needed values is never parsed
+        std::string ksonData = R"({
+            "format_version": 1,
+            "meta": { "title": "Early Exit" },
+            "audio": { "bgm": { "filename": "song.ogg" } },
+            "note": { "bt": [[0, 240], )";
+
+        std::istringstream stream(ksonData);
+        auto meta = kson::LoadKsonMetaChartData(stream);
+
+        REQUIRE(meta.error == kson::ErrorType::None);
+        REQUIRE(meta.meta.title == "Early Exit");
+        REQUIRE(meta.audio.bgm.filename == "song.ogg");
+    }
+
+    SECTION("First occurrence of a duplicate key is used") {
+        // Note: LoadKsonChartData uses the last occurrence instead
+        std::string ksonData = R"({
+            "format_version": 1,
+            "meta": { "title": "First" },
+            "audio": { "bgm": { "filename": "song.ogg" } },
+            "meta": { "title": "Second" }
+        })";
+
+        std::istringstream stream(ksonData);
+        auto meta = kson::LoadKsonMetaChartData(stream);
+
+        REQUIRE(meta.error == kson::ErrorType::None);
+        REQUIRE(meta.meta.title == "First");
+    }
+
+    SECTION("Missing format_version") {
+        std::string ksonData = R"({ "meta": { "title": "No Version" }, "note": {} })";
+
+        std::istringstream stream(ksonData);
+        kson::KsonLoadingDiag ksonDiag;
+        auto meta = kson::LoadKsonMetaChartData(stream, &ksonDiag);
+
+        REQUIRE(meta.error == kson::ErrorType::KsonParseError);
+        REQUIRE(ksonDiag.warnings.size() == 1);
+        REQUIRE(ksonDiag.warnings[0].type == kson::KsonLoadingWarningType::MissingFormatVersion);
+    }
 }
 
 TEST_CASE("KSON Round-trip", "[kson_io]") {
@@ -251,6 +372,48 @@ TEST_CASE("KSON Round-trip", "[kson_io]") {
         REQUIRE(loaded.note.laser[0].at(0).v.at(240).v.v == Approx(original.note.laser[0].at(0).v.at(240).v.v));
         REQUIRE(loaded.note.laser[0].at(0).w == original.note.laser[0].at(0).w);
     }
+
+    SECTION("Saved Gram_ex.kson matches the golden file") {
+        // Gram_ex_canonical.kson is the output of the former nlohmann::json DOM-based writer for Gram_ex.kson
+        std::ifstream ifs(g_assetsDir + "/Gram_ex_canonical.kson", std::ios::binary);
+        REQUIRE(ifs.good());
+        std::ostringstream golden;
+        golden << ifs.rdbuf();
+
+        auto chart = kson::LoadKsonChartData(g_assetsDir + "/Gram_ex.kson");
+        REQUIRE(chart.error == kson::ErrorType::None);
+
+        std::ostringstream oss;
+        REQUIRE(kson::SaveKsonChartData(oss, chart) == kson::ErrorType::None);
+        REQUIRE(oss.str() == golden.str());
+        REQUIRE(oss.str() == nlohmann::json::parse(oss.str()).dump());
+    }
+
+    SECTION("Saved output matches nlohmann::json::dump") {
+        kson::ChartData chart;
+        chart.meta.title = "Quote\" Backslash\\ Tab\t Control\x01 \xE3\x81\x82";
+        chart.meta.artist = "Artist";
+        chart.meta.stdBPM = 0.1 + 0.2;
+        chart.beat.bpm[0] = 120.0;
+        chart.beat.bpm[480] = 1e-9;
+        chart.beat.bpm[960] = 1e21;
+        chart.beat.timeSig[0] = kson::TimeSig{ 7, 8 };
+        chart.note.bt[0][0] = kson::Interval{ 0 };
+        chart.note.bt[0][240] = kson::Interval{ 480 };
+        chart.note.laser[1][0].v[0] = kson::GraphPoint{ kson::GraphValue{ 0.0, 1.0 }, kson::GraphCurveValue{ 0.25, 0.75 } };
+        chart.note.laser[1][0].w = kson::kLaserXScale2x;
+        chart.audio.audioEffect.fx.def.push_back({ "re", kson::AudioEffectDef{ kson::AudioEffectType::Retrigger, { { "rate", "50%" } } } });
+        chart.audio.audioEffect.fx.longEvent["re"][0][0] = {};
+        chart.camera.tilt[0] = kson::AutoTiltType::kBigger;
+        chart.camera.cam.pattern.laser.slamEvent.swing[0] = { 1, 192, { 100.0, 3, 2 } };
+        chart.compat.kshUnknown.meta["zeta"] = "1";
+        chart.compat.kshUnknown.meta["alpha"] = "2";
+        chart.impl["key"] = { { "b", 1 }, { "a", 2.5 } };
+
+        std::ostringstream oss;
+        REQUIRE(kson::SaveKsonChartData(oss, chart) == kson::ErrorType::None);
+        REQUIRE(oss.str() == nlohmann::json::parse(oss.str()).dump());
+    }
 }
 
 TEST_CASE("KSON Audio Effect Loading", "[kson_io][audio_effect]") {
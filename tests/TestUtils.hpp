@@ -0,0 +1,11 @@
+#pragma once
+#include <string>
+#include <kson/kson.hpp>
+
+// Helpers shared by the test files (defined in Main.cpp)
+
+// Reads the whole file as binary
+std::string ReadFileToString(const std::string& filePath);
+
+// Saves the chart data as KSON (fails the current test on error)
+std::string SaveKsonToString(const kson::ChartData& chartData);
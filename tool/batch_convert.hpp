@@ -0,0 +1,299 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "kson/Error.hpp"
+
+// Shared by the command line tools to convert many files in one process
+namespace batch_convert
+{
+	// Warning counts keyed by the warning type name
+	using WarningCounts = std::map<std::string, std::size_t>;
+
+	// Converts the content of input into *pOutput
+	using ConvertFunc = std::function<kson::ErrorType(std::istream& input, std::string* pOutput, WarningCounts* pWarningCounts)>;
+
+	struct Options
+	{
+		// Input directory, or the directory of the manifest file
+		std::filesystem::path baseDir;
+
+		// Input files (absolute or relative to the current directory)
+		std::vector<std::filesystem::path> inputPaths;
+
+		// Output tree root. If empty, outputs are written next to the inputs.
+		std::filesystem::path outputDir;
+
+		std::string outputExtension;
+
+		// 0 means std::thread::hardware_concurrency()
+		std::size_t numJobs = 0;
+	};
+
+	inline std::string ToLower(std::string str)
+	{
+		std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return str;
+	}
+
+	// Lists the files with the extension (case-insensitive) in the directory recursively, sorted by path
+	inline std::vector<std::filesystem::path> ListFiles(const std::filesystem::path& dir, const std::string& extension)
+	{
+		std::vector<std::filesystem::path> paths;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(dir, std::filesystem::directory_options::skip_permission_denied))
+		{
+			if (entry.is_regular_file() && ToLower(entry.path().extension().string()) == extension)
+			{
+				paths.push_back(entry.path());
+			}
+		}
+		std::sort(paths.begin(), paths.end());
+		return paths;
+	}
+
+	// Reads the input file paths from a manifest file (one path per line, relative to the manifest file)
+	// Note: Empty lines and lines starting with '#' are ignored
+	inline std::optional<std::vector<std::filesystem::path>> ReadManifest(const std::filesystem::path& manifestPath)
+	{
+		std::ifstream ifs(manifestPath);
+		if (!ifs)
+		{
+			return std::nullopt;
+		}
+
+		std::vector<std::filesystem::path> paths;
+		std::string line;
+		while (std::getline(ifs, line))
+		{
+			if (!line.empty() && line.back() == '\r')
+			{
+				line.pop_back();
+			}
+			if (line.empty() || line.front() == '#')
+			{
+				continue;
+			}
+			paths.push_back(manifestPath.parent_path() / std::filesystem::u8path(line));
+		}
+		return paths;
+	}
+
+	inline std::filesystem::path OutputPathOf(const Options& options, const std::filesystem::path& inputPath)
+	{
+		std::filesystem::path outputPath = inputPath;
+		if (!options.outputDir.empty())
+		{
+			// Note: Inputs outside the base directory (e.g., absolute paths in a manifest) are placed directly under the output directory
+			const std::filesystem::path relativePath = inputPath.lexically_normal().lexically_relative(options.baseDir.lexically_normal());
+			const bool isOutside = relativePath.empty() || *relativePath.begin() == "..";
+			outputPath = options.outputDir / (isOutside ? inputPath.filename() : relativePath);
+		}
+		return outputPath.replace_extension(options.outputExtension);
+	}
+
+	// Creates the options for a directory (or a manifest file if isManifest is true)
+	inline std::optional<Options> MakeOptions(const std::filesystem::path& inputPath, bool isManifest, const std::string& inputExtension, const std::string& outputExtension)
+	{
+		Options options;
+		options.outputExtension = outputExtension;
+		if (isManifest)
+		{
+			std::optional<std::vector<std::filesystem::path>> inputPaths = ReadManifest(inputPath);
+			if (!inputPaths.has_value())
+			{
+				return std::nullopt;
+			}
+			options.baseDir = inputPath.parent_path();
+			options.inputPaths = std::move(*inputPaths);
+		}
+		else
+		{
+			std::error_code ec;
+			if (!std::filesystem::is_directory(inputPath, ec))
+			{
+				return std::nullopt;
+			}
+			options.baseDir = inputPath;
+			options.inputPaths = ListFiles(inputPath, inputExtension);
+		}
+		return options;
+	}
+
+	struct FileResult
+	{
+		kson::ErrorType error = kson::ErrorType::None;
+		WarningCounts warningCounts;
+
+		// Set if the output path is the same as the one of another input file (the file is not converted)
+		std::optional<std::filesystem::path> conflictingInputPath;
+	};
+
+	// Marks the input files whose output paths collide, so that they are not written by multiple workers at the same time
+	// Note: All the files sharing an output path are skipped, since which one should win is ambiguous
+	inline void DetectOutputPathConflicts(const Options& options, std::vector<FileResult>& results)
+	{
+		std::map<std::string, std::size_t> firstIdxByOutputPath;
+		for (std::size_t i = 0; i < options.inputPaths.size(); ++i)
+		{
+			std::string key = std::filesystem::absolute(OutputPathOf(options, options.inputPaths[i])).lexically_normal().generic_string();
+#ifdef _WIN32
+			// Paths are case-insensitive on Windows
+			key = ToLower(std::move(key));
+#endif
+			const auto [itr, inserted] = firstIdxByOutputPath.emplace(std::move(key), i);
+			if (!inserted)
+			{
+				const std::size_t firstIdx = itr->second;
+				results[i].conflictingInputPath = options.inputPaths[firstIdx];
+				if (!results[firstIdx].conflictingInputPath.has_value())
+				{
+					results[firstIdx].conflictingInputPath = options.inputPaths[i];
+				}
+			}
+		}
+	}
+
+	inline FileResult ConvertFile(const Options& options, const ConvertFunc& convertFunc, const std::filesystem::path& inputPath)
+	{
+		FileResult result;
+
+		std::ifstream ifs(inputPath, std::ios_base::binary);
+		if (!ifs)
+		{
+			result.error = kson::ErrorType::CouldNotOpenInputFileStream;
+			return result;
+		}
+
+		std::string output;
+		result.error = convertFunc(ifs, &output, &result.warningCounts);
+		if (result.error != kson::ErrorType::None)
+		{
+			return result;
+		}
+
+		const std::filesystem::path outputPath = OutputPathOf(options, inputPath);
+		std::error_code ec;
+		if (outputPath.has_parent_path())
+		{
+			std::filesystem::create_directories(outputPath.parent_path(), ec);
+		}
+
+		std::ofstream ofs(outputPath, std::ios_base::binary);
+		if (!ofs)
+		{
+			result.error = kson::ErrorType::CouldNotOpenOutputFileStream;
+			return result;
+		}
+		ofs.write(output.data(), static_cast<std::streamsize>(output.size()));
+		if (!ofs.good())
+		{
+			result.error = kson::ErrorType::GeneralIOError;
+		}
+		return result;
+	}
+
+	// Converts all input files in parallel and prints the summary to stderr
+	// Returns true if all files were converted
+	inline bool Run(const Options& options, const ConvertFunc& convertFunc)
+	{
+		const auto startTime = std::chrono::steady_clock::now();
+
+		std::vector<FileResult> results(options.inputPaths.size());
+		DetectOutputPathConflicts(options, results);
+
+		std::atomic<std::size_t> cursor{ 0 };
+		const auto worker = [&]
+		{
+			std::size_t i;
+			while ((i = cursor.fetch_add(1, std::memory_order_relaxed)) < results.size())
+			{
+				if (results[i].conflictingInputPath.has_value())
+				{
+					continue;
+				}
+
+				// Note: Each index is written by exactly one worker, so no lock is needed
+				try
+				{
+					results[i] = ConvertFile(options, convertFunc, options.inputPaths[i]);
+				}
+				catch (...)
+				{
+					// Exceptions must not escape from worker threads
+					results[i] = { .error = kson::ErrorType::UnknownError };
+				}
+			}
+		};
+
+		std::size_t numJobs = options.numJobs;
+		if (numJobs == 0)
+		{
+			numJobs = std::max(std::size_t{ 1 }, static_cast<std::size_t>(std::thread::hardware_concurrency()));
+		}
+		numJobs = std::max(std::size_t{ 1 }, std::min(numJobs, results.size()));
+
+		std::vector<std::thread> threads;
+		threads.reserve(numJobs - 1);
+		for (std::size_t i = 0; i + 1 < numJobs; ++i)
+		{
+			threads.emplace_back(worker);
+		}
+		worker(); // The calling thread also works
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		const double elapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+		// Aggregate the results in the input order, so the summary does not depend on the scheduling
+		std::size_t numFailures = 0;
+		WarningCounts warningCounts;
+		std::map<std::string, std::size_t> numFilesWithWarning;
+		for (std::size_t i = 0; i < results.size(); ++i)
+		{
+			const FileResult& result = results[i];
+			if (result.conflictingInputPath.has_value())
+			{
+				std::cerr << "Error: " << options.inputPaths[i].string() << ": Output path conflicts with " << result.conflictingInputPath->string() << " (" << OutputPathOf(options, options.inputPaths[i]).string() << ")\n";
+				++numFailures;
+			}
+			else if (result.error != kson::ErrorType::None)
+			{
+				std::cerr << "Error: " << options.inputPaths[i].string() << ": " << kson::GetErrorString(result.error) << '\n';
+				++numFailures;
+			}
+			for (const auto& [type, count] : result.warningCounts)
+			{
+				warningCounts[type] += count;
+				++numFilesWithWarning[type];
+			}
+		}
+
+		char rateStr[64];
+		std::snprintf(rateStr, sizeof(rateStr), "%.2f s, %.1f files/s", elapsedSec, elapsedSec > 0.0 ? results.size() / elapsedSec : 0.0);
+		std::cerr << "Converted " << results.size() - numFailures << " of " << results.size() << " files ("
+			<< rateStr << ", jobs: " << numJobs << "), " << numFailures << " failed\n";
+		if (!warningCounts.empty())
+		{
+			std::cerr << "Warnings:\n";
+			for (const auto& [type, count] : warningCounts)
+			{
+				std::cerr << "  " << type << ": " << count << " (in " << numFilesWithWarning[type] << " files)\n";
+			}
+		}
+
+		return numFailures == 0;
+	}
+}
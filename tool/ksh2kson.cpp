@@ -1,9 +1,12 @@
 #include <iostream>
+#include <cstdlib>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <optional>
 #include "kson/kson.hpp"
 #include "ksh2kson_version.h"
+#include "batch_convert.hpp"
 
 enum ExitCode : int
 {
@@ -19,7 +22,13 @@ void PrintHelp()
 		"  Usage:\n"
 		"    ksh2kson <input.ksh>         Convert file and output to stdout\n"
 		"    ksh2kson < input.ksh         Read from stdin and output to stdout\n"
-		"    cat input.ksh | ksh2kson     Read from pipe and output to stdout\n";
+		"    cat input.ksh | ksh2kson     Read from pipe and output to stdout\n"
+		"    ksh2kson <dir>               Convert all .ksh files in the directory recursively\n"
+		"    ksh2kson --manifest <file>   Convert the .ksh files listed in the file (one path per line)\n"
+		"  Options:\n"
+		"    --cache-dir <dir>            Reuse the output of a previous conversion of the same input\n"
+		"    --jobs <N>                   Number of files converted in parallel (default: number of CPU cores)\n"
+		"    --output-dir <dir>           Write .kson files into the directory tree instead of next to the inputs\n";
 }
 
 void PrintError(kson::ErrorType errorType)
@@ -27,54 +36,199 @@ void PrintError(kson::ErrorType errorType)
 	std::cerr << "Error: " << kson::GetErrorString(errorType) << '\n';
 }
 
-int DoConvert(std::istream& input)
+std::string ReadAll(std::istream& input)
 {
-	kson::ChartData chartData = kson::LoadKshChartData(input);
-	if (chartData.error != kson::ErrorType::None)
+	return std::string(std::istreambuf_iterator<char>(input), {});
+}
+
+int WriteOutput(std::string_view output)
+{
+	std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+	if (!std::cout.good())
 	{
-		PrintError(chartData.error);
+		PrintError(kson::ErrorType::GeneralIOError);
 		return kExitError;
 	}
+	return kExitSuccess;
+}
+
+const char* WarningTypeName(kson::KshLoadingWarningType type)
+{
+	switch (type)
+	{
+	case kson::KshLoadingWarningType::TitleNotAtBeginning: return "TitleNotAtBeginning";
+	case kson::KshLoadingWarningType::MissingTimeSigAtZero: return "MissingTimeSigAtZero";
+	case kson::KshLoadingWarningType::AudioEffectMissingType: return "AudioEffectMissingType";
+	case kson::KshLoadingWarningType::AudioEffectInvalidType: return "AudioEffectInvalidType";
+	case kson::KshLoadingWarningType::UncommittedBTNote: return "UncommittedBTNote";
+	case kson::KshLoadingWarningType::UncommittedFXNote: return "UncommittedFXNote";
+	case kson::KshLoadingWarningType::UndefinedAudioEffect: return "UndefinedAudioEffect";
+	case kson::KshLoadingWarningType::Sub32ndSlamLasers: return "Sub32ndSlamLasers";
+	case kson::KshLoadingWarningType::MeasureSplitNotDivisible: return "MeasureSplitNotDivisible";
+	case kson::KshLoadingWarningType::AudioEffectDuplicateName: return "AudioEffectDuplicateName";
+	case kson::KshLoadingWarningType::UnexpectedError: return "UnexpectedError";
+	}
+	return "Unknown";
+}
+
+constexpr const char* kCacheStoreFailedWarning = "CacheStoreFailed";
+
+// Note: Warnings are not reported if the output is taken from the cache
+kson::ErrorType Convert(std::istream& input, const std::optional<kson::ConversionCache>& cache, std::string* pOutput, batch_convert::WarningCounts* pWarningCounts)
+{
+	const std::string inputContent = ReadAll(input);
+	const std::span<const char> inputSpan(inputContent.data(), inputContent.size());
+
+	std::string cacheKey;
+	if (cache.has_value())
+	{
+		cacheKey = cache->keyOf(inputSpan, kson::ConversionCacheFormat::kKson);
+		if (std::optional<std::string> cached = cache->load(cacheKey); cached.has_value())
+		{
+			*pOutput = std::move(*cached);
+			return kson::ErrorType::None;
+		}
+	}
+
+	kson::KshLoadingDiag diag;
+	kson::ChartData chartData = kson::LoadKshChartData(inputSpan, &diag);
+	for (const auto& warning : diag.warnings)
+	{
+		++(*pWarningCounts)[WarningTypeName(warning.type)];
+	}
+	if (chartData.error != kson::ErrorType::None)
+	{
+		return chartData.error;
+	}
 
 	// Set editor info
 	chartData.editor.appName = kKsh2KsonAppName;
 	chartData.editor.appVersion = kKsh2KsonVersionFull;
 
-	const kson::ErrorType error = kson::SaveKsonChartData(std::cout, chartData);
+	std::ostringstream oss;
+	const kson::ErrorType error = kson::SaveKsonChartData(oss, chartData);
+	if (error != kson::ErrorType::None)
+	{
+		return error;
+	}
+
+	*pOutput = std::move(oss).str();
+	if (cache.has_value())
+	{
+		// Note: The conversion itself succeeded, so a failure to store the entry is only reported as a warning
+		if (cache->store(cacheKey, *pOutput) != kson::ErrorType::None)
+		{
+			++(*pWarningCounts)[kCacheStoreFailedWarning];
+		}
+	}
+
+	return kson::ErrorType::None;
+}
+
+int DoConvert(std::istream& input, const std::optional<kson::ConversionCache>& cache)
+{
+	std::string output;
+	batch_convert::WarningCounts warningCounts;
+	const kson::ErrorType error = Convert(input, cache, &output, &warningCounts);
 	if (error != kson::ErrorType::None)
 	{
 		PrintError(error);
 		return kExitError;
 	}
 
-	return kExitSuccess;
+	if (warningCounts.contains(kCacheStoreFailedWarning))
+	{
+		std::cerr << "Warning: Could not store the cache entry\n";
+	}
+
+	return WriteOutput(output);
+}
+
+int DoConvertBatch(const batch_convert::Options& options, const std::optional<kson::ConversionCache>& cache)
+{
+	const bool success = batch_convert::Run(options, [&cache](std::istream& input, std::string* pOutput, batch_convert::WarningCounts* pWarningCounts)
+	{
+		return Convert(input, cache, pOutput, pWarningCounts);
+	});
+	return success ? kExitSuccess : kExitError;
 }
 
 int main(int argc, char *argv[])
 {
 	try
 	{
-		if (argc == 1)
+		std::optional<kson::ConversionCache> cache;
+		std::optional<std::string> inputPath;
+		std::optional<std::string> manifestPath;
+		std::optional<std::string> outputDir;
+		std::size_t numJobs = 0;
+		for (int i = 1; i < argc; ++i)
 		{
-			// Read from stdin
-			return DoConvert(std::cin);
+			const std::string_view arg = argv[i];
+			const bool hasValue = i + 1 < argc;
+			if (arg == "--cache-dir" && hasValue)
+			{
+				// Note: The tool version is part of the key because the output contains it (editor.app_version)
+				cache.emplace(argv[++i], std::string(kKsh2KsonAppName) + " " + kKsh2KsonVersionFull);
+			}
+			else if (arg == "--jobs" && hasValue)
+			{
+				numJobs = static_cast<std::size_t>(std::max(0, std::atoi(argv[++i])));
+			}
+			else if (arg == "--manifest" && hasValue)
+			{
+				manifestPath = argv[++i];
+			}
+			else if (arg == "--output-dir" && hasValue)
+			{
+				outputDir = argv[++i];
+			}
+			else if (!inputPath.has_value() && !arg.starts_with("--"))
+			{
+				inputPath = arg;
+			}
+			else
+			{
+				PrintHelp();
+				return kExitNoArgument;
+			}
 		}
-		else if (argc == 2)
+
+		std::error_code ec;
+		if (manifestPath.has_value() || (inputPath.has_value() && std::filesystem::is_directory(*inputPath, ec)))
 		{
-			// Read from file
-			std::ifstream ifs{ argv[1] };
-			if (!ifs)
+			if (manifestPath.has_value() && inputPath.has_value())
 			{
-				std::cerr << "Error: Cannot open file: " << argv[1] << '\n';
+				PrintHelp();
+				return kExitNoArgument;
+			}
+
+			const bool isManifest = manifestPath.has_value();
+			std::optional<batch_convert::Options> options = batch_convert::MakeOptions(isManifest ? *manifestPath : *inputPath, isManifest, ".ksh", ".kson");
+			if (!options.has_value())
+			{
+				std::cerr << "Error: Cannot open file: " << (isManifest ? *manifestPath : *inputPath) << '\n';
 				return kExitError;
 			}
-			return DoConvert(ifs);
+			options->outputDir = outputDir.value_or("");
+			options->numJobs = numJobs;
+			return DoConvertBatch(*options, cache);
+		}
+
+		if (!inputPath.has_value())
+		{
+			// Read from stdin
+			return DoConvert(std::cin, cache);
 		}
-		else
+
+		// Read from file
+		std::ifstream ifs{ *inputPath, std::ios_base::binary };
+		if (!ifs)
 		{
-			PrintHelp();
-			return kExitNoArgument;
+			std::cerr << "Error: Cannot open file: " << *inputPath << '\n';
+			return kExitError;
 		}
+		return DoConvert(ifs, cache);
 	}
 	catch (const std::exception& e)
 	{
@@ -1,8 +1,11 @@
 #include <iostream>
+#include <cstdlib>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <optional>
 #include "kson/kson.hpp"
+#include "batch_convert.hpp"
 
 enum ExitCode : int
 {
@@ -18,7 +21,12 @@ void PrintHelp()
 		"  Usage:\n"
 		"    kson2ksh <input.kson>         Convert file and output to stdout\n"
 		"    kson2ksh < input.kson         Read from stdin and output to stdout\n"
-		"    cat input.kson | kson2ksh     Read from pipe and output to stdout\n";
+		"    cat input.kson | kson2ksh     Read from pipe and output to stdout\n"
+		"    kson2ksh <dir>                Convert all .kson files in the directory recursively\n"
+		"    kson2ksh --manifest <file>    Convert the .kson files listed in the file (one path per line)\n"
+		"  Options:\n"
+		"    --jobs <N>                    Number of files converted in parallel (default: number of CPU cores)\n"
+		"    --output-dir <dir>            Write .ksh files into the directory tree instead of next to the inputs\n";
 }
 
 void PrintError(kson::ErrorType errorType)
@@ -26,22 +34,89 @@ void PrintError(kson::ErrorType errorType)
 	std::cerr << "Error: " << kson::GetErrorString(errorType) << '\n';
 }
 
-int DoConvert(std::istream& input)
+const char* WarningTypeName(kson::KsonLoadingWarningType type)
 {
-	const kson::ChartData chartData = kson::LoadKsonChartData(input);
+	switch (type)
+	{
+	case kson::KsonLoadingWarningType::InvalidGraphValueFormat: return "InvalidGraphValueFormat";
+	case kson::KsonLoadingWarningType::InvalidByPulseEntryFormat: return "InvalidByPulseEntryFormat";
+	case kson::KsonLoadingWarningType::InvalidGraphEntryFormat: return "InvalidGraphEntryFormat";
+	case kson::KsonLoadingWarningType::InvalidByMeasureIdxEntryFormat: return "InvalidByMeasureIdxEntryFormat";
+	case kson::KsonLoadingWarningType::InvalidNoteEntryFormat: return "InvalidNoteEntryFormat";
+	case kson::KsonLoadingWarningType::InvalidLaserSectionFormat: return "InvalidLaserSectionFormat";
+	case kson::KsonLoadingWarningType::MissingFormatVersion: return "MissingFormatVersion";
+	case kson::KsonLoadingWarningType::InvalidFormatVersion: return "InvalidFormatVersion";
+	case kson::KsonLoadingWarningType::NewerFormatVersion: return "NewerFormatVersion";
+	case kson::KsonLoadingWarningType::JsonParseError: return "JsonParseError";
+	case kson::KsonLoadingWarningType::JsonTypeError: return "JsonTypeError";
+	case kson::KsonLoadingWarningType::UnexpectedError: return "UnexpectedError";
+	}
+	return "Unknown";
+}
+
+const char* WarningTypeName(kson::KshSavingWarningType type)
+{
+	switch (type)
+	{
+	case kson::KshSavingWarningType::BpmClamped: return "BpmClamped";
+	case kson::KshSavingWarningType::ZoomValueClamped: return "ZoomValueClamped";
+	case kson::KshSavingWarningType::CenterSplitClamped: return "CenterSplitClamped";
+	case kson::KshSavingWarningType::ManualTiltClamped: return "ManualTiltClamped";
+	case kson::KshSavingWarningType::RotationDegClamped: return "RotationDegClamped";
+	case kson::KshSavingWarningType::ZoomFractionLost: return "ZoomFractionLost";
+	case kson::KshSavingWarningType::LaserPrecisionLost: return "LaserPrecisionLost";
+	case kson::KshSavingWarningType::FXLongEventParamsLost: return "FXLongEventParamsLost";
+	}
+	return "Unknown";
+}
+
+kson::ErrorType Convert(std::istream& input, std::string* pOutput, batch_convert::WarningCounts* pWarningCounts)
+{
+	kson::KsonLoadingDiag loadingDiag;
+	const kson::ChartData chartData = kson::LoadKsonChartData(input, &loadingDiag);
+	for (const auto& warning : loadingDiag.warnings)
+	{
+		++(*pWarningCounts)[WarningTypeName(warning.type)];
+	}
 	if (chartData.error != kson::ErrorType::None)
 	{
-		PrintError(chartData.error);
-		return kExitError;
+		return chartData.error;
+	}
+
+	std::ostringstream oss;
+	kson::KshSavingDiag savingDiag;
+	const kson::ErrorType error = kson::SaveKshChartData(oss, chartData, &savingDiag);
+	for (const auto& warning : savingDiag.warnings)
+	{
+		++(*pWarningCounts)[WarningTypeName(warning.type)];
+	}
+	if (error != kson::ErrorType::None)
+	{
+		return error;
 	}
 
-	const kson::ErrorType error = kson::SaveKshChartData(std::cout, chartData);
+	*pOutput = std::move(oss).str();
+	return kson::ErrorType::None;
+}
+
+int DoConvert(std::istream& input)
+{
+	std::string output;
+	batch_convert::WarningCounts warningCounts;
+	const kson::ErrorType error = Convert(input, &output, &warningCounts);
 	if (error != kson::ErrorType::None)
 	{
 		PrintError(error);
 		return kExitError;
 	}
 
+	std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+	if (!std::cout.good())
+	{
+		PrintError(kson::ErrorType::GeneralIOError);
+		return kExitError;
+	}
+
 	return kExitSuccess;
 }
 
@@ -49,27 +124,72 @@ int main(int argc, char *argv[])
 {
 	try
 	{
-		if (argc == 1)
+		std::optional<std::string> inputPath;
+		std::optional<std::string> manifestPath;
+		std::optional<std::string> outputDir;
+		std::size_t numJobs = 0;
+		for (int i = 1; i < argc; ++i)
 		{
-			// Read from stdin
-			return DoConvert(std::cin);
+			const std::string_view arg = argv[i];
+			const bool hasValue = i + 1 < argc;
+			if (arg == "--jobs" && hasValue)
+			{
+				numJobs = static_cast<std::size_t>(std::max(0, std::atoi(argv[++i])));
+			}
+			else if (arg == "--manifest" && hasValue)
+			{
+				manifestPath = argv[++i];
+			}
+			else if (arg == "--output-dir" && hasValue)
+			{
+				outputDir = argv[++i];
+			}
+			else if (!inputPath.has_value() && !arg.starts_with("--"))
+			{
+				inputPath = arg;
+			}
+			else
+			{
+				PrintHelp();
+				return kExitNoArgument;
+			}
 		}
-		else if (argc == 2)
+
+		std::error_code ec;
+		if (manifestPath.has_value() || (inputPath.has_value() && std::filesystem::is_directory(*inputPath, ec)))
 		{
-			// Read from file
-			std::ifstream ifs{ argv[1] };
-			if (!ifs)
+			if (manifestPath.has_value() && inputPath.has_value())
+			{
+				PrintHelp();
+				return kExitNoArgument;
+			}
+
+			const bool isManifest = manifestPath.has_value();
+			std::optional<batch_convert::Options> options = batch_convert::MakeOptions(isManifest ? *manifestPath : *inputPath, isManifest, ".kson", ".ksh");
+			if (!options.has_value())
 			{
-				std::cerr << "Error: Cannot open file: " << argv[1] << '\n';
+				std::cerr << "Error: Cannot open file: " << (isManifest ? *manifestPath : *inputPath) << '\n';
 				return kExitError;
 			}
-			return DoConvert(ifs);
+			options->outputDir = outputDir.value_or("");
+			options->numJobs = numJobs;
+			return batch_convert::Run(*options, Convert) ? kExitSuccess : kExitError;
 		}
-		else
+
+		if (!inputPath.has_value())
+		{
+			// Read from stdin
+			return DoConvert(std::cin);
+		}
+
+		// Read from file
+		std::ifstream ifs{ *inputPath, std::ios_base::binary };
+		if (!ifs)
 		{
-			PrintHelp();
-			return kExitNoArgument;
+			std::cerr << "Error: Cannot open file: " << *inputPath << '\n';
+			return kExitError;
 		}
+		return DoConvert(ifs);
 	}
 	catch (const std::exception& e)
 	{